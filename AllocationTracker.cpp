@@ -0,0 +1,233 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include "AllocationTracker.h"
+
+#ifdef TRACK_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Counts for the calling thread. Plain integers with no constructor, so they are safe to use before main():
+static thread_local unsigned long long threadAllocations = 0;
+static thread_local unsigned long long threadDeallocations = 0;
+static thread_local unsigned long long threadBytes = 0;
+
+// Counts for every thread together:
+static atomic<unsigned long long> processAllocations(0);
+static atomic<unsigned long long> processDeallocations(0);
+static atomic<unsigned long long> processBytes(0);
+
+
+/**
+ * Counts an allocation and makes it with malloc.
+ * @param size The number of bytes requested.
+ * @return The allocated memory, or nullptr if malloc failed.
+ */
+static void* countedAllocate(size_t size) {
+    threadAllocations++;
+    threadBytes += size;
+    processAllocations.fetch_add(1, memory_order_relaxed);
+    processBytes.fetch_add(size, memory_order_relaxed);
+    return malloc(size == 0 ? 1 : size); // operator new must return a unique pointer even for 0 bytes.
+}
+
+
+/**
+ * Counts a deallocation and frees the memory.
+ * @param pointer The memory to free. Deleting nullptr is allowed and not counted.
+ */
+static void countedFree(void* pointer) {
+    if (pointer != nullptr) {
+        threadDeallocations++;
+        processDeallocations.fetch_add(1, memory_order_relaxed);
+        free(pointer);
+    }
+}
+
+
+// Replacements for the global allocation functions. The aligned (C++17) versions are left to the standard library:
+void* operator new(size_t size) {
+    void* pointer = countedAllocate(size);
+    if (pointer == nullptr) {
+        throw bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void* operator new[](size_t size, const nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    countedFree(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    countedFree(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    countedFree(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+    countedFree(pointer);
+}
+
+void operator delete(void* pointer, const nothrow_t&) noexcept {
+    countedFree(pointer);
+}
+
+void operator delete[](void* pointer, const nothrow_t&) noexcept {
+    countedFree(pointer);
+}
+#endif
+
+
+/**
+ * Constructor. Every count starts at 0.
+ */
+AllocationCounts::AllocationCounts() : allocations(0), deallocations(0), bytes(0) {}
+
+
+/**
+ * Gets the allocations made between two readings of the counts.
+ * @param other The earlier reading.
+ * @return The difference of every count.
+ */
+AllocationCounts AllocationCounts::operator-(const AllocationCounts& other) const {
+    AllocationCounts difference;
+    difference.allocations = allocations - other.allocations;
+    difference.deallocations = deallocations - other.deallocations;
+    difference.bytes = bytes - other.bytes;
+    return difference;
+}
+
+
+/**
+ * Checks whether this build counts allocations.
+ * @return true if built with TRACK_ALLOCATIONS, false otherwise.
+ */
+bool allocationTrackingEnabled() {
+#ifdef TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+/**
+ * Reads the allocation counts of the calling thread. Take one reading before and one after the code being measured.
+ * @return Every allocation the calling thread has made so far, or all 0s if tracking is not compiled in.
+ */
+AllocationCounts threadAllocationCounts() {
+    AllocationCounts counts;
+#ifdef TRACK_ALLOCATIONS
+    counts.allocations = threadAllocations;
+    counts.deallocations = threadDeallocations;
+    counts.bytes = threadBytes;
+#endif
+    return counts;
+}
+
+
+/**
+ * Reads the allocation counts of the whole process, for code that hands work to other threads (e.g. ingest).
+ * @return Every allocation made by any thread so far, or all 0s if tracking is not compiled in.
+ */
+AllocationCounts processAllocationCounts() {
+    AllocationCounts counts;
+#ifdef TRACK_ALLOCATIONS
+    counts.allocations = processAllocations.load(memory_order_relaxed);
+    counts.deallocations = processDeallocations.load(memory_order_relaxed);
+    counts.bytes = processBytes.load(memory_order_relaxed);
+#endif
+    return counts;
+}
+
+
+// AllocationTotals:
+// =================
+
+/**
+ * Constructor.
+ */
+AllocationTotals::AllocationTotals() : operations(0), allocatingOperations(0), maxAllocations(0) {}
+
+
+/**
+ * Adds the allocations made by one operation.
+ * @param counts The difference between the counts read before and after the operation.
+ */
+void AllocationTotals::add(const AllocationCounts& counts) {
+    operations++;
+    if (counts.allocations > 0) {
+        allocatingOperations++;
+    }
+    if (counts.allocations > maxAllocations) {
+        maxAllocations = counts.allocations;
+    }
+    total.allocations += counts.allocations;
+    total.deallocations += counts.deallocations;
+    total.bytes += counts.bytes;
+}
+
+
+/**
+ * Adds the totals of another set of operations, e.g. those run on another thread.
+ * @param other The totals to add.
+ */
+void AllocationTotals::merge(const AllocationTotals& other) {
+    operations += other.operations;
+    allocatingOperations += other.allocatingOperations;
+    if (other.maxAllocations > maxAllocations) {
+        maxAllocations = other.maxAllocations;
+    }
+    total.allocations += other.total.allocations;
+    total.deallocations += other.total.deallocations;
+    total.bytes += other.total.bytes;
+}
+
+
+unsigned long long AllocationTotals::getOperations() const {
+    return operations;
+}
+
+
+unsigned long long AllocationTotals::getAllocatingOperations() const {
+    return allocatingOperations;
+}
+
+
+unsigned long long AllocationTotals::getMaxAllocations() const {
+    return maxAllocations;
+}
+
+
+/**
+ * Gets the mean number of allocations per operation.
+ * @return The mean, or 0 if no operations were added.
+ */
+double AllocationTotals::allocationsPerOperation() const {
+    return operations > 0 ? static_cast<double>(total.allocations) / operations : 0;
+}
+
+
+/**
+ * Gets the mean number of bytes allocated per operation.
+ * @return The mean, or 0 if no operations were added.
+ */
+double AllocationTotals::bytesPerOperation() const {
+    return operations > 0 ? static_cast<double>(total.bytes) / operations : 0;
+}
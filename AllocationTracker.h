@@ -0,0 +1,57 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_ALLOCATIONTRACKER_H
+#define COP3530_PROJECT_3_ALLOCATIONTRACKER_H
+
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * Heap allocations made through operator new and delete.
+ *
+ * Counting is only compiled in when TRACK_ALLOCATIONS is defined (make ALLOCS=1). The global operator new and delete
+ * are then replaced by versions that count every call, per thread and for the whole process, before passing on to
+ * malloc and free. In normal builds nothing is replaced and every count stays 0.
+ */
+struct AllocationCounts {
+    unsigned long long allocations; // Calls to operator new.
+    unsigned long long deallocations; // Calls to operator delete with a non-null pointer.
+    unsigned long long bytes; // Bytes requested from operator new.
+
+    AllocationCounts(); // ctr
+
+    AllocationCounts operator-(const AllocationCounts& other) const;
+};
+
+// Allocation tracking functions. See the .cpp implementation file:
+bool allocationTrackingEnabled();
+AllocationCounts threadAllocationCounts();
+AllocationCounts processAllocationCounts();
+
+/**
+ * Totals of the allocations made by one kind of operation.
+ */
+class AllocationTotals {
+private:
+    unsigned long long operations; // Number of operations added.
+    unsigned long long allocatingOperations; // Operations that allocated at least once.
+    unsigned long long maxAllocations; // Most allocations made by a single operation.
+    AllocationCounts total;
+
+public:
+    AllocationTotals(); // ctr
+
+    void add(const AllocationCounts& counts);
+    void merge(const AllocationTotals& other);
+    unsigned long long getOperations() const;
+    unsigned long long getAllocatingOperations() const;
+    unsigned long long getMaxAllocations() const;
+    double allocationsPerOperation() const;
+    double bytesPerOperation() const;
+};
+
+
+#endif //COP3530_PROJECT_3_ALLOCATIONTRACKER_H
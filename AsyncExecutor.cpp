@@ -0,0 +1,335 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "AsyncExecutor.h"
+
+static const int MAX_EVENTS = 64;
+
+/**
+ * Constructor.
+ */
+AsyncExecutor::AsyncExecutor() : waitingCount(0), epollFd(-1), stopRequested(false) {
+#ifdef __linux__
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+#endif
+}
+
+
+/**
+ * Destructor. Destroys any spawned task that has not finished, along with every coroutine it was awaiting.
+ */
+AsyncExecutor::~AsyncExecutor() {
+    for (unsigned int i = 0; i < spawned.size(); i++) {
+        delete spawned.at(i);
+    }
+#ifdef __linux__
+    if (epollFd != -1) {
+        close(epollFd);
+    }
+#endif
+}
+
+
+/**
+ * Queues a suspended coroutine to be resumed.
+ * @param handle The coroutine.
+ */
+void AsyncExecutor::schedule(coroutine_handle<> handle) {
+    ready.push_back(handle);
+}
+
+
+/**
+ * Lets every other ready task run before the awaiting one continues: `co_await executor.yield();`.
+ */
+AsyncExecutor::YieldAwaiter AsyncExecutor::yield() {
+    return YieldAwaiter{this};
+}
+
+
+/**
+ * Waits until a file descriptor has something to read (or has been hung up on): `co_await executor.readable(fd);`.
+ * Only one coroutine may wait to read each descriptor at a time.
+ */
+AsyncExecutor::FdAwaiter AsyncExecutor::readable(int fd) {
+    return FdAwaiter{this, fd, false};
+}
+
+
+/**
+ * Waits until a file descriptor can take more output: `co_await executor.writable(fd);`.
+ * Only one coroutine may wait to write each descriptor at a time.
+ */
+AsyncExecutor::FdAwaiter AsyncExecutor::writable(int fd) {
+    return FdAwaiter{this, fd, true};
+}
+
+
+/**
+ * Starts a task that nothing awaits. The executor owns it from now on, and destroys it once it finishes.
+ * @param task The task.
+ */
+void AsyncExecutor::spawn(Task<void> task) {
+    Task<void>* owned = new Task<void>(move(task));
+    spawned.push_back(owned);
+    schedule(owned->getHandle());
+}
+
+
+/**
+ * Runs tasks until every spawned task has finished and nothing is left waiting.
+ * An exception a spawned task ended with is rethrown from here.
+ */
+void AsyncExecutor::run() {
+    stopRequested = false;
+    while (!ready.empty() || waitingCount > 0 || !spawned.empty()) {
+        runReady();
+        collectFinished();
+        if (stopRequested || (ready.empty() && waitingCount == 0)) {
+            return; // Stopped, or whatever is left can never be resumed.
+        }
+        pollDescriptors(ready.empty() ? -1 : 0);
+    }
+}
+
+
+/**
+ * Makes run() return at the end of the current round, whether or not the tasks have finished. Called from a task.
+ * Unfinished tasks stay suspended, and are destroyed along with the executor.
+ */
+void AsyncExecutor::stop() {
+    stopRequested = true;
+}
+
+
+/**
+ * Runs a blocking function on a helper thread, suspending the awaiting coroutine (but not the executor) until it
+ * returns: `co_await executor.offload([&]() { container->build(songs); });`. The function must not throw, and must not
+ * touch anything the executor's other tasks use until it has returned.
+ * @param work The function.
+ */
+Task<void> AsyncExecutor::offload(function<void()> work) {
+#ifdef __linux__
+    // The helper thread signals an eventfd when it is done, which the executor watches like any other descriptor:
+    int doneFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (doneFd != -1) {
+        // Joins the helper even if this task is destroyed before it is woken (as when the executor is destroyed first),
+        // so the work never outlives what it uses:
+        struct Helper {
+            thread worker;
+            int doneFd;
+
+            ~Helper() {
+                worker.join();
+                close(doneFd);
+            }
+        };
+        Helper helper{thread([&work, doneFd]() {
+            work();
+            uint64_t one = 1;
+            ssize_t written = write(doneFd, &one, sizeof(one));
+            (void) written; // Cannot fail: the counter starts at 0 and is written once.
+        }), doneFd};
+        co_await readable(doneFd);
+        co_return;
+    }
+#endif
+    work(); // No way to be woken, so run it here instead.
+    co_return;
+}
+
+
+/**
+ * Reads exactly a given number of bytes from a non-blocking socket, waiting for them as needed.
+ * @param fd The socket.
+ * @param buffer Populated with the bytes. Must stay valid until the task finishes.
+ * @param length The number of bytes to read.
+ * @return true if every byte was read, false if the socket was closed or failed first.
+ */
+Task<bool> AsyncExecutor::receiveAll(int fd, char* buffer, size_t length) {
+#ifdef __linux__
+    size_t receivedBytes = 0;
+    while (receivedBytes < length) {
+        ssize_t received = recv(fd, buffer + receivedBytes, length - receivedBytes, 0);
+        if (received > 0) {
+            receivedBytes += static_cast<size_t>(received);
+        }
+        else if (received == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            co_await readable(fd);
+        }
+        else if (received == 0 || errno != EINTR) {
+            co_return false;
+        }
+    }
+    co_return true;
+#else
+    (void) fd;
+    (void) buffer;
+    (void) length;
+    co_return false;
+#endif
+}
+
+
+/**
+ * Writes every byte to a non-blocking socket, waiting for room as needed.
+ * @param fd The socket.
+ * @param bytes The bytes to write.
+ * @return true if every byte was written, false if the socket failed first.
+ */
+Task<bool> AsyncExecutor::sendAll(int fd, string bytes) {
+#ifdef __linux__
+    size_t sentBytes = 0;
+    while (sentBytes < bytes.size()) {
+        ssize_t sent = send(fd, bytes.data() + sentBytes, bytes.size() - sentBytes, MSG_NOSIGNAL);
+        if (sent > 0) {
+            sentBytes += static_cast<size_t>(sent);
+        }
+        else if (sent == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            co_await writable(fd);
+        }
+        else if (sent == 0 || errno != EINTR) {
+            co_return false;
+        }
+    }
+    co_return true;
+#else
+    (void) fd;
+    (void) bytes;
+    co_return false;
+#endif
+}
+
+
+/**
+ * Registers a coroutine to be resumed once a file descriptor is ready.
+ * @param fd The file descriptor.
+ * @param forWriting true to wait until it can be written, false to wait until it can be read.
+ * @param handle The coroutine.
+ */
+void AsyncExecutor::waitFor(int fd, bool forWriting, coroutine_handle<> handle) {
+#ifdef __linux__
+    FdWaiters& waiters = fdWaiters[fd];
+    if (forWriting) {
+        waiters.writer = handle;
+    }
+    else {
+        waiters.reader = handle;
+    }
+    waitingCount++;
+
+    uint32_t events = waiters.reader ? EPOLLIN : 0u;
+    if (waiters.writer) {
+        events |= EPOLLOUT;
+    }
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = events;
+    event.data.fd = fd;
+    epoll_ctl(epollFd, waiters.events == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &event);
+    waiters.events = events;
+#else
+    (void) fd;
+    (void) forWriting;
+    schedule(handle); // No way to watch the descriptor, so assume it is ready and let the blocking call wait.
+#endif
+}
+
+
+/**
+ * Checks the waiting file descriptors and queues the coroutines whose descriptor is ready. A descriptor is removed
+ * from epoll as soon as nothing waits for it, so a task may close it straight after being resumed.
+ * @param timeoutMilliseconds How long to wait for one to be ready: 0 to only check, -1 to wait as long as it takes.
+ */
+void AsyncExecutor::pollDescriptors(int timeoutMilliseconds) {
+#ifdef __linux__
+    if (waitingCount == 0) {
+        return;
+    }
+    epoll_event events[MAX_EVENTS];
+    int readyCount = epoll_wait(epollFd, events, MAX_EVENTS, timeoutMilliseconds);
+    for (int i = 0; i < readyCount; i++) {
+        int fd = events[i].data.fd;
+        FdWaiters& waiters = fdWaiters[fd];
+        // Errors and hang-ups wake both sides, so that their next read or write reports what happened:
+        bool failed = (events[i].events & (EPOLLERR | EPOLLHUP)) != 0;
+        if (waiters.reader && (failed || (events[i].events & EPOLLIN) != 0)) {
+            schedule(waiters.reader);
+            waiters.reader = nullptr;
+            waitingCount--;
+        }
+        if (waiters.writer && (failed || (events[i].events & EPOLLOUT) != 0)) {
+            schedule(waiters.writer);
+            waiters.writer = nullptr;
+            waitingCount--;
+        }
+
+        uint32_t remaining = waiters.reader ? EPOLLIN : 0u;
+        if (waiters.writer) {
+            remaining |= EPOLLOUT;
+        }
+        if (remaining == 0) {
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+            fdWaiters.erase(fd);
+        }
+        else if (remaining != waiters.events) {
+            epoll_event event;
+            memset(&event, 0, sizeof(event));
+            event.events = remaining;
+            event.data.fd = fd;
+            epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event);
+            waiters.events = remaining;
+        }
+    }
+#else
+    (void) timeoutMilliseconds;
+#endif
+}
+
+
+/**
+ * Resumes every coroutine that was ready when the round started. Coroutines that become ready during the round wait
+ * for the next one, after the file descriptors have been checked again.
+ */
+void AsyncExecutor::runReady() {
+    size_t count = ready.size();
+    for (size_t i = 0; i < count; i++) {
+        coroutine_handle<> handle = ready.front();
+        ready.pop_front();
+        handle.resume();
+    }
+}
+
+
+/**
+ * Destroys the spawned tasks that have finished, rethrowing the exception any of them ended with.
+ */
+void AsyncExecutor::collectFinished() {
+    for (unsigned int i = 0; i < spawned.size(); i++) {
+        if (spawned.at(i)->isDone()) {
+            Task<void>* finished = spawned.at(i);
+            spawned.erase(spawned.begin() + i);
+            i--;
+            try {
+                finished->takeResult();
+            }
+            catch (...) {
+                delete finished;
+                throw;
+            }
+            delete finished;
+        }
+    }
+}
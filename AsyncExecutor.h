@@ -0,0 +1,116 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_ASYNCEXECUTOR_H
+#define COP3530_PROJECT_3_ASYNCEXECUTOR_H
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "AsyncTask.h"
+
+using namespace std;
+
+/**
+ * Runs coroutine Tasks on the calling thread, switching between them whenever one has to wait.
+ *
+ * A task gives up the thread by awaiting yield() (to let the other tasks run, for example between slices of a long
+ * read), readable() or writable() (until a non-blocking socket or pipe is ready, watched with epoll), or offload()
+ * (until a blocking function finishes on a helper thread). Tasks that are ready run in the order they became ready,
+ * and waiting file descriptors are checked between every round, so one busy task cannot keep I/O waiting for long.
+ *
+ * Everything a task touches is only ever touched from the executor's thread, so tasks need no locks between them.
+ * File descriptor waits use epoll and are only supported on Linux; elsewhere they return straight away, so sockets
+ * should be left blocking there.
+ */
+class AsyncExecutor {
+private:
+    /**
+     * The coroutines waiting for one file descriptor: at most one for reading and one for writing.
+     */
+    struct FdWaiters {
+        coroutine_handle<> reader;
+        coroutine_handle<> writer;
+        uint32_t events; // The epoll events registered for the descriptor. 0 if it is not registered.
+    };
+
+    deque<coroutine_handle<>> ready; // Coroutines to resume, in order.
+    vector<Task<void>*> spawned; // Top-level tasks started by spawn() that have not finished.
+    unordered_map<int, FdWaiters> fdWaiters;
+    int waitingCount; // Coroutines waiting for a file descriptor.
+    int epollFd;
+    bool stopRequested;
+
+    void waitFor(int fd, bool forWriting, coroutine_handle<> handle);
+    void pollDescriptors(int timeoutMilliseconds);
+    void runReady();
+    void collectFinished();
+
+public:
+    /**
+     * Awaited by yield(): puts the awaiting coroutine at the back of the ready queue.
+     */
+    struct YieldAwaiter {
+        AsyncExecutor* executor;
+
+        bool await_ready() noexcept { return false; }
+        void await_suspend(coroutine_handle<> handle) { executor->schedule(handle); }
+        void await_resume() noexcept {}
+    };
+
+    /**
+     * Awaited by readable() and writable(): suspends the awaiting coroutine until the descriptor is ready.
+     */
+    struct FdAwaiter {
+        AsyncExecutor* executor;
+        int fd;
+        bool forWriting;
+
+        bool await_ready() noexcept { return false; }
+        void await_suspend(coroutine_handle<> handle) { executor->waitFor(fd, forWriting, handle); }
+        void await_resume() noexcept {}
+    };
+
+    AsyncExecutor(); // ctr
+    ~AsyncExecutor(); // dtr
+
+    void schedule(coroutine_handle<> handle);
+    YieldAwaiter yield();
+    FdAwaiter readable(int fd);
+    FdAwaiter writable(int fd);
+    Task<void> offload(function<void()> work);
+    Task<bool> receiveAll(int fd, char* buffer, size_t length);
+    Task<bool> sendAll(int fd, string bytes);
+
+    void spawn(Task<void> task);
+    void run();
+    void stop();
+
+    /**
+     * Runs a task, and any others that are ready or spawned meanwhile, until it finishes.
+     * @param task The task.
+     * @return Its result. An exception the task ended with is rethrown.
+     */
+    template <typename T>
+    T runUntilComplete(Task<T> task) {
+        schedule(task.getHandle());
+        while (!task.isDone()) {
+            runReady();
+            collectFinished();
+            if (!task.isDone()) {
+                pollDescriptors(ready.empty() ? -1 : 0);
+            }
+        }
+        return task.takeResult();
+    }
+};
+
+
+#endif //COP3530_PROJECT_3_ASYNCEXECUTOR_H
@@ -0,0 +1,130 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <algorithm>
+
+#include "AsyncOperations.h"
+#include "ContainerOperations.h"
+
+static const int SONGS_PER_SLICE = 256; // Songs extracted by extractTopAsync between yields.
+static const int ROWS_PER_SLICE = 4096; // Rows read by loadAsync between yields.
+static const int SCORES_PER_SLICE = 64; // Scores searched by rangeSearchAsync between yields. A heap search reads every song.
+
+/**
+ * Finds a song with a given score, like SongContainer::search().
+ * @return The song, or an empty Song if there is none.
+ */
+Task<Song> searchAsync(AsyncExecutor& executor, SongContainer* container, int targetScore) {
+    co_await executor.yield();
+    co_return container->search(targetScore);
+}
+
+
+/**
+ * Finds one song per score in a range, like rangeSearch() in ContainerOperations.h, yielding between slices of scores.
+ * Other tasks may change the container between slices, so each score's song is the one found when its slice ran.
+ * @return The songs, in ascending order of score.
+ */
+Task<vector<Song>> rangeSearchAsync(AsyncExecutor& executor, SongContainer* container, int lowerBound, int upperBound) {
+    co_await executor.yield();
+    vector<int> scores = scoresToSearch(container, lowerBound, upperBound);
+    vector<Song> results;
+    for (unsigned int i = 0; i < scores.size(); i++) {
+        if (i > 0 && i % SCORES_PER_SLICE == 0) {
+            co_await executor.yield();
+        }
+        Song result = container->search(scores.at(i));
+        if (!result.getName().empty()) {
+            results.push_back(result);
+        }
+    }
+    co_return results;
+}
+
+
+/**
+ * Removes the n highest scoring songs, like extractTop() in ContainerOperations.h, yielding between slices of songs.
+ * Other tasks may change the container between slices, so the songs are the highest at the time each slice was taken.
+ * @return The removed songs, highest score first.
+ */
+Task<vector<Song>> extractTopAsync(AsyncExecutor& executor, SongContainer* container, int n) {
+    vector<Song> results;
+    while (static_cast<int>(results.size()) < n) {
+        co_await executor.yield();
+        int sliceSize = min(SONGS_PER_SLICE, n - static_cast<int>(results.size()));
+        vector<Song> slice = extractTop(container, sliceSize);
+        results.insert(results.end(), slice.begin(), slice.end());
+        if (static_cast<int>(slice.size()) < sliceSize) {
+            break; // The container ran out of songs.
+        }
+    }
+    co_return results;
+}
+
+
+Task<void> insertAsync(AsyncExecutor& executor, SongContainer* container, Song song) {
+    co_await executor.yield();
+    container->insert(move(song));
+}
+
+
+/**
+ * Removes a song by its track ID, like SongContainer::remove().
+ * @return true if the song was found and removed.
+ */
+Task<bool> removeAsync(AsyncExecutor& executor, SongContainer* container, string songName) {
+    co_await executor.yield();
+    co_return container->remove(songName);
+}
+
+
+Task<int> sizeAsync(AsyncExecutor& executor, SongContainer* container) {
+    co_await executor.yield();
+    co_return container->size();
+}
+
+
+/**
+ * Builds a container from songs on a helper thread, so the executor's other tasks keep running meanwhile. Other tasks
+ * must leave the container alone until this finishes, unless it is thread safe (see SongContainer::isThreadSafe()).
+ * @param songs The songs to build from. Must stay valid until this finishes.
+ */
+Task<void> buildAsync(AsyncExecutor& executor, SongContainer* container, vector<Song>& songs) {
+    co_await executor.offload([container, &songs]() {
+        container->build(songs);
+    });
+}
+
+
+/**
+ * Reads and merges database or snapshot files like readSqliteDbs(), a slice of rows at a time, yielding to the other
+ * tasks after each slice. The files are read one after another on the executor's thread. Nothing is printed except
+ * what opening a database prints, and nothing is ever asked.
+ * @param filepaths The paths to the SQLite database or snapshot files.
+ * @param resultsMap A map to contain each song name and its merged narcissism score. Must stay valid until this finishes.
+ * @param policy How to combine the scores of a track that appears in more than one file.
+ * @param profile The connection settings to use for the databases.
+ * @return true if every file was read, false if any of them could not be opened. Files before it have been read.
+ */
+Task<bool> loadAsync(AsyncExecutor& executor, vector<string> filepaths, TrackScoreMap& resultsMap, MergePolicy policy,
+                     SqliteReadProfile profile) {
+    for (unsigned int i = 0; i < filepaths.size(); i++) {
+        // A single file is read straight into the results. Otherwise, each file gets its own map to be merged:
+        TrackScoreMap fileMap;
+        TrackScoreMap& target = filepaths.size() == 1 ? resultsMap : fileMap;
+
+        IngestCursor cursor;
+        if (!cursor.open(filepaths.at(i).c_str(), target, profile)) {
+            co_return false;
+        }
+        while (cursor.step(ROWS_PER_SLICE)) {
+            co_await executor.yield();
+        }
+        if (filepaths.size() > 1) {
+            co_await executor.yield();
+            resultsMap.merge(fileMap, policy);
+        }
+    }
+    co_return true;
+}
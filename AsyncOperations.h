@@ -0,0 +1,47 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_ASYNCOPERATIONS_H
+#define COP3530_PROJECT_3_ASYNCOPERATIONS_H
+
+#include <string>
+#include <vector>
+
+#include "AsyncExecutor.h"
+#include "AsyncTask.h"
+#include "Song.h"
+#include "SongContainer.h"
+#include "SongDatabase.h"
+#include "TrackScoreMap.h"
+
+using namespace std;
+
+/*
+ * Awaitable versions of the container operations and of ingest, for coroutines run by an AsyncExecutor. They let one
+ * thread interleave queries with socket I/O and with reading a database, e.g.
+ *
+ *     Task<void> report(AsyncExecutor& executor, SongContainer* container) {
+ *         vector<Song> top = co_await extractTopAsync(executor, container, 10);
+ *         ...
+ *     }
+ *
+ * Every operation first yields to the other ready tasks, so a task sending many operations in a row takes turns with
+ * the rest instead of holding the thread. Operations that can take long also yield part way through (topk between
+ * slices of songs, load between slices of rows), or run on a helper thread (build). The container is only ever
+ * touched from the executor's thread, apart from build, so any container kind can be used.
+ */
+
+// Awaitable operations. See the .cpp implementation file:
+Task<Song> searchAsync(AsyncExecutor& executor, SongContainer* container, int targetScore);
+Task<vector<Song>> rangeSearchAsync(AsyncExecutor& executor, SongContainer* container, int lowerBound, int upperBound);
+Task<vector<Song>> extractTopAsync(AsyncExecutor& executor, SongContainer* container, int n);
+Task<void> insertAsync(AsyncExecutor& executor, SongContainer* container, Song song);
+Task<bool> removeAsync(AsyncExecutor& executor, SongContainer* container, string songName);
+Task<int> sizeAsync(AsyncExecutor& executor, SongContainer* container);
+Task<void> buildAsync(AsyncExecutor& executor, SongContainer* container, vector<Song>& songs);
+Task<bool> loadAsync(AsyncExecutor& executor, vector<string> filepaths, TrackScoreMap& resultsMap, MergePolicy policy,
+                     SqliteReadProfile profile = SqliteReadProfile());
+
+
+#endif //COP3530_PROJECT_3_ASYNCOPERATIONS_H
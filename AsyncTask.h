@@ -0,0 +1,168 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_ASYNCTASK_H
+#define COP3530_PROJECT_3_ASYNCTASK_H
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+using namespace std;
+
+template <typename T> class Task;
+
+/**
+ * The parts of a Task's promise that do not depend on its result type: the coroutine waiting for the task, and the
+ * exception the task ended with, if any.
+ */
+class TaskPromiseBase {
+private:
+    /**
+     * Run when a task finishes: resumes the coroutine that was waiting for it, if there is one, without growing the
+     * stack (the waiting coroutine is returned rather than resumed from in here).
+     */
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+
+        template <typename Promise>
+        coroutine_handle<> await_suspend(coroutine_handle<Promise> finished) noexcept {
+            coroutine_handle<> continuation = finished.promise().continuation;
+            return continuation ? continuation : noop_coroutine();
+        }
+
+        void await_resume() noexcept {}
+    };
+
+public:
+    coroutine_handle<> continuation; // Resumed when the task finishes. Empty for a task nothing is waiting for.
+    exception_ptr error;
+
+    suspend_always initial_suspend() noexcept { return {}; } // Tasks start when first awaited (or spawned).
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { error = current_exception(); }
+};
+
+/**
+ * The promise of a Task that produces a value.
+ */
+template <typename T>
+class TaskPromise : public TaskPromiseBase {
+public:
+    optional<T> value;
+
+    Task<T> get_return_object();
+    void return_value(T result) { value.emplace(move(result)); }
+
+    T takeResult() {
+        if (error) {
+            rethrow_exception(error);
+        }
+        return move(*value);
+    }
+};
+
+/**
+ * The promise of a Task<void>.
+ */
+template <>
+class TaskPromise<void> : public TaskPromiseBase {
+public:
+    Task<void> get_return_object();
+    void return_void() {}
+
+    void takeResult() {
+        if (error) {
+            rethrow_exception(error);
+        }
+    }
+};
+
+/**
+ * A C++20 coroutine that produces a T (or nothing, for Task<void>) and can be awaited by another coroutine.
+ *
+ * A task does nothing until it is awaited: `Song song = co_await searchAsync(executor, container, 42);`. The awaiting
+ * coroutine is suspended until the task finishes and then resumed straight away, on the same thread, so a chain of
+ * awaits costs no more than the function calls it replaces. A task that suspends (waiting for a socket, or yielding
+ * to let other tasks run, see AsyncExecutor.h) suspends every coroutine awaiting it, handing the thread back to the
+ * executor. Top-level tasks are started with AsyncExecutor::spawn() or AsyncExecutor::runUntilComplete().
+ *
+ * Each Task owns its coroutine frame and destroys it when the Task goes out of scope. Tasks can be moved, not copied.
+ */
+template <typename T>
+class Task {
+private:
+    coroutine_handle<TaskPromise<T>> handle;
+
+public:
+    typedef TaskPromise<T> promise_type;
+
+    explicit Task(coroutine_handle<TaskPromise<T>> handle) : handle(handle) {}
+    Task(Task&& other) noexcept : handle(exchange(other.handle, nullptr)) {}
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle) {
+                handle.destroy();
+            }
+            handle = exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+
+    ~Task() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    /**
+     * Gets whether the task has run to the end.
+     */
+    bool isDone() const {
+        return !handle || handle.done();
+    }
+
+    /**
+     * Gets the coroutine, for an executor to start. Still owned by the task.
+     */
+    coroutine_handle<> getHandle() const {
+        return handle;
+    }
+
+    /**
+     * Gets the result of a finished task, rethrowing the exception it ended with, if any.
+     */
+    T takeResult() {
+        return handle.promise().takeResult();
+    }
+
+    // Awaiting a task starts it, and resumes the awaiting coroutine once it finishes:
+    bool await_ready() const noexcept {
+        return !handle || handle.done();
+    }
+
+    coroutine_handle<> await_suspend(coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+
+    T await_resume() {
+        return handle.promise().takeResult();
+    }
+};
+
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() {
+    return Task<T>(coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() {
+    return Task<void>(coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+
+#endif //COP3530_PROJECT_3_ASYNCTASK_H
@@ -0,0 +1,83 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include "BatchQueryEngine.h"
+#include "ContainerOperations.h"
+#include "OperationLatencies.h"
+#include "Tracer.h"
+
+/**
+ * Constructor. Starts the worker threads.
+ * @param container The container the queries run against. Must be thread safe (see SongContainer::isThreadSafe).
+ * @param threadCount The number of worker threads.
+ */
+BatchQueryEngine::BatchQueryEngine(SongContainer* container, int threadCount) : container(container), pool(threadCount, "query worker") {}
+
+
+/**
+ * Runs a batch of queries in parallel and waits for all of them.
+ * @param queries The queries to run. They must not depend on each other.
+ * @return One result per query, in the same order as the queries.
+ */
+vector<QueryResult> BatchQueryEngine::run(const vector<Query>& queries) {
+    vector<QueryResult> results(queries.size());
+    if (!queries.empty()) {
+        pool.submit([this, &queries, &results]() {
+            runQueries(&queries, &results, 0, queries.size());
+        });
+        pool.wait();
+    }
+    return results;
+}
+
+
+int BatchQueryEngine::getThreadCount() const {
+    return pool.getThreadCount();
+}
+
+
+/**
+ * Runs part of a batch. While the part is large, its second half is handed back to the pool, where an idle worker can
+ * steal it, and this task carries on with the first half.
+ * @param queries The whole batch.
+ * @param results The results of the whole batch, one slot per query.
+ * @param first Index of the first query to run.
+ * @param last Index one past the last query to run.
+ */
+void BatchQueryEngine::runQueries(const vector<Query>* queries, vector<QueryResult>* results, unsigned int first, unsigned int last) {
+    while (last - first > QUERIES_PER_TASK) {
+        unsigned int middle = first + (last - first) / 2;
+        pool.submit([this, queries, results, middle, last]() {
+            runQueries(queries, results, middle, last);
+        });
+        last = middle;
+    }
+    for (unsigned int i = first; i < last; i++) {
+        runQuery(queries->at(i), results->at(i));
+    }
+}
+
+
+/**
+ * Runs a single query, timing only the container operation.
+ * @param query The query to run.
+ * @param result Populated with the songs found, the time taken and the allocations made.
+ */
+void BatchQueryEngine::runQuery(const Query& query, QueryResult& result) {
+    AllocationCounts allocationsBefore = threadAllocationCounts();
+    TraceClock::time_point startTime = TraceClock::now();
+    if (query.type == QUERY_SEARCH) {
+        Song song = container->search(query.lowerBound);
+        if (!song.getName().empty()) {
+            result.songs.push_back(song);
+        }
+    }
+    else {
+        result.songs = rangeSearch(container, query.lowerBound, query.upperBound);
+    }
+    TraceClock::time_point endTime = TraceClock::now();
+    result.allocations = threadAllocationCounts() - allocationsBefore;
+    result.nanoseconds = chrono::duration_cast<chrono::nanoseconds>(endTime - startTime).count();
+    traceSpan(OperationLatencies::operationName(query.type == QUERY_SEARCH ? TIMED_SEARCH : TIMED_RANGE), "query", startTime, endTime);
+}
@@ -0,0 +1,69 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_BATCHQUERYENGINE_H
+#define COP3530_PROJECT_3_BATCHQUERYENGINE_H
+
+#include <vector>
+
+#include "AllocationTracker.h"
+#include "Song.h"
+#include "SongContainer.h"
+#include "WorkStealingPool.h"
+
+using namespace std;
+
+/**
+ * The kinds of read-only query the engine can run.
+ */
+enum QueryType {
+    QUERY_SEARCH,
+    QUERY_RANGE
+};
+
+/**
+ * A single read-only query.
+ */
+struct Query {
+    QueryType type;
+    int lowerBound; // Score to search for, or the lower bound of a range.
+    int upperBound; // Upper bound of a range.
+};
+
+/**
+ * The outcome of one query.
+ */
+struct QueryResult {
+    vector<Song> songs; // The song a search found (none if no song has the score), or the songs a range found.
+    long long nanoseconds; // Time the container took to answer.
+    AllocationCounts allocations; // Heap allocations made while answering, in builds that count them.
+};
+
+/**
+ * Runs a batch of independent read-only queries on a pool of worker threads and hands the results back in the order
+ * the queries were given.
+ *
+ * The batch is split in half again and again by the workers themselves (see WorkStealingPool), so idle workers steal
+ * large pieces of the batch and the load evens out even when some queries (such as wide ranges) are much slower than
+ * others. Every result goes into its query's own slot, so no ordering or merging is needed afterwards.
+ */
+class BatchQueryEngine {
+private:
+    static const unsigned int QUERIES_PER_TASK = 16; // Pieces of the batch this small are no longer split.
+
+    SongContainer* container; // The container the queries run against. Not owned. Must be thread safe.
+    WorkStealingPool pool;
+
+    void runQueries(const vector<Query>* queries, vector<QueryResult>* results, unsigned int first, unsigned int last);
+    void runQuery(const Query& query, QueryResult& result);
+
+public:
+    BatchQueryEngine(SongContainer* container, int threadCount); // ctr
+
+    vector<QueryResult> run(const vector<Query>& queries);
+    int getThreadCount() const;
+};
+
+
+#endif //COP3530_PROJECT_3_BATCHQUERYENGINE_H
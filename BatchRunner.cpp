@@ -0,0 +1,392 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+#include "BatchRunner.h"
+#include "ContainerOperations.h"
+#include "SongDatabase.h"
+#include "TrackScoreMap.h"
+#include "Tracer.h"
+
+/**
+ * Constructor.
+ * @param container The container the commands run against.
+ * @param output Where the result lines are written.
+ */
+BatchRunner::BatchRunner(SongContainer* container, ostream& output) : container(container), output(output), queryEngine(nullptr) {}
+
+
+/**
+ * Destructor. Stops the query workers, if any.
+ */
+BatchRunner::~BatchRunner() {
+    delete queryEngine;
+}
+
+
+/**
+ * Turns on hardware counters around every timed operation. The averages are reported by the 'counters' command.
+ * @return true if at least one counter could be opened, false if none are available on this system.
+ */
+bool BatchRunner::enableCounters() {
+    return perf.open();
+}
+
+
+/**
+ * Gets the reason hardware counters could not be enabled.
+ * @return The error from PerfCounters::open(), or an empty string.
+ */
+const string& BatchRunner::getCounterError() const {
+    return perf.getError();
+}
+
+
+/**
+ * Answers runs of consecutive search and range commands on several threads at once.
+ * Only thread safe containers can be searched from several threads, so other containers keep running one at a time.
+ * @param jobs The number of threads. 1 runs every command on the calling thread.
+ * @return true if the commands will run on that many threads, false if the container is not thread safe.
+ */
+bool BatchRunner::setJobs(int jobs) {
+    delete queryEngine;
+    queryEngine = nullptr;
+    if (jobs <= 1) {
+        return true;
+    }
+    if (!container->isThreadSafe()) {
+        return false;
+    }
+    queryEngine = new BatchQueryEngine(container, jobs);
+    return true;
+}
+
+
+/**
+ * Runs every command in a command file, in order.
+ * @param commandFilepath The path to the command file.
+ * @return true if the file could be read, false otherwise.
+ */
+bool BatchRunner::run(const string& commandFilepath) {
+    ifstream commandFile(commandFilepath);
+    if (!commandFile) {
+        return false;
+    }
+
+    output << "line\tcommand\tstatus\ttime_ns\tresult" << endl;
+
+    string line;
+    int lineNumber = 0;
+    while (getline(commandFile, line)) {
+        lineNumber++;
+
+        // Skip comments and blank lines:
+        size_t firstChar = line.find_first_not_of(" \t\r");
+        if (firstChar == string::npos || line.at(firstChar) == '#') {
+            continue;
+        }
+
+        // Searches and ranges wait to be run together. Any other command runs once they are done:
+        if (queryEngine != nullptr && queueQuery(lineNumber, line)) {
+            continue;
+        }
+        runPendingQueries();
+        runCommand(lineNumber, line);
+    }
+    runPendingQueries();
+    return true;
+}
+
+
+/**
+ * Parses and runs a single command, timing only the container operation.
+ * @param lineNumber The line of the command file the command came from.
+ * @param line The command and its arguments.
+ */
+void BatchRunner::runCommand(int lineNumber, const string& line) {
+    istringstream args(line);
+    string command;
+    args >> command;
+
+    chrono::high_resolution_clock::time_point startTime;
+    chrono::high_resolution_clock::time_point endTime;
+    PerfSample counterSample; // Hardware counts of the operation. All invalid unless counters were enabled.
+    string result;
+
+    if (command == "load") {
+        // Remaining arguments are database files, plus an optional merge policy:
+        vector<string> filepaths;
+        MergePolicy policy = MergePolicy::SUM;
+        string arg;
+        while (args >> arg) {
+            if (arg.compare(0, 8, "--merge=") == 0) {
+                if (!parseMergePolicy(arg.substr(8), policy)) {
+                    writeResult(lineNumber, command, "error", 0, "unknown merge policy " + arg.substr(8));
+                    return;
+                }
+            }
+            else {
+                filepaths.push_back(arg);
+            }
+        }
+
+        // Batch runs must never stop to ask a question, so never offer to build an index:
+        SqliteReadProfile profile;
+        profile.offerIndexBuild = false;
+
+        TraceScope loadScope("load", "ingest"); // Covers the read and the build.
+        chrono::high_resolution_clock::time_point readStart = chrono::high_resolution_clock::now();
+        TrackScoreMap songScores;
+        if (filepaths.empty() || !readSqliteDbs(filepaths, songScores, policy, profile)) {
+            writeResult(lineNumber, command, "error", 0, "could not read database");
+            return;
+        }
+        chrono::high_resolution_clock::time_point readEnd = chrono::high_resolution_clock::now();
+
+        // The reported time is the build, like the menu. The read time is reported in the result:
+        AllocationCounts allocationsBefore = threadAllocationCounts();
+        perf.start();
+        startTime = chrono::high_resolution_clock::now();
+        container->build(songScores.getSongs());
+        endTime = chrono::high_resolution_clock::now();
+        perf.stop(counterSample);
+
+        latencies.record(TIMED_BUILD, chrono::duration_cast<chrono::nanoseconds>(endTime - startTime).count(), counterSample);
+        latencies.recordAllocations(TIMED_BUILD, threadAllocationCounts() - allocationsBefore);
+        traceSpan(OperationLatencies::operationName(TIMED_BUILD), "build", startTime, endTime);
+        traceCounter("container size", container->size());
+        result = "songs=" + to_string(songScores.size()) + " read_ns="
+                 + to_string(chrono::duration_cast<chrono::nanoseconds>(readEnd - readStart).count());
+    }
+
+    else if (command == "insert") {
+        string songId;
+        int score;
+        if (!(args >> songId >> score)) {
+            writeResult(lineNumber, command, "error", 0, "usage: insert <song id> <score>");
+            return;
+        }
+        AllocationCounts allocationsBefore = threadAllocationCounts();
+        perf.start();
+        startTime = chrono::high_resolution_clock::now();
+        container->insert(Song(songId, score));
+        endTime = chrono::high_resolution_clock::now();
+        perf.stop(counterSample);
+        latencies.record(TIMED_INSERT, chrono::duration_cast<chrono::nanoseconds>(endTime - startTime).count(), counterSample);
+        latencies.recordAllocations(TIMED_INSERT, threadAllocationCounts() - allocationsBefore);
+        traceSpan(OperationLatencies::operationName(TIMED_INSERT), "query", startTime, endTime);
+        traceCounter("container size", container->size());
+        result = songId + ":" + to_string(score);
+    }
+
+    else if (command == "remove") {
+        string songId;
+        if (!(args >> songId)) {
+            writeResult(lineNumber, command, "error", 0, "usage: remove <song id>");
+            return;
+        }
+        AllocationCounts allocationsBefore = threadAllocationCounts();
+        perf.start();
+        startTime = chrono::high_resolution_clock::now();
+        bool success = container->remove(songId);
+        endTime = chrono::high_resolution_clock::now();
+        perf.stop(counterSample);
+        latencies.record(TIMED_REMOVE, chrono::duration_cast<chrono::nanoseconds>(endTime - startTime).count(), counterSample);
+        latencies.recordAllocations(TIMED_REMOVE, threadAllocationCounts() - allocationsBefore);
+        traceSpan(OperationLatencies::operationName(TIMED_REMOVE), "query", startTime, endTime);
+        traceCounter("container size", container->size());
+        result = success ? "removed" : "not_found";
+    }
+
+    else if (command == "search") {
+        int targetScore;
+        if (!(args >> targetScore)) {
+            writeResult(lineNumber, command, "error", 0, "usage: search <score>");
+            return;
+        }
+        AllocationCounts allocationsBefore = threadAllocationCounts();
+        perf.start();
+        startTime = chrono::high_resolution_clock::now();
+        Song song = container->search(targetScore);
+        endTime = chrono::high_resolution_clock::now();
+        perf.stop(counterSample);
+        latencies.record(TIMED_SEARCH, chrono::duration_cast<chrono::nanoseconds>(endTime - startTime).count(), counterSample);
+        latencies.recordAllocations(TIMED_SEARCH, threadAllocationCounts() - allocationsBefore);
+        traceSpan(OperationLatencies::operationName(TIMED_SEARCH), "query", startTime, endTime);
+        result = song.getName().empty() ? "" : song.getName() + ":" + to_string(song.getScore());
+    }
+
+    else if (command == "range") {
+        int lowerBound;
+        int upperBound;
+        if (!(args >> lowerBound >> upperBound)) {
+            writeResult(lineNumber, command, "error", 0, "usage: range <min score> <max score>");
+            return;
+        }
+        AllocationCounts allocationsBefore = threadAllocationCounts();
+        perf.start();
+        startTime = chrono::high_resolution_clock::now();
+        vector<Song> songs = rangeSearch(container, lowerBound, upperBound);
+        endTime = chrono::high_resolution_clock::now();
+        perf.stop(counterSample);
+        latencies.record(TIMED_RANGE, chrono::duration_cast<chrono::nanoseconds>(endTime - startTime).count(), counterSample);
+        latencies.recordAllocations(TIMED_RANGE, threadAllocationCounts() - allocationsBefore);
+        traceSpan(OperationLatencies::operationName(TIMED_RANGE), "query", startTime, endTime);
+        result = formatSongs(songs);
+    }
+
+    else if (command == "topk") {
+        int n;
+        if (!(args >> n)) {
+            writeResult(lineNumber, command, "error", 0, "usage: topk <n>");
+            return;
+        }
+        // Each extraction is recorded on its own, like option 8 of the menu. The reported time is their total:
+        vector<Song> songs;
+        long long totalTime = 0;
+        for (int i = 0; i < n && container->size() > 0; i++) {
+            AllocationCounts allocationsBefore = threadAllocationCounts();
+            perf.start();
+            chrono::high_resolution_clock::time_point extractStart = chrono::high_resolution_clock::now();
+            songs.push_back(container->extractMax());
+            chrono::high_resolution_clock::time_point extractEnd = chrono::high_resolution_clock::now();
+            perf.stop(counterSample);
+            long long nanoseconds = chrono::duration_cast<chrono::nanoseconds>(extractEnd - extractStart).count();
+            latencies.record(TIMED_EXTRACT, nanoseconds, counterSample);
+            latencies.recordAllocations(TIMED_EXTRACT, threadAllocationCounts() - allocationsBefore);
+            traceSpan(OperationLatencies::operationName(TIMED_EXTRACT), "query", extractStart, extractEnd);
+            traceCounter("container size", container->size());
+            totalTime += nanoseconds;
+        }
+        writeResult(lineNumber, command, "ok", totalTime, formatSongs(songs));
+        return;
+    }
+
+    else if (command == "size") {
+        AllocationCounts allocationsBefore = threadAllocationCounts();
+        perf.start();
+        startTime = chrono::high_resolution_clock::now();
+        int size = container->size();
+        endTime = chrono::high_resolution_clock::now();
+        perf.stop(counterSample);
+        latencies.record(TIMED_SIZE, chrono::duration_cast<chrono::nanoseconds>(endTime - startTime).count(), counterSample);
+        latencies.recordAllocations(TIMED_SIZE, threadAllocationCounts() - allocationsBefore);
+        traceSpan(OperationLatencies::operationName(TIMED_SIZE), "query", startTime, endTime);
+        result = to_string(size);
+    }
+
+    else if (command == "memory") {
+        // Not a timed operation. Walks the whole container:
+        writeResult(lineNumber, command, "ok", 0, container->memoryUsage().summary());
+        return;
+    }
+
+    else if (command == "allocations") {
+        // Heap allocations of every operation so far, in builds that count them (make ALLOCS=1):
+        writeResult(lineNumber, command, allocationTrackingEnabled() ? "ok" : "unavailable", 0, latencies.allocationSummary());
+        return;
+    }
+
+    else if (command == "counters") {
+        // Average hardware counts of every operation so far, if counters were enabled with --perf:
+        writeResult(lineNumber, command, perf.isAvailable() ? "ok" : "unavailable", 0, latencies.counterSummary());
+        return;
+    }
+
+    else if (command == "latency") {
+        // Summary of every operation timed so far in this run:
+        writeResult(lineNumber, command, "ok", 0, latencies.summary());
+        return;
+    }
+
+    else {
+        writeResult(lineNumber, command, "error", 0, "unknown command");
+        return;
+    }
+
+    writeResult(lineNumber, command, "ok", chrono::duration_cast<chrono::nanoseconds>(endTime - startTime).count(), result);
+}
+
+
+/**
+ * Queues a search or range command to be run with the ones next to it.
+ * @param lineNumber The line of the command file the command came from.
+ * @param line The command and its arguments.
+ * @return true if the command was queued, false if it is some other command or has invalid arguments.
+ */
+bool BatchRunner::queueQuery(int lineNumber, const string& line) {
+    istringstream args(line);
+    string command;
+    args >> command;
+
+    Query query;
+    query.upperBound = 0;
+    if (command == "search" && args >> query.lowerBound) {
+        query.type = QUERY_SEARCH;
+    }
+    else if (command == "range" && args >> query.lowerBound >> query.upperBound) {
+        query.type = QUERY_RANGE;
+    }
+    else {
+        return false;
+    }
+    pendingQueries.push_back(query);
+    pendingLines.push_back(lineNumber);
+    return true;
+}
+
+
+/**
+ * Runs the queued search and range commands in parallel, then records and writes their results in order.
+ * Hardware counters only count the thread that opened them, so they are not read for these commands.
+ */
+void BatchRunner::runPendingQueries() {
+    if (pendingQueries.empty()) {
+        return;
+    }
+    vector<QueryResult> results = queryEngine->run(pendingQueries);
+    for (unsigned int i = 0; i < results.size(); i++) {
+        const QueryResult& queryResult = results.at(i);
+        if (pendingQueries.at(i).type == QUERY_SEARCH) {
+            latencies.record(TIMED_SEARCH, queryResult.nanoseconds);
+            latencies.recordAllocations(TIMED_SEARCH, queryResult.allocations);
+            writeResult(pendingLines.at(i), "search", "ok", queryResult.nanoseconds, formatSongs(queryResult.songs));
+        }
+        else {
+            latencies.record(TIMED_RANGE, queryResult.nanoseconds);
+            latencies.recordAllocations(TIMED_RANGE, queryResult.allocations);
+            writeResult(pendingLines.at(i), "range", "ok", queryResult.nanoseconds, formatSongs(queryResult.songs));
+        }
+    }
+    pendingQueries.clear();
+    pendingLines.clear();
+}
+
+
+/**
+ * Writes one tab separated result line.
+ */
+void BatchRunner::writeResult(int lineNumber, const string& command, const string& status, long long nanoseconds, const string& result) {
+    output << lineNumber << '\t' << command << '\t' << status << '\t' << nanoseconds << '\t' << result << '\n';
+}
+
+
+/**
+ * Formats a list of songs as comma separated id:score pairs.
+ * @param songs The songs to format.
+ * @return The formatted list.
+ */
+string BatchRunner::formatSongs(const vector<Song>& songs) {
+    string formatted;
+    for (unsigned int i = 0; i < songs.size(); i++) {
+        if (i > 0) {
+            formatted += ',';
+        }
+        formatted += songs.at(i).getName() + ":" + to_string(songs.at(i).getScore());
+    }
+    return formatted;
+}
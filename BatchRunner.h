@@ -0,0 +1,69 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_BATCHRUNNER_H
+#define COP3530_PROJECT_3_BATCHRUNNER_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "BatchQueryEngine.h"
+#include "OperationLatencies.h"
+#include "PerfCounters.h"
+#include "Song.h"
+#include "SongContainer.h"
+
+using namespace std;
+
+/**
+ * Runs a file of container commands without any prompts, for reproducible benchmarking.
+ * Each command produces one tab separated line of output: line number, command, status, time in nanoseconds and result.
+ *
+ * Supported commands (one per line, '#' starts a comment):
+ *   load <db file>... [--merge=sum|max|last]
+ *   insert <song id> <score>
+ *   remove <song id>
+ *   search <score>
+ *   range <min score> <max score>
+ *   topk <n>
+ *   size
+ *   latency    (p50/p90/p99/p99.9/max of every operation timed so far)
+ *   counters   (average hardware counts per operation, when enabled with enableCounters())
+ *   memory     (bytes used by the container, by category)
+ *   allocations (heap allocations per operation, in builds made with ALLOCS=1)
+ *
+ * With setJobs(), runs of consecutive search and range commands are answered in parallel (see BatchQueryEngine).
+ * Their lines are still written in command file order.
+ */
+class BatchRunner {
+private:
+    SongContainer* container; // The container the commands run against. Not owned.
+    ostream& output; // Where the result lines are written.
+    OperationLatencies latencies; // Latency histogram of every operation run so far.
+    PerfCounters perf; // Hardware counters around every timed operation. Only counting after enableCounters().
+    BatchQueryEngine* queryEngine; // Runs search and range commands in parallel, or nullptr to run them one at a time.
+
+    // Search and range commands waiting to be run together, and the lines they came from:
+    vector<Query> pendingQueries;
+    vector<int> pendingLines;
+
+    void runCommand(int lineNumber, const string& line);
+    bool queueQuery(int lineNumber, const string& line);
+    void runPendingQueries();
+    void writeResult(int lineNumber, const string& command, const string& status, long long nanoseconds, const string& result);
+    static string formatSongs(const vector<Song>& songs);
+
+public:
+    BatchRunner(SongContainer* container, ostream& output); // ctr
+    ~BatchRunner(); // dtr
+
+    bool enableCounters();
+    bool setJobs(int jobs);
+    const string& getCounterError() const;
+    bool run(const string& commandFilepath);
+};
+
+
+#endif //COP3530_PROJECT_3_BATCHRUNNER_H
@@ -0,0 +1,146 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <climits>
+#include <mutex>
+
+#include "ConcurrentSplayTree.h"
+
+const int ConcurrentSplayTree::NO_PENDING_SPLAY = INT_MIN;
+
+/**
+ * Constructor.
+ * @param splayInterval One search in this many asks the next writer to splay the score it searched for.
+ *                      1 defers a splay for every search, 0 never splays on behalf of readers.
+ */
+ConcurrentSplayTree::ConcurrentSplayTree(int splayInterval) : splayInterval(splayInterval), nextPendingSlot(0) {
+    for (int i = 0; i < PENDING_SPLAY_SLOTS; i++) {
+        pendingSplays[i].store(NO_PENDING_SPLAY, memory_order_relaxed);
+    }
+}
+
+
+/**
+ * Asks the next writer to splay a score, if this search is one of the sampled ones.
+ * Uses only atomics, so readers never wait for each other here.
+ * @param score The score that was searched for.
+ */
+void ConcurrentSplayTree::requestSplay(int score) {
+    if (splayInterval <= 0) {
+        return;
+    }
+    // Each thread counts its own searches, so sampling needs no shared counter:
+    static thread_local unsigned int searchCount = 0;
+    if (++searchCount % splayInterval != 0) {
+        return;
+    }
+    unsigned int slot = nextPendingSlot.fetch_add(1, memory_order_relaxed) % PENDING_SPLAY_SLOTS;
+    pendingSplays[slot].store(score, memory_order_relaxed);
+}
+
+
+/**
+ * Splays every score readers asked for. Only called with the exclusive lock held.
+ */
+void ConcurrentSplayTree::applyPendingSplays() {
+    for (int i = 0; i < PENDING_SPLAY_SLOTS; i++) {
+        int score = pendingSplays[i].exchange(NO_PENDING_SPLAY, memory_order_relaxed);
+        if (score != NO_PENDING_SPLAY) {
+            tree.search(score); // The splaying search moves the song to the root.
+        }
+    }
+}
+
+
+void ConcurrentSplayTree::build(vector<Song>& inputSongs) {
+    unique_lock<shared_mutex> lock(treeLock);
+    tree.build(inputSongs);
+}
+
+
+Song ConcurrentSplayTree::extractMax() {
+    unique_lock<shared_mutex> lock(treeLock);
+    applyPendingSplays();
+    return tree.extractMax();
+}
+
+
+Song ConcurrentSplayTree::peekMax() {
+    shared_lock<shared_mutex> lock(treeLock);
+    return tree.peekMax();
+}
+
+
+/**
+ * Searches for a song by score under the shared lock, without splaying.
+ * @param targetScore The score to search for.
+ * @return A copy of the Song that was found, or an empty Song if no song has the score.
+ */
+Song ConcurrentSplayTree::search(int targetScore) {
+    Song result;
+    {
+        shared_lock<shared_mutex> lock(treeLock);
+        result = tree.find(targetScore);
+    }
+    if (!result.getName().empty()) {
+        requestSplay(targetScore);
+    }
+    return result;
+}
+
+
+/**
+ * Searches for one song per score in a range under the shared lock, without splaying.
+ * @param lowerBound The minimum score to search for.
+ * @param upperBound The maximum score to search for.
+ * @return The songs that were found, in ascending order of score. Scores with no song are left out.
+ */
+vector<Song> ConcurrentSplayTree::searchRange(int lowerBound, int upperBound) {
+    shared_lock<shared_mutex> lock(treeLock);
+    return tree.findRange(lowerBound, upperBound);
+}
+
+
+void ConcurrentSplayTree::insert(Song song) {
+    unique_lock<shared_mutex> lock(treeLock);
+    applyPendingSplays();
+    tree.insert(move(song));
+}
+
+
+bool ConcurrentSplayTree::remove(string songName, Song* removed) {
+    unique_lock<shared_mutex> lock(treeLock);
+    applyPendingSplays();
+    return tree.remove(move(songName), removed);
+}
+
+
+bool ConcurrentSplayTree::removeKey(int score, const string& songName) {
+    unique_lock<shared_mutex> lock(treeLock);
+    applyPendingSplays();
+    return tree.removeKey(score, songName);
+}
+
+
+int ConcurrentSplayTree::size() {
+    shared_lock<shared_mutex> lock(treeLock);
+    return tree.size();
+}
+
+
+MemoryUsage ConcurrentSplayTree::memoryUsage() {
+    shared_lock<shared_mutex> lock(treeLock);
+    return tree.memoryUsage();
+}
+
+
+vector<Song> ConcurrentSplayTree::toVector() {
+    shared_lock<shared_mutex> lock(treeLock);
+    return tree.toVector();
+}
+
+
+bool ConcurrentSplayTree::isThreadSafe() {
+    return true;
+}
@@ -0,0 +1,63 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_CONCURRENTSPLAYTREE_H
+#define COP3530_PROJECT_3_CONCURRENTSPLAYTREE_H
+
+#include <atomic>
+#include <shared_mutex>
+#include <vector>
+
+#include "Song.h"
+#include "SongContainer.h"
+#include "SplayTree.h"
+
+using namespace std;
+
+/**
+ * A SplayTree that many threads can read at once.
+ *
+ * Searches and range searches take a shared (reader) lock and use the tree's read-only lookups, which never splay.
+ * Only inserts, removes, extractMax and build take the exclusive (writer) lock. Readers still get some of the benefit
+ * of splaying: every splayInterval-th search notes its score in a small lock-free buffer, and the next writer splays
+ * those scores to the top before doing its own work. Frequently searched songs therefore still drift towards the root,
+ * but the restructuring is done by writers, which hold the tree exclusively anyway.
+ */
+class ConcurrentSplayTree : public SongContainer {
+private:
+    static const int PENDING_SPLAY_SLOTS = 64;
+    static const int NO_PENDING_SPLAY; // Marks an empty slot in pendingSplays.
+
+    SplayTree tree;
+    mutable shared_mutex treeLock;
+    int splayInterval; // One search in this many asks for a deferred splay. 0 turns deferred splaying off.
+
+    // Scores waiting to be splayed by the next writer. Readers overwrite slots round robin, so old requests are dropped:
+    atomic<int> pendingSplays[PENDING_SPLAY_SLOTS];
+    atomic<unsigned int> nextPendingSlot;
+
+    void requestSplay(int score);
+    void applyPendingSplays();
+
+public:
+    ConcurrentSplayTree(int splayInterval = 16); // ctr
+
+    // Overridden functions. See the .cpp implementation file:
+    virtual void build(vector<Song>& inputSongs);
+    virtual Song extractMax();
+    virtual Song peekMax();
+    virtual Song search(int targetScore);
+    virtual void insert(Song song);
+    virtual bool remove(string songName, Song* removed = nullptr);
+    virtual bool removeKey(int score, const string& songName);
+    virtual int size();
+    virtual MemoryUsage memoryUsage();
+    virtual vector<Song> toVector();
+    virtual bool isThreadSafe();
+
+    vector<Song> searchRange(int lowerBound, int upperBound);
+};
+
+
+#endif //COP3530_PROJECT_3_CONCURRENTSPLAYTREE_H
@@ -0,0 +1,175 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "ConcurrentSplayTree.h"
+#include "ContainerOperations.h"
+#include "LockFreeSkipList.h"
+#include "MaxHeap.h"
+#include "MultiQueue.h"
+#include "PersistentTreap.h"
+#include "ShardedContainer.h"
+#include "SplayTree.h"
+
+/**
+ * Creates an empty container by name.
+ * @param kind "heap" for a MaxHeap or "splay" for a SplayTree. "sharded-heap" or "sharded-splay" give a thread safe
+ *             ShardedContainer of those, with the default number of shards unless one is added (e.g. "sharded-heap:8").
+ *             "concurrent-splay" gives a ConcurrentSplayTree. "multiqueue" gives a MultiQueue with the default number of
+ *             heaps, or the number added after a colon (e.g. "multiqueue:16"). "skiplist" gives a LockFreeSkipList, and
+ *             "persistent-treap" a PersistentTreap.
+ * @return A new container owned by the caller, or nullptr if the name is not recognised.
+ */
+SongContainer* createContainer(const string& kind) {
+    if (kind == "heap") {
+        return new MaxHeap();
+    }
+    if (kind == "splay") {
+        return new SplayTree();
+    }
+    if (kind == "concurrent-splay") {
+        return new ConcurrentSplayTree();
+    }
+
+    if (kind == "skiplist") {
+        return new LockFreeSkipList();
+    }
+    if (kind == "persistent-treap") {
+        return new PersistentTreap();
+    }
+    if (kind == "multiqueue") {
+        return new MultiQueue(MultiQueue::defaultQueueCount());
+    }
+    if (kind.compare(0, 11, "multiqueue:") == 0) {
+        int queueCount = atoi(kind.c_str() + 11);
+        return queueCount > 0 ? new MultiQueue(queueCount) : nullptr;
+    }
+
+    // Sharded containers, with an optional shard count after a colon:
+    if (kind.compare(0, 8, "sharded-") == 0) {
+        string innerKind = kind.substr(8);
+        int shardCount = ShardedContainer::defaultShardCount();
+        size_t colon = innerKind.find(':');
+        if (colon != string::npos) {
+            shardCount = atoi(innerKind.c_str() + colon + 1);
+            innerKind = innerKind.substr(0, colon);
+        }
+        if ((innerKind == "heap" || innerKind == "splay") && shardCount > 0) {
+            return new ShardedContainer(innerKind, shardCount);
+        }
+    }
+    return nullptr;
+}
+
+
+/**
+ * Lists every name accepted by createContainer.
+ * @return The container names.
+ */
+vector<string> containerKinds() {
+    vector<string> kinds;
+    kinds.push_back("heap");
+    kinds.push_back("splay");
+    kinds.push_back("sharded-heap");
+    kinds.push_back("sharded-splay");
+    kinds.push_back("concurrent-splay");
+    kinds.push_back("multiqueue");
+    kinds.push_back("skiplist");
+    kinds.push_back("persistent-treap");
+    return kinds;
+}
+
+
+/**
+ * Gets the scores a range search has to search one at a time. A range wider than the container has songs (such as
+ * 0 to INT_MAX) is narrowed to the scores the container actually has, so the search never costs more than a pass over
+ * the songs, whatever the bounds.
+ * @param container The container to search.
+ * @param lowerBound The minimum score to search for.
+ * @param upperBound The maximum score to search for.
+ * @return The scores, in ascending order.
+ */
+vector<int> scoresToSearch(SongContainer* container, int lowerBound, int upperBound) {
+    vector<int> scores;
+    long long width = static_cast<long long>(upperBound) - lowerBound + 1; // Too wide for an int at the extremes.
+    if (width <= 0) {
+        return scores;
+    }
+    if (width <= container->size()) {
+        scores.reserve(width);
+        for (long long score = lowerBound; score <= upperBound; score++) {
+            scores.push_back(static_cast<int>(score));
+        }
+        return scores;
+    }
+
+    vector<Song> songs = container->toVector();
+    for (unsigned int i = 0; i < songs.size(); i++) {
+        if (songs.at(i).getScore() >= lowerBound && songs.at(i).getScore() <= upperBound) {
+            scores.push_back(songs.at(i).getScore());
+        }
+    }
+    sort(scores.begin(), scores.end());
+    scores.erase(unique(scores.begin(), scores.end()), scores.end());
+    return scores;
+}
+
+
+/**
+ * Searches for one song per score in a range of scores, like option 6 of the menu.
+ * A ConcurrentSplayTree does this in one read-only pass under its shared lock rather than one search() per score,
+ * a LockFreeSkipList with one lock-free search per score found, and a PersistentTreap on a single snapshot.
+ * @param container The container to search.
+ * @param lowerBound The minimum score to search for.
+ * @param upperBound The maximum score to search for.
+ * @return The songs that were found, in ascending order of score. Scores with no song are left out.
+ */
+vector<Song> rangeSearch(SongContainer* container, int lowerBound, int upperBound) {
+    ConcurrentSplayTree* concurrentTree = dynamic_cast<ConcurrentSplayTree*>(container);
+    if (concurrentTree != nullptr) {
+        return concurrentTree->searchRange(lowerBound, upperBound);
+    }
+    LockFreeSkipList* skipList = dynamic_cast<LockFreeSkipList*>(container);
+    if (skipList != nullptr) {
+        return skipList->searchRange(lowerBound, upperBound);
+    }
+    PersistentTreap* treap = dynamic_cast<PersistentTreap*>(container);
+    if (treap != nullptr) {
+        return treap->searchRange(lowerBound, upperBound);
+    }
+
+    vector<Song> results;
+    vector<int> scores = scoresToSearch(container, lowerBound, upperBound);
+    for (unsigned int i = 0; i < scores.size(); i++) {
+        Song result = container->search(scores.at(i));
+        if (!result.getName().empty()) { // If the name is empty, then no song has this score.
+            results.push_back(result);
+        }
+    }
+    return results;
+}
+
+
+/**
+ * Removes the highest scoring songs from a container, like option 8 of the menu.
+ * A ShardedContainer does this as a single k-way merge over its shards rather than one extractMax() at a time.
+ * A MultiQueue's extractMax() is relaxed, so its songs come out close to, but not exactly in, score order.
+ * @param container The container to remove from.
+ * @param n The number of songs to remove. Stops early if the container runs out of songs.
+ * @return The removed songs, highest score first.
+ */
+vector<Song> extractTop(SongContainer* container, int n) {
+    ShardedContainer* sharded = dynamic_cast<ShardedContainer*>(container);
+    if (sharded != nullptr) {
+        return sharded->extractTop(n);
+    }
+
+    vector<Song> results;
+    for (int i = 0; i < n && container->size() > 0; i++) {
+        results.push_back(container->extractMax());
+    }
+    return results;
+}
@@ -0,0 +1,24 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_CONTAINEROPERATIONS_H
+#define COP3530_PROJECT_3_CONTAINEROPERATIONS_H
+
+#include <string>
+#include <vector>
+
+#include "Song.h"
+#include "SongContainer.h"
+
+using namespace std;
+
+// Operations shared by the interactive menu, batch mode and the benchmarks. See the .cpp implementation file:
+SongContainer* createContainer(const string& kind);
+vector<string> containerKinds();
+vector<int> scoresToSearch(SongContainer* container, int lowerBound, int upperBound);
+vector<Song> rangeSearch(SongContainer* container, int lowerBound, int upperBound);
+vector<Song> extractTop(SongContainer* container, int n);
+
+
+#endif //COP3530_PROJECT_3_CONTAINEROPERATIONS_H
@@ -0,0 +1,166 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include "EpochManager.h"
+
+static atomic<unsigned long long> nextInstanceId(1);
+
+/**
+ * Constructor.
+ */
+EpochManager::EpochManager() : globalEpoch(1), records(nullptr), instanceId(nextInstanceId.fetch_add(1)), pendingCount(0) {
+}
+
+
+/**
+ * Destructor. Deletes every object still waiting to be deleted. No thread may be inside a guard.
+ */
+EpochManager::~EpochManager() {
+    ThreadRecord* record = records.load();
+    while (record != nullptr) {
+        for (unsigned int i = 0; i < record->retired.size(); i++) {
+            record->retired.at(i).deleter(record->retired.at(i).object);
+        }
+        ThreadRecord* next = record->nextRecord;
+        delete record;
+        record = next;
+    }
+}
+
+
+/**
+ * Gets the calling thread's record, creating it on the thread's first use of this manager.
+ * The last record used is cached per thread, so this is usually a couple of loads.
+ * @return The calling thread's record.
+ */
+EpochManager::ThreadRecord* EpochManager::threadRecord() {
+    static thread_local unsigned long long cachedInstance = 0;
+    static thread_local ThreadRecord* cachedRecord = nullptr;
+    if (cachedInstance == instanceId) {
+        return cachedRecord;
+    }
+
+    thread::id self = this_thread::get_id();
+    ThreadRecord* record = records.load(memory_order_acquire);
+    while (record != nullptr && record->owner != self) {
+        record = record->nextRecord;
+    }
+    if (record == nullptr) {
+        record = new ThreadRecord();
+        record->announcedEpoch.store(0, memory_order_relaxed);
+        record->owner = self;
+        record->guardDepth = 0;
+        record->nextRecord = records.load(memory_order_relaxed);
+        while (!records.compare_exchange_weak(record->nextRecord, record, memory_order_release, memory_order_relaxed)) {
+        }
+    }
+    cachedInstance = instanceId;
+    cachedRecord = record;
+    return record;
+}
+
+
+/**
+ * Moves the global epoch forward by one, if every thread inside a guard has already seen the current epoch.
+ * @return true if the epoch moved forward (here or in another thread), false otherwise.
+ */
+bool EpochManager::tryAdvance() {
+    unsigned long long epoch = globalEpoch.load();
+    for (ThreadRecord* record = records.load(); record != nullptr; record = record->nextRecord) {
+        unsigned long long announced = record->announcedEpoch.load();
+        if ((announced & 1) != 0 && (announced >> 1) != epoch) {
+            return false;
+        }
+    }
+    return globalEpoch.compare_exchange_strong(epoch, epoch + 1) || globalEpoch.load() != epoch;
+}
+
+
+/**
+ * Deletes the calling thread's retired objects that no thread can still be reading.
+ * @param record The calling thread's record.
+ */
+void EpochManager::reclaim(ThreadRecord* record) {
+    unsigned long long safeEpoch = globalEpoch.load();
+    unsigned int reclaimed = 0;
+    while (reclaimed < record->retired.size() && record->retired.at(reclaimed).epoch + 2 <= safeEpoch) {
+        record->retired.at(reclaimed).deleter(record->retired.at(reclaimed).object);
+        reclaimed++;
+    }
+    if (reclaimed > 0) {
+        record->retired.erase(record->retired.begin(), record->retired.begin() + reclaimed);
+        pendingCount.fetch_sub(reclaimed, memory_order_relaxed);
+    }
+}
+
+
+/**
+ * Enters a guarded region. Usually called through EpochGuard.
+ */
+void EpochManager::enter() {
+    ThreadRecord* record = threadRecord();
+    if (record->guardDepth++ == 0) {
+        record->announcedEpoch.store((globalEpoch.load() << 1) | 1);
+        // Nothing the thread reads from the container may be loaded before the announcement is visible:
+        atomic_thread_fence(memory_order_seq_cst);
+    }
+}
+
+
+/**
+ * Leaves a guarded region. Pointers read inside it must not be used afterwards.
+ */
+void EpochManager::leave() {
+    ThreadRecord* record = threadRecord();
+    if (--record->guardDepth == 0) {
+        record->announcedEpoch.store(0, memory_order_release);
+    }
+}
+
+
+/**
+ * Hands over an object that has been unlinked from the container, to be deleted once no thread can be reading it.
+ * The object must no longer be reachable by a thread that enters a guard from now on.
+ * @param object The object to delete.
+ * @param deleter The function that deletes it.
+ */
+void EpochManager::retire(void* object, void (*deleter)(void*)) {
+    ThreadRecord* record = threadRecord();
+    RetiredObject retiredObject = {object, deleter, globalEpoch.load()};
+    record->retired.push_back(retiredObject);
+    pendingCount.fetch_add(1, memory_order_relaxed);
+    if (record->retired.size() >= RECLAIM_THRESHOLD) {
+        tryAdvance();
+        reclaim(record);
+    }
+}
+
+
+/**
+ * Gets the number of objects that have been retired but not deleted yet.
+ * @return The number of objects.
+ */
+size_t EpochManager::pending() const {
+    return pendingCount.load(memory_order_relaxed);
+}
+
+
+// EpochGuard:
+// ===========
+
+/**
+ * Constructor. Enters a guarded region.
+ * @param manager The manager of the container about to be read.
+ */
+EpochGuard::EpochGuard(EpochManager& manager) : manager(manager) {
+    manager.enter();
+}
+
+
+/**
+ * Destructor. Leaves the guarded region.
+ */
+EpochGuard::~EpochGuard() {
+    manager.leave();
+}
@@ -0,0 +1,83 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_EPOCHMANAGER_H
+#define COP3530_PROJECT_3_EPOCHMANAGER_H
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Epoch based memory reclamation for lock-free containers.
+ *
+ * A lock-free container cannot delete a node as soon as it is unlinked, since another thread may still be reading
+ * it. Instead, every thread that reads the container does so inside a guard (see EpochGuard), which records the
+ * global epoch the thread started in. Unlinked nodes are retired rather than deleted, tagged with the epoch they were
+ * retired in. The global epoch only moves forward once every thread inside a guard has seen the current one, so once
+ * it is two epochs past a node's, no thread can still be holding a pointer to that node and it is deleted.
+ *
+ * Each thread keeps its own list of retired nodes, so retiring never contends with other threads.
+ */
+class EpochManager {
+private:
+    static const unsigned int RECLAIM_THRESHOLD = 64; // Retired objects a thread collects before trying to delete some.
+
+    /**
+     * An object waiting to be deleted, with the function that deletes it.
+     */
+    struct RetiredObject {
+        void* object;
+        void (*deleter)(void*);
+        unsigned long long epoch; // Global epoch when the object was retired.
+    };
+
+    /**
+     * What the manager knows about one thread. Records are never freed before the manager, so they can be read
+     * without locks; a thread that exits leaves its record for the next thread that gets the same ID.
+     */
+    struct ThreadRecord {
+        atomic<unsigned long long> announcedEpoch; // (epoch << 1) | 1 while the thread is inside a guard, 0 otherwise.
+        thread::id owner;
+        int guardDepth; // Guards can be nested. Only the outermost one announces an epoch.
+        vector<RetiredObject> retired; // Oldest first. Only used by the owning thread.
+        ThreadRecord* nextRecord;
+    };
+
+    atomic<unsigned long long> globalEpoch;
+    atomic<ThreadRecord*> records; // Singly linked. Records are only ever added, at the front.
+    unsigned long long instanceId; // Tells managers apart in the per-thread cache, even if one reuses another's address.
+    atomic<size_t> pendingCount; // Objects retired but not deleted yet, over every thread.
+
+    ThreadRecord* threadRecord();
+    bool tryAdvance();
+    void reclaim(ThreadRecord* record);
+
+public:
+    EpochManager(); // ctr
+    ~EpochManager(); // dtr
+
+    void enter();
+    void leave();
+    void retire(void* object, void (*deleter)(void*));
+    size_t pending() const;
+};
+
+/**
+ * Keeps the calling thread inside an epoch for as long as the guard exists, so any node it reads stays allocated.
+ */
+class EpochGuard {
+private:
+    EpochManager& manager;
+
+public:
+    explicit EpochGuard(EpochManager& manager); // ctr
+    ~EpochGuard(); // dtr
+};
+
+
+#endif //COP3530_PROJECT_3_EPOCHMANAGER_H
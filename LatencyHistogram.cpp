@@ -0,0 +1,150 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <cmath>
+#include <limits>
+
+#include "LatencyHistogram.h"
+
+/**
+ * Default constructor initializes an empty histogram.
+ */
+LatencyHistogram::LatencyHistogram() : counts(BUCKET_COUNT, 0) {
+    reset();
+}
+
+
+/**
+ * Finds the bucket a value is counted in.
+ * Values below 128 get a bucket each. Above that, the position of the highest set bit picks the power of two range
+ * and the next 6 bits pick the sub-bucket within it.
+ * @param value The value to look up.
+ * @return The index of the value's bucket.
+ */
+int LatencyHistogram::bucketIndex(int64_t value) {
+    if (value < 0) {
+        return 0;
+    }
+    if (value < (2 << SUB_BUCKET_BITS)) {
+        return static_cast<int>(value);
+    }
+    int highestBit = 63 - __builtin_clzll(static_cast<uint64_t>(value));
+    int shift = highestBit - SUB_BUCKET_BITS;
+    return (shift << SUB_BUCKET_BITS) + static_cast<int>(value >> shift);
+}
+
+
+/**
+ * Finds the highest value that is counted in a bucket. Used to report percentiles.
+ * @param index The index of the bucket.
+ * @return The highest value in the bucket.
+ */
+int64_t LatencyHistogram::bucketUpperValue(int index) {
+    if (index < (2 << SUB_BUCKET_BITS)) {
+        return index;
+    }
+    int shift = (index >> SUB_BUCKET_BITS) - 1;
+    int64_t subBucket = index - (shift << SUB_BUCKET_BITS);
+    int64_t lowerValue = subBucket << shift;
+    if (lowerValue > numeric_limits<int64_t>::max() - ((int64_t(1) << shift) - 1)) {
+        return numeric_limits<int64_t>::max();
+    }
+    return lowerValue + (int64_t(1) << shift) - 1;
+}
+
+
+/**
+ * Records one latency.
+ * @param nanoseconds The latency to record.
+ */
+void LatencyHistogram::record(int64_t nanoseconds) {
+    counts[bucketIndex(nanoseconds)]++;
+    totalCount++;
+    sum += nanoseconds;
+    if (nanoseconds < minValue) {
+        minValue = nanoseconds;
+    }
+    if (nanoseconds > maxValue) {
+        maxValue = nanoseconds;
+    }
+}
+
+
+/**
+ * Adds every value recorded in another histogram to this one.
+ * @param other The histogram to merge in.
+ */
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        counts[i] += other.counts[i];
+    }
+    totalCount += other.totalCount;
+    sum += other.sum;
+    if (other.minValue < minValue) {
+        minValue = other.minValue;
+    }
+    if (other.maxValue > maxValue) {
+        maxValue = other.maxValue;
+    }
+}
+
+
+/**
+ * Removes every recorded value.
+ */
+void LatencyHistogram::reset() {
+    counts.assign(BUCKET_COUNT, 0);
+    totalCount = 0;
+    minValue = numeric_limits<int64_t>::max();
+    maxValue = 0;
+    sum = 0;
+}
+
+
+uint64_t LatencyHistogram::count() const {
+    return totalCount;
+}
+
+
+int64_t LatencyHistogram::min() const {
+    return totalCount == 0 ? 0 : minValue;
+}
+
+
+int64_t LatencyHistogram::max() const {
+    return maxValue;
+}
+
+
+double LatencyHistogram::mean() const {
+    return totalCount == 0 ? 0 : sum / totalCount;
+}
+
+
+/**
+ * Finds the value below which a given percentage of the recorded values fall.
+ * @param percent The percentile to find, e.g. 99.9.
+ * @return The percentile, accurate to the width of its bucket. 0 if nothing has been recorded.
+ */
+int64_t LatencyHistogram::percentile(double percent) const {
+    if (totalCount == 0) {
+        return 0;
+    }
+
+    // Nearest rank: the smallest value with at least 'percent' of the values at or below it:
+    uint64_t targetRank = static_cast<uint64_t>(ceil(percent / 100.0 * totalCount));
+    if (targetRank < 1) {
+        targetRank = 1;
+    }
+
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        seen += counts[i];
+        if (seen >= targetRank) {
+            int64_t value = bucketUpperValue(i);
+            return value < maxValue ? value : maxValue; // The top bucket's bound can be above the real maximum.
+        }
+    }
+    return maxValue;
+}
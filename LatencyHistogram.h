@@ -0,0 +1,47 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_LATENCYHISTOGRAM_H
+#define COP3530_PROJECT_3_LATENCYHISTOGRAM_H
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+/**
+ * HDR-style histogram of latencies in nanoseconds.
+ * Values are counted in log-linear buckets: every power of two range is split into 64 equal sub-buckets, so any
+ * recorded value is known to within about 1.5% while the whole histogram stays a fixed size (about 30 KB).
+ * Recording is a couple of bit operations and an increment, so it is cheap enough to do on every operation.
+ */
+class LatencyHistogram {
+private:
+    static const int SUB_BUCKET_BITS = 6; // 2^6 = 64 sub-buckets per power of two.
+    static const int BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) << SUB_BUCKET_BITS; // Enough to cover every 64 bit value.
+
+    vector<uint64_t> counts; // Number of values recorded in each bucket.
+    uint64_t totalCount;
+    int64_t minValue;
+    int64_t maxValue;
+    double sum; // Sum of every recorded value, for the mean.
+
+    static int bucketIndex(int64_t value);
+    static int64_t bucketUpperValue(int index);
+public:
+    LatencyHistogram(); // ctr
+
+    void record(int64_t nanoseconds);
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    uint64_t count() const;
+    int64_t min() const;
+    int64_t max() const;
+    double mean() const;
+    int64_t percentile(double percent) const;
+};
+
+
+#endif //COP3530_PROJECT_3_LATENCYHISTOGRAM_H
@@ -0,0 +1,473 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <algorithm>
+#include <random>
+
+#include "LockFreeSkipList.h"
+
+/**
+ * Constructor. The node starts with all its links empty and both of its owners (see owners) still using it.
+ * @param song The song the node holds.
+ * @param height The number of levels the node can be linked into.
+ */
+LockFreeSkipList::Node::Node(Song song, int height) : val(move(song)), height(height), next(new atomic<uintptr_t>[height]),
+                                                      owners(2) {
+    for (int i = 0; i < height; i++) {
+        next[i].store(0, memory_order_relaxed);
+    }
+}
+
+
+/**
+ * Destructor.
+ */
+LockFreeSkipList::Node::~Node() {
+    delete[] next;
+}
+
+
+/**
+ * Constructor. Creates an empty list.
+ */
+LockFreeSkipList::LockFreeSkipList() : head(new Node(Song(), MAX_HEIGHT)), numElements(0) {
+}
+
+
+/**
+ * Destructor. Deletes every node still in the list. Nodes waiting to be reclaimed are deleted by the EpochManager.
+ * No other thread may be using the list.
+ */
+LockFreeSkipList::~LockFreeSkipList() {
+    Node* node = pointerOf(head->next[0].load());
+    while (node != nullptr) {
+        Node* next = pointerOf(node->next[0].load());
+        delete node;
+        node = next;
+    }
+    delete head;
+}
+
+
+/**
+ * Removes the mark from a link.
+ * @param link A link, marked or not.
+ * @return The node the link points to.
+ */
+LockFreeSkipList::Node* LockFreeSkipList::pointerOf(uintptr_t link) {
+    return reinterpret_cast<Node*>(link & ~static_cast<uintptr_t>(1));
+}
+
+
+/**
+ * Checks whether a link is marked, meaning the node it belongs to has been removed at that level.
+ * @param link A node's link.
+ * @return true if the link is marked, false otherwise.
+ */
+bool LockFreeSkipList::isMarked(uintptr_t link) {
+    return (link & 1) != 0;
+}
+
+
+/**
+ * Checks whether a song comes before a key in the list: a higher score, or the same score and a smaller track ID.
+ * @param song The song.
+ * @param score The key's score.
+ * @param name The key's track ID.
+ * @return true if the song comes first, false otherwise.
+ */
+bool LockFreeSkipList::comesBefore(const Song& song, int score, const string& name) {
+    return song.getScore() > score || (song.getScore() == score && song.getName() < name);
+}
+
+
+/**
+ * Deletes a node handed to the EpochManager.
+ * @param node The node.
+ */
+void LockFreeSkipList::deleteNode(void* node) {
+    delete static_cast<Node*>(node);
+}
+
+
+/**
+ * Picks the height of a new node. Each extra level is half as likely as the one below it.
+ * @return A height from 1 to MAX_HEIGHT.
+ */
+int LockFreeSkipList::randomHeight() {
+    static thread_local mt19937 random(random_device{}());
+    unsigned int bits = random();
+    int height = 1;
+    while (height < MAX_HEIGHT && (bits & 1) != 0) {
+        height++;
+        bits >>= 1;
+    }
+    return height;
+}
+
+
+/**
+ * Gets the first song after a node that has not been removed.
+ * @param node A node reached inside the current guard.
+ * @return The next node, or nullptr at the end of the list.
+ */
+LockFreeSkipList::Node* LockFreeSkipList::nextUnmarked(Node* node) {
+    Node* curr = pointerOf(node->next[0].load(memory_order_acquire));
+    while (curr != nullptr) {
+        uintptr_t succ = curr->next[0].load(memory_order_acquire);
+        if (!isMarked(succ)) {
+            break;
+        }
+        curr = pointerOf(succ);
+    }
+    return curr;
+}
+
+
+/**
+ * Finds where a key belongs on every level, unlinking any removed node it passes on the way.
+ * Must be called inside a guard.
+ * @param score The key's score.
+ * @param name The key's track ID.
+ * @param preds Populated with the last node before the key on each level (head if there is none).
+ * @param succs Populated with the first node at or after the key on each level (nullptr if there is none).
+ * @return true if a song with this exact key is in the list, false otherwise.
+ */
+bool LockFreeSkipList::find(int score, const string& name, Node** preds, Node** succs) {
+    while (true) {
+        bool restart = false;
+        Node* pred = head;
+        for (int level = MAX_HEIGHT - 1; level >= 0 && !restart; level--) {
+            Node* curr = pointerOf(pred->next[level].load(memory_order_acquire));
+            while (curr != nullptr) {
+                uintptr_t succ = curr->next[level].load(memory_order_acquire);
+                if (isMarked(succ)) {
+                    // curr has been removed at this level, so unlink it. If pred changed first, start again from the top:
+                    uintptr_t expected = reinterpret_cast<uintptr_t>(curr);
+                    if (!pred->next[level].compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(pointerOf(succ)))) {
+                        restart = true;
+                        break;
+                    }
+                    curr = pointerOf(succ);
+                }
+                else if (comesBefore(curr->val, score, name)) {
+                    pred = curr;
+                    curr = pointerOf(succ);
+                }
+                else {
+                    break;
+                }
+            }
+            preds[level] = pred;
+            succs[level] = curr;
+        }
+        if (!restart) {
+            Node* found = succs[0];
+            return found != nullptr && found->val.getScore() == score && found->val.getName() == name;
+        }
+    }
+}
+
+
+/**
+ * Finds the first song at or after a key without changing the list, so any number of readers can do this at once.
+ * Removed nodes are stepped over but never stopped on, so every node reached stays valid for as long as the guard.
+ * Must be called inside a guard.
+ * @param score The key's score.
+ * @param name The key's track ID. "" finds the first song with the score.
+ * @return The node, or nullptr if every song comes before the key.
+ */
+LockFreeSkipList::Node* LockFreeSkipList::firstAtOrAfter(int score, const string& name) const {
+    Node* pred = head;
+    Node* curr = nullptr;
+    for (int level = MAX_HEIGHT - 1; level >= 0; level--) {
+        curr = pointerOf(pred->next[level].load(memory_order_acquire));
+        while (curr != nullptr) {
+            uintptr_t succ = curr->next[level].load(memory_order_acquire);
+            if (isMarked(succ)) {
+                curr = pointerOf(succ);
+            }
+            else if (comesBefore(curr->val, score, name)) {
+                pred = curr;
+                curr = pointerOf(succ);
+            }
+            else {
+                break;
+            }
+        }
+    }
+    return curr;
+}
+
+
+/**
+ * Removes a node: marks its links from the top level down, then unlinks it. Only one thread can mark the bottom link,
+ * and that thread is the one that removed the song. Must be called inside a guard.
+ * @param node The node to remove.
+ * @return true if this call removed the song, false if another thread removed it first.
+ */
+bool LockFreeSkipList::removeNode(Node* node) {
+    for (int level = node->height - 1; level > 0; level--) {
+        uintptr_t link = node->next[level].load();
+        while (!isMarked(link) && !node->next[level].compare_exchange_weak(link, link | 1)) {
+        }
+    }
+    uintptr_t link = node->next[0].load();
+    while (true) {
+        if (isMarked(link)) {
+            return false;
+        }
+        if (node->next[0].compare_exchange_weak(link, link | 1)) {
+            break;
+        }
+    }
+    numElements.fetch_sub(1);
+
+    // Unlink it from every level it is on:
+    Node* preds[MAX_HEIGHT];
+    Node* succs[MAX_HEIGHT];
+    find(node->val.getScore(), node->val.getName(), preds, succs);
+    releaseNode(node);
+    return true;
+}
+
+
+/**
+ * Gives up one owner's use of a node that has been removed. The last owner retires it.
+ * @param node The node.
+ */
+void LockFreeSkipList::releaseNode(Node* node) {
+    if (node->owners.fetch_sub(1) == 1) {
+        epoch.retire(node, deleteNode);
+    }
+}
+
+
+void LockFreeSkipList::build(vector<Song>& inputSongs) {
+    for (unsigned int i = 0; i < inputSongs.size(); i++) {
+        insert(inputSongs.at(i));
+    }
+}
+
+
+/**
+ * Removes the first song in the list, which has the highest score.
+ * @return A copy of the Song that was removed, or an empty Song if the list is empty.
+ */
+Song LockFreeSkipList::extractMax() {
+    EpochGuard guard(epoch);
+    while (true) {
+        Node* first = nextUnmarked(head);
+        if (first == nullptr) {
+            return Song();
+        }
+        if (removeNode(first)) {
+            return first->val; // Still allocated until the guard ends.
+        }
+    }
+}
+
+
+Song LockFreeSkipList::peekMax() {
+    EpochGuard guard(epoch);
+    Node* first = nextUnmarked(head);
+    return first == nullptr ? Song() : first->val;
+}
+
+
+/**
+ * Searches for a song by score. Never changes the list.
+ * @param targetScore The score to search for.
+ * @return A copy of the Song with the score and the smallest track ID, or an empty Song if no song has the score.
+ */
+Song LockFreeSkipList::search(int targetScore) {
+    EpochGuard guard(epoch);
+    Node* node = firstAtOrAfter(targetScore, "");
+    if (node != nullptr && node->val.getScore() == targetScore) {
+        return node->val;
+    }
+    return Song();
+}
+
+
+/**
+ * Inserts a song. The song is in the list as soon as it is linked into the bottom level; the levels above only speed
+ * up searches, so they are linked afterwards, giving up if the song is removed in the meantime.
+ * @param song The song to insert. Nothing happens if a song with the same score and track ID is already in the list.
+ */
+void LockFreeSkipList::insert(Song song) {
+    EpochGuard guard(epoch);
+    Node* node = new Node(move(song), randomHeight());
+    const Song& key = node->val;
+    Node* preds[MAX_HEIGHT];
+    Node* succs[MAX_HEIGHT];
+
+    while (true) {
+        if (find(key.getScore(), key.getName(), preds, succs)) {
+            delete node; // Never linked, so no other thread can have seen it.
+            return;
+        }
+        for (int level = 0; level < node->height; level++) {
+            node->next[level].store(reinterpret_cast<uintptr_t>(succs[level]), memory_order_relaxed);
+        }
+        uintptr_t expected = reinterpret_cast<uintptr_t>(succs[0]);
+        if (preds[0]->next[0].compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(node))) {
+            break;
+        }
+    }
+    numElements.fetch_add(1);
+
+    // Link the levels above:
+    bool linking = true;
+    for (int level = 1; level < node->height && linking; level++) {
+        while (true) {
+            uintptr_t expected = reinterpret_cast<uintptr_t>(succs[level]);
+            if (preds[level]->next[level].compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(node))) {
+                break;
+            }
+            // The neighbours changed. Find them again and point the node at its new successor, unless it was removed:
+            uintptr_t link = node->next[level].load();
+            if (!find(key.getScore(), key.getName(), preds, succs) || isMarked(link)
+                || !node->next[level].compare_exchange_strong(link, reinterpret_cast<uintptr_t>(succs[level]))) {
+                linking = false;
+                break;
+            }
+        }
+    }
+
+    // If the song was removed while its levels were being linked, the remover may have missed a level linked after
+    // it looked, so unlink it once more:
+    if (isMarked(node->next[0].load())) {
+        find(key.getScore(), key.getName(), preds, succs);
+    }
+    releaseNode(node);
+}
+
+
+/**
+ * Removes a song by track ID. The list is ordered by score, so every song is checked until the name is found.
+ * Use removeKey() when the score is known.
+ * @param songName The track ID of the song to remove.
+ * @param removed If not nullptr, receives a copy of the song that was removed.
+ * @return true if the song was found and removed, false otherwise.
+ */
+bool LockFreeSkipList::remove(string songName, Song* removed) {
+    EpochGuard guard(epoch);
+    for (Node* node = nextUnmarked(head); node != nullptr; node = nextUnmarked(node)) {
+        if (node->val.getName() == songName) {
+            if (!removeNode(node)) {
+                return false;
+            }
+            if (removed != nullptr) {
+                *removed = node->val; // Still safe to read: the guard keeps the node from being freed.
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * Removes a song by its score and track ID, which takes a search rather than a scan of the whole list.
+ * @param score The song's score.
+ * @param songName The song's track ID.
+ * @return true if the song was found and removed, false otherwise.
+ */
+bool LockFreeSkipList::removeKey(int score, const string& songName) {
+    EpochGuard guard(epoch);
+    Node* node = firstAtOrAfter(score, songName);
+    if (node == nullptr || node->val.getScore() != score || node->val.getName() != songName) {
+        return false;
+    }
+    return removeNode(node);
+}
+
+
+/**
+ * Searches for one song per score in a range. Each song found leads straight to the next lower score with one more
+ * search, so songs that share a score are skipped rather than walked over. Never changes the list.
+ * @param lowerBound The minimum score to search for.
+ * @param upperBound The maximum score to search for.
+ * @return The songs that were found, in ascending order of score. Scores with no song are left out.
+ */
+vector<Song> LockFreeSkipList::searchRange(int lowerBound, int upperBound) {
+    vector<Song> results;
+    EpochGuard guard(epoch);
+    Node* node = firstAtOrAfter(upperBound, "");
+    while (node != nullptr && node->val.getScore() >= lowerBound) {
+        results.push_back(node->val);
+        if (node->val.getScore() == lowerBound) {
+            break;
+        }
+        node = firstAtOrAfter(node->val.getScore() - 1, "");
+    }
+    reverse(results.begin(), results.end()); // The list runs from high to low scores.
+    return results;
+}
+
+
+/**
+ * Gets the highest scoring songs without removing them.
+ * @param n The number of songs to get.
+ * @return Up to n songs, highest score first.
+ */
+vector<Song> LockFreeSkipList::top(int n) {
+    vector<Song> results;
+    EpochGuard guard(epoch);
+    for (Node* node = nextUnmarked(head); node != nullptr && static_cast<int>(results.size()) < n; node = nextUnmarked(node)) {
+        results.push_back(node->val);
+    }
+    return results;
+}
+
+
+/**
+ * Gets the number of songs. With other threads running, this is only a snapshot.
+ * @return The number of songs.
+ */
+int LockFreeSkipList::size() {
+    return numElements.load();
+}
+
+
+/**
+ * Measures the memory used by the songs in the list and the head node. Removed nodes waiting to be reclaimed are not
+ * counted.
+ * @return The breakdown of the container's memory.
+ */
+MemoryUsage LockFreeSkipList::memoryUsage() {
+    MemoryUsage usage;
+    EpochGuard guard(epoch);
+    for (Node* node = head; node != nullptr; node = nextUnmarked(node)) {
+        if (node != head) {
+            usage.songCount++;
+            usage.addString(node->val.getName());
+        }
+        usage.structureBytes += sizeof(Node) + node->height * sizeof(atomic<uintptr_t>);
+        usage.addAllocation(sizeof(Node));
+        usage.addAllocation(node->height * sizeof(atomic<uintptr_t>));
+    }
+    return usage;
+}
+
+
+/**
+ * Copies every song in the list. With other threads running, songs inserted or removed meanwhile may or may not be
+ * included.
+ * @return The songs, highest score first.
+ */
+vector<Song> LockFreeSkipList::toVector() {
+    vector<Song> songs;
+    EpochGuard guard(epoch);
+    for (Node* node = nextUnmarked(head); node != nullptr; node = nextUnmarked(node)) {
+        songs.push_back(node->val);
+    }
+    return songs;
+}
+
+
+bool LockFreeSkipList::isThreadSafe() {
+    return true;
+}
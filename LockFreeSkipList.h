@@ -0,0 +1,88 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_LOCKFREESKIPLIST_H
+#define COP3530_PROJECT_3_LOCKFREESKIPLIST_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "EpochManager.h"
+#include "Song.h"
+#include "SongContainer.h"
+
+using namespace std;
+
+/**
+ * A skip list that any number of threads can read and change at once without taking a lock.
+ *
+ * Songs are kept in order of score, highest first, with ties ordered by track ID, so the highest scoring song is
+ * always the first one and a range of scores is one contiguous run. Every link is changed with a compare-and-swap.
+ * A song is removed in two steps: first its links are marked (the lowest bit of each pointer), which removes it
+ * logically, then it is unlinked by whichever thread next passes it. Unlinked nodes are deleted through an
+ * EpochManager, once no thread can still be reading them.
+ *
+ * Songs are keyed by score and track ID together, so inserting a song that is already in the list does nothing.
+ */
+class LockFreeSkipList : public SongContainer {
+private:
+    static const int MAX_HEIGHT = 24; // Enough levels for about 16 million songs.
+
+    /**
+     * A song and its links. A node of height h is linked into levels 0 to h - 1.
+     */
+    struct Node {
+        Song val;
+        int height;
+        atomic<uintptr_t>* next; // One link per level. The lowest bit marks the node as removed at that level.
+
+        // Removing a node needs both the thread that inserted it and the thread that removed it to be done with it.
+        // Whichever finishes last retires the node:
+        atomic<int> owners;
+
+        Node(Song song, int height); // ctr
+        ~Node(); // dtr
+    };
+
+    Node* head; // Sentinel of full height before the first song. The end of every level is nullptr.
+    atomic<int> numElements;
+    mutable EpochManager epoch;
+
+    static Node* pointerOf(uintptr_t link);
+    static bool isMarked(uintptr_t link);
+    static bool comesBefore(const Song& song, int score, const string& name);
+    static void deleteNode(void* node);
+    static int randomHeight();
+    static Node* nextUnmarked(Node* node);
+
+    bool find(int score, const string& name, Node** preds, Node** succs);
+    Node* firstAtOrAfter(int score, const string& name) const;
+    bool removeNode(Node* node);
+    void releaseNode(Node* node);
+
+public:
+    LockFreeSkipList(); // ctr
+    virtual ~LockFreeSkipList(); // dtr
+
+    // Overridden functions. See the .cpp implementation file:
+    virtual void build(vector<Song>& inputSongs);
+    virtual Song extractMax();
+    virtual Song peekMax();
+    virtual Song search(int targetScore);
+    virtual void insert(Song song);
+    virtual bool remove(string songName, Song* removed = nullptr);
+    virtual bool removeKey(int score, const string& songName);
+    virtual int size();
+    virtual MemoryUsage memoryUsage();
+    virtual vector<Song> toVector();
+    virtual bool isThreadSafe();
+
+    vector<Song> searchRange(int lowerBound, int upperBound);
+    vector<Song> top(int n);
+};
+
+
+#endif //COP3530_PROJECT_3_LOCKFREESKIPLIST_H
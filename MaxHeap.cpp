@@ -2,8 +2,25 @@
 // Created by adria on 7/30/2021.
 //
 
+#include <algorithm>
 #include <iostream>
+#include <utility>
 #include "MaxHeap.h"
+#include "ParallelBuild.h"
+
+/**
+ * Compares the scores of the songs at two positions of the heap. Counted in statistics builds.
+ * @param first The position of the first song.
+ * @param second The position of the second song.
+ * @return true if the first song has a lower score than the second.
+ */
+bool MaxHeap::isLower(int first, int second) {
+#ifdef MAXHEAP_STATS
+    stats.comparisons++;
+#endif
+    return songs.at(first) < songs.at(second);
+}
+
 
 /**
  * Swap elements down the heap to move the Song at startPos down to its correct position.
@@ -14,16 +31,21 @@ void MaxHeap::adjustHeapDown(int startPos) {
     int current = startPos;
     int left = (current * 2) + 1;
     int right = (current * 2) + 2;
+#ifdef MAXHEAP_STATS
+    stats.siftDownCalls++;
+#endif
 
     // Iterate through the heap from the top until either we reach the end, or the right and left children are both smaller than current.
-    while( (left < songs.size() && songs.at(current) < songs.at(left) ) ||
-           (right < songs.size() && songs.at(current) < songs.at(right) )) {
-        if (right < songs.size() && songs.at(left) < songs.at(right)) { // If right child exists and is the larger value:
+    while( (left < songs.size() && isLower(current, left) ) ||
+           (right < songs.size() && isLower(current, right) )) {
+#ifdef MAXHEAP_STATS
+        stats.moves += 3; // One swap, either way.
+        stats.siftDownLevels++;
+#endif
+        if (right < songs.size() && isLower(left, right)) { // If right child exists and is the larger value:
 
-            // Swap Song at current with its right child:
-            Song temp = songs.at(right);
-            songs.at(right) = songs.at(current);
-            songs.at(current) = temp;
+            // Swap Song at current with its right child. swap() moves the names instead of copying them, so it never allocates:
+            swap(songs.at(right), songs.at(current));
 
             // Update index trackers:
             current = right;
@@ -33,9 +55,7 @@ void MaxHeap::adjustHeapDown(int startPos) {
         else { // if right child does not exist of if left child is larger than right child:
 
             // Swap Song at current with its left child:
-            Song temp = songs.at(left);
-            songs.at(left) = songs.at(current);
-            songs.at(current) = temp;
+            swap(songs.at(left), songs.at(current));
 
             // Update index trackers:
             current = left;
@@ -53,13 +73,18 @@ void MaxHeap::adjustHeapUp(int startPos) {
     // Initialize index trackers:
     int current = startPos;
     int parent = (current - 1) / 2; // integer division ensures that this index is correct.
+#ifdef MAXHEAP_STATS
+    stats.siftUpCalls++;
+#endif
 
-    while (current > 0 && songs.at(parent) < songs.at(current)) { // while current is not at top and heap layout is invalid:
+    while (current > 0 && isLower(parent, current)) { // while current is not at top and heap layout is invalid:
+#ifdef MAXHEAP_STATS
+        stats.moves += 3;
+        stats.siftUpLevels++;
+#endif
 
         // Swap Song at current with its parent:
-        Song temp = songs.at(parent);
-        songs.at(parent) = songs.at(current);
-        songs.at(current) = temp;
+        swap(songs.at(parent), songs.at(current));
 
         // Update index trackers:
         current = parent;
@@ -73,13 +98,87 @@ void MaxHeap::adjustHeapUp(int startPos) {
 MaxHeap::MaxHeap() : numElements(0) {}
 
 /**
- * Builds the MaxHeap from the songs in a vector.
+ * Restores the heap layout in the subtree below a position, bottom-up (Floyd's method): every node is sifted down
+ * after both of its subtrees are already heaps. Each level of the subtree is a contiguous run of the array.
+ * @param subtreeRoot The position of the subtree's root.
+ */
+void MaxHeap::heapifySubtree(int subtreeRoot) {
+    int size = songs.size();
+
+    // Find the deepest level of the subtree that has a node with children:
+    int depth = 0;
+    while ((static_cast<long long>(subtreeRoot) + 1) * (2LL << depth) - 1 < size) {
+        depth++;
+    }
+    for (; depth >= 0; depth--) {
+        long long first = (static_cast<long long>(subtreeRoot) + 1) * (1LL << depth) - 1;
+        long long last = min(first + (1LL << depth), static_cast<long long>(size));
+        for (long long i = last - 1; i >= first; i--) {
+            adjustHeapDown(static_cast<int>(i));
+        }
+    }
+}
+
+/**
+ * Builds the MaxHeap from the songs in a vector, adding them to any songs already in the heap.
+ * The songs are copied in, then the whole array is put in heap order in linear time, rather than sifting up each song.
+ * Large builds do both on several threads: the subtrees a few levels below the root share no positions, so each
+ * thread heapifies some of them, and the few levels above are then done on their own.
  * @param songs A vector containing the songs to be used for building the MaxHeap.
  */
 void MaxHeap::build(vector<Song>& inputSongs) {
-    for (int i = inputSongs.size() - 1; i > -1; i--) {
-        this->insert(inputSongs.at(i));
+    int threadCount = parallelBuildThreads(inputSongs.size());
+#ifdef MAXHEAP_STATS
+    threadCount = 1; // The counters are not atomic.
+#endif
+
+    // Copy the songs in. Every name is copied, so this is split across the threads too:
+    size_t firstNew = songs.size();
+    songs.resize(firstNew + inputSongs.size());
+    parallelFor(threadCount, inputSongs.size(), [this, &inputSongs, firstNew](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) {
+            songs.at(firstNew + i) = inputSongs.at(i);
+        }
+    });
+    numElements = songs.size();
+
+    // Pick the level whose subtrees are heapified in parallel, with a few subtrees per thread to balance the load:
+    int subtreeCount = 1;
+    while (subtreeCount < threadCount * 4 && subtreeCount * 2 - 1 < numElements / 2) {
+        subtreeCount *= 2;
+    }
+    int firstSubtree = subtreeCount - 1;
+    parallelFor(threadCount, subtreeCount, [this, firstSubtree](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) {
+            heapifySubtree(firstSubtree + static_cast<int>(i));
+        }
+    });
+    for (int i = firstSubtree - 1; i >= 0; i--) {
+        adjustHeapDown(i);
+    }
+}
+
+/**
+ * Gets the highest scoring song without removing it.
+ * @return A copy of the Song object at the top of the heap, or an empty Song if the heap is empty.
+ */
+Song MaxHeap::peekMax() {
+    if (songs.empty()) {
+        return Song();
+    }
+    return songs.front();
+}
+
+/**
+ * Gets the highest score in the heap without copying the song that has it.
+ * @param emptyScore The value to return if the heap is empty.
+ * @return The score of the song at the top of the heap, or emptyScore if the heap is empty.
+ */
+int MaxHeap::peekMaxScore(int emptyScore) const {
+    if (songs.empty()) {
+        return emptyScore;
     }
+    return songs.front().getScore();
 }
 
 /**
@@ -87,9 +186,14 @@ void MaxHeap::build(vector<Song>& inputSongs) {
  * @return A copy of the Song object that was removed.
  */
 Song MaxHeap::extractMax() {
-    Song output = songs.front();
-    songs.front() = songs.back();
+    Song output = move(songs.front()); // The song is leaving the heap, so its name can be moved out instead of copied.
+    if (songs.size() > 1) {
+        songs.front() = move(songs.back());
+    }
     songs.pop_back();
+#ifdef MAXHEAP_STATS
+    stats.moves++;
+#endif
     numElements--;
     adjustHeapDown(0);
     return output;
@@ -102,11 +206,20 @@ Song MaxHeap::extractMax() {
  * @return A copy of the song object found by the search.
  */
 Song MaxHeap::search(int targetScore) {
+#ifdef MAXHEAP_STATS
+    stats.searchCalls++;
+#endif
     for (unsigned int i = 0; i < songs.size(); i++) {
         if (songs.at(i).getScore() == targetScore) {
+#ifdef MAXHEAP_STATS
+            stats.searchScanned += i + 1;
+#endif
             return songs.at(i);
         }
     }
+#ifdef MAXHEAP_STATS
+    stats.searchScanned += songs.size();
+#endif
     return Song(); // If song not found with the target value, then return an empty Song object.
 }
 
@@ -116,38 +229,167 @@ Song MaxHeap::search(int targetScore) {
  * @param song The new Song object to be inserted
  */
 void MaxHeap::insert(Song song) {
-    songs.push_back(song); // Add song to last position of heap.
+    songs.push_back(move(song)); // Add song to last position of heap. 'song' is already a copy, so it can be moved in.
     numElements++;
+#ifdef MAXHEAP_STATS
+    stats.moves++;
+#endif
     adjustHeapUp(songs.size() - 1);
 }
 
+/**
+ * Remove the Song at a position of the array.
+ * @param position The index of the Song to be removed.
+ */
+void MaxHeap::removeAt(unsigned int position) {
+#ifdef MAXHEAP_STATS
+    stats.removeScanned += position + 1;
+    stats.moves++;
+#endif
+    // Move the last element of the heap to replace the element being removed and then adjust as needed.
+    // The last element comes from another branch of the heap, so it can belong above the position as well as below it:
+    if (position + 1 < songs.size()) {
+        songs.at(position) = move(songs.back());
+    }
+    songs.pop_back();
+    if (position < songs.size()) {
+        adjustHeapUp(position);
+        adjustHeapDown(position);
+    }
+    numElements--;
+}
+
 /**
  * Remove a Song by name.
  * @param songName The name of the Song object to be removed.
+ * @param removed If not nullptr, receives a copy of the Song that was removed.
  * @return true if the song was found and removed, false otherwise.
  */
-bool MaxHeap::remove(string songName) {
+bool MaxHeap::remove(string songName, Song* removed) {
+#ifdef MAXHEAP_STATS
+    stats.removeCalls++;
+#endif
     for(unsigned int i = 0; i < songs.size(); i++) {
         if(songs.at(i).getName() == songName) { // If we have found the song with name 'songName':
-            // Move the last element of the heap to replace the element being removed and then adjust downwards as needed:
-            songs.at(i) = songs.back();
-            songs.pop_back();
-            adjustHeapDown(i);
-            numElements--;
+            if (removed != nullptr) {
+                *removed = songs.at(i);
+            }
+            removeAt(i);
             return true;
         }
     }
+#ifdef MAXHEAP_STATS
+    stats.removeScanned += songs.size();
+#endif
     return false; // If execution reaches here, then the song was not found by the iteration, so return false.
 }
 
+/**
+ * Remove the Song with both the given score and name. The heap is not ordered by name, so this is a scan like remove().
+ * @param score The score of the Song object to be removed.
+ * @param songName The name of the Song object to be removed.
+ * @return true if the song was found and removed, false otherwise.
+ */
+bool MaxHeap::removeKey(int score, const string& songName) {
+#ifdef MAXHEAP_STATS
+    stats.removeCalls++;
+#endif
+    for(unsigned int i = 0; i < songs.size(); i++) {
+        if(songs.at(i).getScore() == score && songs.at(i).getName() == songName) {
+            removeAt(i);
+            return true;
+        }
+    }
+#ifdef MAXHEAP_STATS
+    stats.removeScanned += songs.size();
+#endif
+    return false;
+}
+
 int MaxHeap::size() {
     return numElements;
 }
 
+/**
+ * Measures the memory used by the heap. The array never shrinks, so its unused capacity is reported as slack.
+ * @return The breakdown of the heap's memory.
+ */
+MemoryUsage MaxHeap::memoryUsage() {
+    MemoryUsage usage;
+    usage.songCount = songs.size();
+    usage.structureBytes = songs.size() * sizeof(Song);
+    usage.slackBytes = (songs.capacity() - songs.size()) * sizeof(Song);
+    if (songs.capacity() > 0) {
+        usage.addAllocation(songs.capacity() * sizeof(Song)); // The whole array is a single allocation.
+    }
+    for (unsigned int i = 0; i < songs.size(); i++) {
+        usage.addString(songs.at(i).getName());
+    }
+    return usage;
+}
+
+vector<Song> MaxHeap::toVector() {
+    return songs;
+}
+
 // DEBUG:
 void MaxHeap::print() {
     for (int i = 0; i < songs.size(); i++) {
         std::cout << songs.at(i).getName() << ": " << songs.at(i).getScore() << ", ";
     }
     std::cout << std::endl;
-}
\ No newline at end of file
+}
+
+#ifdef MAXHEAP_STATS
+// Statistics:
+// ===========
+
+/**
+ * Constructor. Every counter starts at 0.
+ */
+MaxHeapStats::MaxHeapStats() : comparisons(0), moves(0), siftUpCalls(0), siftUpLevels(0), siftDownCalls(0), siftDownLevels(0),
+                               searchCalls(0), searchScanned(0), removeCalls(0), removeScanned(0) {}
+
+
+/**
+ * Gets the counters collected so far.
+ * @return The heap's statistics.
+ */
+const MaxHeapStats& MaxHeap::getStats() const {
+    return stats;
+}
+
+
+/**
+ * Sets every counter back to 0, e.g. to measure only the operations after the initial build.
+ */
+void MaxHeap::resetStats() {
+    stats = MaxHeapStats();
+}
+
+
+/**
+ * Prints the counters, with averages per call where they help compare heap layouts.
+ * @param output Where to print the statistics.
+ */
+void MaxHeap::printStats(ostream& output) {
+    output << "Comparisons: " << stats.comparisons << ", moves: " << stats.moves << endl;
+    if (stats.siftUpCalls > 0) {
+        output << "Sift up: " << stats.siftUpCalls << " calls, " << stats.siftUpLevels << " levels ("
+               << static_cast<double>(stats.siftUpLevels) / stats.siftUpCalls << " per call)" << endl;
+    }
+    if (stats.siftDownCalls > 0) {
+        output << "Sift down: " << stats.siftDownCalls << " calls, " << stats.siftDownLevels << " levels ("
+               << static_cast<double>(stats.siftDownLevels) / stats.siftDownCalls << " per call)" << endl;
+    }
+    if (stats.searchCalls > 0) {
+        output << "search: " << stats.searchCalls << " calls, " << stats.searchScanned << " songs scanned ("
+               << static_cast<double>(stats.searchScanned) / stats.searchCalls << " per call)" << endl;
+    }
+    if (stats.removeCalls > 0) {
+        output << "remove: " << stats.removeCalls << " calls, " << stats.removeScanned << " songs scanned ("
+               << static_cast<double>(stats.removeScanned) / stats.removeCalls << " per call)" << endl;
+    }
+    output << "Heap size: " << songs.size() << " songs in a capacity of " << songs.capacity() << endl;
+}
+#endif
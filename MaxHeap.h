@@ -10,29 +10,78 @@
 #include "Song.h"
 #include "SongContainer.h"
 
+#ifdef MAXHEAP_STATS
+#include <ostream>
+#endif
+
 using namespace std;
 
+#ifdef MAXHEAP_STATS
+/**
+ * Counters of the work the heap has done since it was created or the stats were last reset.
+ * Only compiled in when MAXHEAP_STATS is defined (make STATS=1), so normal builds pay nothing for them.
+ */
+struct MaxHeapStats {
+    unsigned long long comparisons; // Score comparisons made while restoring the heap layout.
+    unsigned long long moves; // Songs copied into a heap slot. A swap is three moves.
+
+    // Calls to the sift helpers and the number of levels each moved a song:
+    unsigned long long siftUpCalls;
+    unsigned long long siftUpLevels;
+    unsigned long long siftDownCalls;
+    unsigned long long siftDownLevels;
+
+    // search() and remove() scan the array in level order:
+    unsigned long long searchCalls;
+    unsigned long long searchScanned;
+    unsigned long long removeCalls;
+    unsigned long long removeScanned;
+
+    MaxHeapStats(); // ctr
+};
+#endif
+
 class MaxHeap : public SongContainer {
 private:
     vector<Song> songs; // Dynamic array representation of heap is used.
     int numElements; // Keep track of the number of elements.
 
+#ifdef MAXHEAP_STATS
+    MaxHeapStats stats;
+#endif
+
     // Helper methods to correct the heap layout during insertion and removal operations:
+    bool isLower(int first, int second);
     void adjustHeapDown(int startPos);
     void adjustHeapUp(int startPos);
+    void heapifySubtree(int subtreeRoot);
+    void removeAt(unsigned int position);
 public:
     MaxHeap(); // ctr:
 
     // Overridden functions. See the .cpp implementation file:
     virtual void build(vector<Song>& inputSongs);
     virtual Song extractMax();
+    virtual Song peekMax();
     virtual Song search(int targetScore);
     virtual void insert(Song song);
-    virtual bool remove(string songName);
+    virtual bool remove(string songName, Song* removed = nullptr);
+    virtual bool removeKey(int score, const string& songName);
     virtual int size();
+    virtual MemoryUsage memoryUsage();
+    virtual vector<Song> toVector();
+
+    int peekMaxScore(int emptyScore) const;
 
     // Method not used in program, but is implemented in the .cpp file:
     void print();
+
+#ifdef MAXHEAP_STATS
+    // Statistics. See the .cpp implementation file:
+    const MaxHeapStats& getStats() const;
+    void resetStats();
+    void printStats(ostream& output);
+#endif
 };
 
 
@@ -0,0 +1,99 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <iomanip>
+#include <sstream>
+
+#include "MemoryUsage.h"
+
+/**
+ * Constructor. Every count starts at 0.
+ */
+MemoryUsage::MemoryUsage() : songCount(0), structureBytes(0), stringHeapBytes(0), slackBytes(0), allocatorOverheadBytes(0),
+                             allocationCount(0) {}
+
+
+/**
+ * Estimates the bytes an allocator uses on top of a request. Modelled on glibc malloc, which adds an 8 byte header
+ * and rounds every chunk up to a multiple of 16 bytes, with a minimum of 32. Other allocators are similar in size.
+ * @param bytes The number of bytes requested.
+ * @return The estimated extra bytes used by the allocation.
+ */
+size_t estimateAllocationOverhead(size_t bytes) {
+    size_t chunk = (bytes + 8 + 15) & ~static_cast<size_t>(15);
+    if (chunk < 32) {
+        chunk = 32;
+    }
+    return chunk - bytes;
+}
+
+
+/**
+ * Adds the heap buffer of a string, if it has one. Short strings are stored inside the string object itself
+ * (already counted with the object), so only strings longer than that capacity allocate. Every track ID is.
+ * @param text The string.
+ */
+void MemoryUsage::addString(const string& text) {
+    static const size_t inlineCapacity = string().capacity(); // Capacity of a string that has not allocated.
+    if (text.capacity() > inlineCapacity) {
+        size_t bytes = text.capacity() + 1; // Plus the null terminator.
+        stringHeapBytes += bytes;
+        allocatorOverheadBytes += estimateAllocationOverhead(bytes);
+        allocationCount++;
+    }
+}
+
+
+/**
+ * Adds the allocator overhead of one allocation. The bytes themselves are counted by the caller.
+ * @param bytes The size of the allocation.
+ */
+void MemoryUsage::addAllocation(size_t bytes) {
+    allocatorOverheadBytes += estimateAllocationOverhead(bytes);
+    allocationCount++;
+}
+
+
+/**
+ * Gets the total of every category.
+ * @return The total bytes.
+ */
+size_t MemoryUsage::totalBytes() const {
+    return structureBytes + stringHeapBytes + slackBytes + allocatorOverheadBytes;
+}
+
+
+/**
+ * Prints the breakdown, with each category per song.
+ * @param output Where to print the breakdown.
+ */
+void MemoryUsage::print(ostream& output) const {
+    const char* names[] = {"Nodes/array", "String heap", "Slack capacity", "Allocator overhead (est.)", "Total"};
+    size_t values[] = {structureBytes, stringHeapBytes, slackBytes, allocatorOverheadBytes, totalBytes()};
+
+    output << left << setw(27) << "category" << right << setw(16) << "bytes" << setw(16) << "bytes/song" << endl;
+    output << fixed << setprecision(1);
+    for (int i = 0; i < 5; i++) {
+        output << left << setw(27) << names[i] << right << setw(16) << values[i];
+        if (songCount > 0) {
+            output << setw(16) << static_cast<double>(values[i]) / songCount;
+        }
+        output << endl;
+    }
+    output << defaultfloat << setprecision(6);
+    output << songCount << " songs in " << allocationCount << " heap allocations." << endl;
+}
+
+
+/**
+ * Summarises the breakdown on a single line, for machine-readable output.
+ * @return Entries like "songs=10,structure=480,strings=320,slack=0,overhead=260,total=1060".
+ */
+string MemoryUsage::summary() const {
+    ostringstream output;
+    output << "songs=" << songCount << ",structure=" << structureBytes << ",strings=" << stringHeapBytes << ",slack="
+           << slackBytes << ",overhead=" << allocatorOverheadBytes << ",total=" << totalBytes() << ",allocations="
+           << allocationCount;
+    return output.str();
+}
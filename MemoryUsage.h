@@ -0,0 +1,38 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_MEMORYUSAGE_H
+#define COP3530_PROJECT_3_MEMORYUSAGE_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+using namespace std;
+
+/**
+ * Breakdown of the memory a container is using, in bytes.
+ * The allocator overhead is an estimate (see estimateAllocationOverhead), everything else is exact.
+ */
+struct MemoryUsage {
+    size_t songCount; // Number of songs in the container.
+    size_t structureBytes; // Nodes or array slots that hold songs, including the Song objects themselves.
+    size_t stringHeapBytes; // Heap buffers of song names too long for the small string optimization.
+    size_t slackBytes; // Capacity reserved but not holding songs (e.g. unused vector capacity).
+    size_t allocatorOverheadBytes; // Estimated headers and padding the allocator adds to every allocation.
+    size_t allocationCount; // Number of separate heap allocations.
+
+    MemoryUsage(); // ctr
+
+    void addString(const string& text);
+    void addAllocation(size_t bytes);
+    size_t totalBytes() const;
+    void print(ostream& output) const;
+    string summary() const;
+};
+
+size_t estimateAllocationOverhead(size_t bytes);
+
+
+#endif //COP3530_PROJECT_3_MEMORYUSAGE_H
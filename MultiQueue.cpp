@@ -0,0 +1,311 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <climits>
+#include <functional>
+#include <random>
+#include <thread>
+
+#include "MultiQueue.h"
+
+const int MultiQueue::EMPTY_QUEUE = INT_MIN;
+
+/**
+ * Constructor.
+ * @param queueCount The number of heaps. Values below 1 are treated as 1.
+ */
+MultiQueue::MultiQueue(int queueCount) : numElements(0) {
+    if (queueCount < 1) {
+        queueCount = 1;
+    }
+    for (int i = 0; i < queueCount; i++) {
+        Queue* queue = new Queue();
+        queue->topScore.store(EMPTY_QUEUE, memory_order_relaxed);
+        queues.push_back(queue);
+    }
+}
+
+
+/**
+ * Destructor. Deletes every heap and the songs in it.
+ */
+MultiQueue::~MultiQueue() {
+    for (unsigned int i = 0; i < queues.size(); i++) {
+        delete queues.at(i);
+    }
+}
+
+
+/**
+ * Picks a heap at random. Every thread has its own generator, so picking never contends.
+ * @return The index of the heap.
+ */
+unsigned int MultiQueue::randomQueue() const {
+    static thread_local minstd_rand random(static_cast<unsigned int>(hash<thread::id>()(this_thread::get_id())));
+    return random() % queues.size();
+}
+
+
+/**
+ * Finds the heap with the highest top score by reading every heap's copy of it, without taking any lock.
+ * @return The index of the heap, or -1 if every heap looked empty.
+ */
+int MultiQueue::bestQueue() const {
+    int best = -1;
+    int bestScore = EMPTY_QUEUE;
+    for (unsigned int i = 0; i < queues.size(); i++) {
+        int score = queues.at(i)->topScore.load(memory_order_relaxed);
+        if (score > bestScore) {
+            best = static_cast<int>(i);
+            bestScore = score;
+        }
+    }
+    return best;
+}
+
+
+/**
+ * Copies a heap's top score to where other threads can read it without the lock.
+ * @param queue The heap that changed. Its lock must be held.
+ */
+void MultiQueue::updateTopScore(Queue* queue) {
+    queue->topScore.store(queue->heap.peekMaxScore(EMPTY_QUEUE), memory_order_relaxed);
+}
+
+
+/**
+ * Builds the heaps from a set of songs, dealing the songs out to the heaps in turn.
+ * @param inputSongs The songs to populate the container with.
+ */
+void MultiQueue::build(vector<Song>& inputSongs) {
+    vector<vector<Song>> queueSongs(queues.size());
+    for (unsigned int i = 0; i < queueSongs.size(); i++) {
+        queueSongs.at(i).reserve(inputSongs.size() / queues.size() + 1);
+    }
+    for (unsigned int i = 0; i < inputSongs.size(); i++) {
+        queueSongs.at(i % queues.size()).push_back(inputSongs.at(i));
+    }
+
+    for (unsigned int i = 0; i < queues.size(); i++) {
+        lock_guard<mutex> lock(queues.at(i)->lock);
+        queues.at(i)->heap.build(queueSongs.at(i));
+        updateTopScore(queues.at(i));
+    }
+    numElements.fetch_add(static_cast<int>(inputSongs.size()));
+}
+
+
+/**
+ * Removes a song with one of the highest scores: the better top of two randomly chosen heaps.
+ * If the chosen heap is locked by another thread, two other heaps are chosen rather than waiting for it.
+ * @return A copy of the Song that was removed, or an empty Song if the container is empty.
+ */
+Song MultiQueue::extractMax() {
+    while (true) {
+        unsigned int first = randomQueue();
+        unsigned int second = randomQueue();
+        int firstScore = queues.at(first)->topScore.load(memory_order_relaxed);
+        int secondScore = queues.at(second)->topScore.load(memory_order_relaxed);
+        int chosen = static_cast<int>(secondScore > firstScore ? second : first);
+
+        // Both heaps were empty. Look at every heap before deciding the whole container is:
+        if (firstScore == EMPTY_QUEUE && secondScore == EMPTY_QUEUE) {
+            chosen = bestQueue();
+            if (chosen == -1) {
+                if (numElements.load() == 0) {
+                    return Song();
+                }
+                continue; // Another thread is part way through an insert or extract.
+            }
+        }
+
+        Queue* queue = queues.at(chosen);
+        if (!queue->lock.try_lock()) {
+            continue;
+        }
+        if (queue->heap.size() == 0) { // Emptied by another thread since its top score was read.
+            queue->lock.unlock();
+            continue;
+        }
+        Song output = queue->heap.extractMax();
+        updateTopScore(queue);
+        queue->lock.unlock();
+        numElements.fetch_sub(1);
+        return output;
+    }
+}
+
+
+/**
+ * Gets the highest scoring song of any heap without removing it. Unlike extractMax(), every heap is considered, so
+ * the result is exact as long as no other thread changes the container at the same time.
+ * @return A copy of the Song, or an empty Song if the container is empty.
+ */
+Song MultiQueue::peekMax() {
+    int best = bestQueue();
+    if (best == -1) {
+        return Song();
+    }
+    lock_guard<mutex> lock(queues.at(best)->lock);
+    return queues.at(best)->heap.peekMax();
+}
+
+
+/**
+ * Searches every heap in order for a song with the given score. Only one heap is locked at a time.
+ * @param targetScore The score to search for.
+ * @return A copy of the first Song found, or an empty Song if no heap has the score.
+ */
+Song MultiQueue::search(int targetScore) {
+    for (unsigned int i = 0; i < queues.size(); i++) {
+        Queue* queue = queues.at(i);
+        if (queue->topScore.load(memory_order_relaxed) < targetScore) {
+            continue; // Every song in the heap scores lower.
+        }
+        lock_guard<mutex> lock(queue->lock);
+        Song result = queue->heap.search(targetScore);
+        if (!result.getName().empty()) {
+            return result;
+        }
+    }
+    return Song();
+}
+
+
+/**
+ * Inserts a song into a randomly chosen heap. If that heap is locked, another one is chosen rather than waiting.
+ * @param song The song to insert.
+ */
+void MultiQueue::insert(Song song) {
+    while (true) {
+        Queue* queue = queues.at(randomQueue());
+        if (queue->lock.try_lock()) {
+            queue->heap.insert(move(song));
+            updateTopScore(queue);
+            queue->lock.unlock();
+            numElements.fetch_add(1);
+            return;
+        }
+    }
+}
+
+
+/**
+ * Removes a song by track ID. The song can be in any heap, so they are searched in order, locking one at a time.
+ * @param songName The track ID of the song to remove.
+ * @param removed If not nullptr, receives a copy of the song that was removed.
+ * @return true if the song was found and removed, false otherwise.
+ */
+bool MultiQueue::remove(string songName, Song* removed) {
+    for (unsigned int i = 0; i < queues.size(); i++) {
+        Queue* queue = queues.at(i);
+        lock_guard<mutex> lock(queue->lock);
+        if (queue->heap.remove(songName, removed)) {
+            updateTopScore(queue);
+            numElements.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * Removes the song with both the given score and track ID. Like remove(), the heaps are searched one at a time.
+ * @param score The song's score.
+ * @param songName The song's track ID.
+ * @return true if the song was found and removed, false otherwise.
+ */
+bool MultiQueue::removeKey(int score, const string& songName) {
+    for (unsigned int i = 0; i < queues.size(); i++) {
+        Queue* queue = queues.at(i);
+        if (queue->topScore.load(memory_order_relaxed) < score) {
+            continue; // Every song in the heap scores lower.
+        }
+        lock_guard<mutex> lock(queue->lock);
+        if (queue->heap.removeKey(score, songName)) {
+            updateTopScore(queue);
+            numElements.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * Gets the number of songs. With other threads running, this is only a snapshot.
+ * @return The number of songs.
+ */
+int MultiQueue::size() {
+    return numElements.load();
+}
+
+
+/**
+ * Measures the memory used by every heap, plus the heaps' locks and the list of heaps.
+ * @return The breakdown of the container's memory.
+ */
+MemoryUsage MultiQueue::memoryUsage() {
+    MemoryUsage usage;
+    for (unsigned int i = 0; i < queues.size(); i++) {
+        MemoryUsage queueUsage;
+        {
+            lock_guard<mutex> lock(queues.at(i)->lock);
+            queueUsage = queues.at(i)->heap.memoryUsage();
+        }
+        usage.songCount += queueUsage.songCount;
+        usage.structureBytes += queueUsage.structureBytes;
+        usage.stringHeapBytes += queueUsage.stringHeapBytes;
+        usage.slackBytes += queueUsage.slackBytes;
+        usage.allocatorOverheadBytes += queueUsage.allocatorOverheadBytes;
+        usage.allocationCount += queueUsage.allocationCount;
+    }
+
+    // The queue list and every queue are allocations of their own. The cache line padding of a queue counts as slack:
+    usage.structureBytes += queues.size() * sizeof(Queue*) + queues.size() * (sizeof(MaxHeap) + sizeof(mutex) + sizeof(atomic<int>));
+    usage.addAllocation(queues.capacity() * sizeof(Queue*));
+    for (unsigned int i = 0; i < queues.size(); i++) {
+        usage.addAllocation(sizeof(Queue));
+    }
+    usage.slackBytes += (queues.capacity() - queues.size()) * sizeof(Queue*)
+                        + queues.size() * (sizeof(Queue) - sizeof(MaxHeap) - sizeof(mutex) - sizeof(atomic<int>));
+    return usage;
+}
+
+
+/**
+ * Copies every song, one heap at a time. Each heap is only locked while its songs are copied.
+ * @return The songs, heap by heap.
+ */
+vector<Song> MultiQueue::toVector() {
+    vector<Song> songs;
+    for (unsigned int i = 0; i < queues.size(); i++) {
+        lock_guard<mutex> lock(queues.at(i)->lock);
+        vector<Song> queueSongs = queues.at(i)->heap.toVector();
+        songs.insert(songs.end(), queueSongs.begin(), queueSongs.end());
+    }
+    return songs;
+}
+
+
+bool MultiQueue::isThreadSafe() {
+    return true;
+}
+
+
+int MultiQueue::getQueueCount() const {
+    return static_cast<int>(queues.size());
+}
+
+
+/**
+ * Gets the number of heaps used when none is given: two per hardware thread, which keeps the chance of two threads
+ * picking the same heap low while keeping extractMax() close to exact.
+ * @return The default number of heaps.
+ */
+int MultiQueue::defaultQueueCount() {
+    unsigned int threads = thread::hardware_concurrency();
+    return threads == 0 ? 4 : static_cast<int>(threads) * 2;
+}
@@ -0,0 +1,74 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_MULTIQUEUE_H
+#define COP3530_PROJECT_3_MULTIQUEUE_H
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "MaxHeap.h"
+#include "Song.h"
+#include "SongContainer.h"
+
+using namespace std;
+
+/**
+ * A relaxed priority queue that many threads can insert into and extract from at once (a "MultiQueue").
+ *
+ * Songs are spread over a number of MaxHeaps (a few per hardware thread), each with its own lock. An insert adds the
+ * song to a randomly chosen heap. extractMax() looks at the top scores of two randomly chosen heaps and removes the
+ * better of the two, so it does not always return the highest scoring song in the container, but one that is close
+ * to it: on average only a few songs per heap outrank it. In return, no operation ever has to lock more than one heap,
+ * and a thread that finds a heap locked simply picks another one instead of waiting.
+ *
+ * search() and remove() have to look through every heap, one at a time, since a song can be in any of them.
+ */
+class MultiQueue : public SongContainer {
+private:
+    static const int EMPTY_QUEUE; // topScore of a heap with no songs.
+
+    /**
+     * One heap, its lock and a copy of its top score that can be read without the lock.
+     * Aligned to a cache line so that threads working on neighbouring heaps do not slow each other down.
+     */
+    struct alignas(64) Queue {
+        MaxHeap heap;
+        mutex lock;
+        atomic<int> topScore;
+    };
+
+    vector<Queue*> queues;
+    atomic<int> numElements;
+
+    unsigned int randomQueue() const;
+    int bestQueue() const; // Heap with the highest top score, read without locking. -1 if every heap looks empty.
+    void updateTopScore(Queue* queue); // The queue's lock must be held.
+
+public:
+    MultiQueue(int queueCount); // ctr
+    virtual ~MultiQueue(); // dtr
+
+    // Overridden functions. See the .cpp implementation file:
+    virtual void build(vector<Song>& inputSongs);
+    virtual Song extractMax();
+    virtual Song peekMax();
+    virtual Song search(int targetScore);
+    virtual void insert(Song song);
+    virtual bool remove(string songName, Song* removed = nullptr);
+    virtual bool removeKey(int score, const string& songName);
+    virtual int size();
+    virtual MemoryUsage memoryUsage();
+    virtual vector<Song> toVector();
+    virtual bool isThreadSafe();
+
+    int getQueueCount() const;
+
+    static int defaultQueueCount();
+};
+
+
+#endif //COP3530_PROJECT_3_MULTIQUEUE_H
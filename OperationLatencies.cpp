@@ -0,0 +1,251 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <iomanip>
+#include <sstream>
+
+#include "OperationLatencies.h"
+
+/**
+ * Gets the name of a timed operation, as used in printed output.
+ * @param operation The operation.
+ * @return The operation's name.
+ */
+const char* OperationLatencies::operationName(TimedOperation operation) {
+    switch (operation) {
+        case TIMED_BUILD: return "build";
+        case TIMED_INSERT: return "insert";
+        case TIMED_REMOVE: return "remove";
+        case TIMED_SEARCH: return "search";
+        case TIMED_RANGE: return "range";
+        case TIMED_EXTRACT: return "extract";
+        case TIMED_SIZE: return "size";
+        default: return "unknown";
+    }
+}
+
+
+/**
+ * Records the latency of one operation.
+ * @param operation The operation that was timed.
+ * @param nanoseconds How long it took.
+ */
+void OperationLatencies::record(TimedOperation operation, long long nanoseconds) {
+    histograms[operation].record(nanoseconds);
+}
+
+
+/**
+ * Records the latency and hardware counters of one operation.
+ * @param operation The operation that was timed.
+ * @param nanoseconds How long it took.
+ * @param sample The events counted during the operation. Invalid events are ignored.
+ */
+void OperationLatencies::record(TimedOperation operation, long long nanoseconds, const PerfSample& sample) {
+    histograms[operation].record(nanoseconds);
+    counters[operation].add(sample);
+}
+
+
+/**
+ * Gets the histogram of one operation.
+ * @param operation The operation.
+ * @return The latencies recorded for the operation so far.
+ */
+const LatencyHistogram& OperationLatencies::get(TimedOperation operation) const {
+    return histograms[operation];
+}
+
+
+/**
+ * Prints a table with the count and p50/p90/p99/p99.9/max latency of every operation that has been recorded.
+ * @param output Where to print the table.
+ */
+void OperationLatencies::print(ostream& output) const {
+    output << left << setw(10) << "operation" << right << setw(10) << "count" << setw(12) << "p50 ns" << setw(12) << "p90 ns"
+           << setw(12) << "p99 ns" << setw(12) << "p99.9 ns" << setw(14) << "max ns" << endl;
+
+    for (int i = 0; i < TIMED_OPERATION_COUNT; i++) {
+        const LatencyHistogram& histogram = histograms[i];
+        if (histogram.count() == 0) {
+            continue;
+        }
+        output << left << setw(10) << operationName(static_cast<TimedOperation>(i)) << right << setw(10) << histogram.count()
+               << setw(12) << histogram.percentile(50) << setw(12) << histogram.percentile(90)
+               << setw(12) << histogram.percentile(99) << setw(12) << histogram.percentile(99.9)
+               << setw(14) << histogram.max() << endl;
+    }
+}
+
+
+/**
+ * Summarises every recorded operation on a single line, for machine-readable output.
+ * @return Entries like "search:count=12,p50=310,p90=420,p99=900,p999=900,max=900" separated by semicolons.
+ */
+string OperationLatencies::summary() const {
+    ostringstream output;
+    bool first = true;
+    for (int i = 0; i < TIMED_OPERATION_COUNT; i++) {
+        const LatencyHistogram& histogram = histograms[i];
+        if (histogram.count() == 0) {
+            continue;
+        }
+        if (!first) {
+            output << ';';
+        }
+        first = false;
+        output << operationName(static_cast<TimedOperation>(i)) << ":count=" << histogram.count()
+               << ",p50=" << histogram.percentile(50) << ",p90=" << histogram.percentile(90)
+               << ",p99=" << histogram.percentile(99) << ",p999=" << histogram.percentile(99.9)
+               << ",max=" << histogram.max();
+    }
+    return output.str();
+}
+
+
+/**
+ * Checks whether any hardware counter samples have been recorded.
+ * @return true if at least one operation has counter samples, false otherwise.
+ */
+bool OperationLatencies::hasCounters() const {
+    for (int i = 0; i < TIMED_OPERATION_COUNT; i++) {
+        if (counters[i].hasSamples()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * Prints a table with the average hardware counts per operation, for every operation that has counter samples.
+ * Events that could not be counted are shown as '-'.
+ * @param output Where to print the table.
+ */
+void OperationLatencies::printCounters(ostream& output) const {
+    output << left << setw(10) << "operation" << right;
+    for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+        output << setw(15) << PerfCounters::eventName(static_cast<PerfEvent>(e));
+    }
+    output << setw(8) << "IPC" << endl;
+
+    output << fixed << setprecision(1);
+    for (int i = 0; i < TIMED_OPERATION_COUNT; i++) {
+        if (!counters[i].hasSamples()) {
+            continue;
+        }
+        output << left << setw(10) << operationName(static_cast<TimedOperation>(i)) << right;
+        for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+            double mean;
+            if (counters[i].mean(static_cast<PerfEvent>(e), mean)) {
+                output << setw(15) << mean;
+            }
+            else {
+                output << setw(15) << "-";
+            }
+        }
+
+        // Instructions per cycle:
+        double cycles;
+        double instructions;
+        if (counters[i].mean(PERF_CYCLES, cycles) && counters[i].mean(PERF_INSTRUCTIONS, instructions) && cycles > 0) {
+            output << setw(8) << setprecision(2) << instructions / cycles << setprecision(1);
+        }
+        else {
+            output << setw(8) << "-";
+        }
+        output << endl;
+    }
+    output << defaultfloat << setprecision(6);
+}
+
+
+/**
+ * Summarises the average hardware counts of every operation on a single line, for machine-readable output.
+ * @return Entries like "search:cycles=1520.0,instructions=2210.5,..." separated by semicolons. Events that could not
+ *         be counted are left out.
+ */
+string OperationLatencies::counterSummary() const {
+    ostringstream output;
+    output << fixed << setprecision(1);
+    bool first = true;
+    for (int i = 0; i < TIMED_OPERATION_COUNT; i++) {
+        if (!counters[i].hasSamples()) {
+            continue;
+        }
+        if (!first) {
+            output << ';';
+        }
+        first = false;
+        output << operationName(static_cast<TimedOperation>(i)) << ':';
+
+        bool firstEvent = true;
+        for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+            double mean;
+            if (counters[i].mean(static_cast<PerfEvent>(e), mean)) {
+                output << (firstEvent ? "" : ",") << PerfCounters::eventName(static_cast<PerfEvent>(e)) << '=' << mean;
+                firstEvent = false;
+            }
+        }
+    }
+    return output.str();
+}
+
+
+/**
+ * Records the heap allocations made by one operation.
+ * @param operation The operation that was measured.
+ * @param counts The allocations made during the operation.
+ */
+void OperationLatencies::recordAllocations(TimedOperation operation, const AllocationCounts& counts) {
+    allocations[operation].add(counts);
+}
+
+
+/**
+ * Prints a table with the heap allocations of every operation that has been recorded.
+ * An operation that shows 0 allocating operations never touched the heap.
+ * @param output Where to print the table.
+ */
+void OperationLatencies::printAllocations(ostream& output) const {
+    output << left << setw(10) << "operation" << right << setw(10) << "count" << setw(12) << "allocating" << setw(14)
+           << "allocs/op" << setw(14) << "bytes/op" << setw(12) << "max allocs" << endl;
+
+    output << fixed << setprecision(1);
+    for (int i = 0; i < TIMED_OPERATION_COUNT; i++) {
+        const AllocationTotals& totals = allocations[i];
+        if (totals.getOperations() == 0) {
+            continue;
+        }
+        output << left << setw(10) << operationName(static_cast<TimedOperation>(i)) << right << setw(10) << totals.getOperations()
+               << setw(12) << totals.getAllocatingOperations() << setw(14) << totals.allocationsPerOperation()
+               << setw(14) << totals.bytesPerOperation() << setw(12) << totals.getMaxAllocations() << endl;
+    }
+    output << defaultfloat << setprecision(6);
+}
+
+
+/**
+ * Summarises the allocations of every operation on a single line, for machine-readable output.
+ * @return Entries like "search:count=12,allocating=12,allocs_per_op=1.0,bytes_per_op=19.0,max=1" separated by semicolons.
+ */
+string OperationLatencies::allocationSummary() const {
+    ostringstream output;
+    output << fixed << setprecision(1);
+    bool first = true;
+    for (int i = 0; i < TIMED_OPERATION_COUNT; i++) {
+        const AllocationTotals& totals = allocations[i];
+        if (totals.getOperations() == 0) {
+            continue;
+        }
+        if (!first) {
+            output << ';';
+        }
+        first = false;
+        output << operationName(static_cast<TimedOperation>(i)) << ":count=" << totals.getOperations() << ",allocating="
+               << totals.getAllocatingOperations() << ",allocs_per_op=" << totals.allocationsPerOperation()
+               << ",bytes_per_op=" << totals.bytesPerOperation() << ",max=" << totals.getMaxAllocations();
+    }
+    return output.str();
+}
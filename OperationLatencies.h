@@ -0,0 +1,59 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_OPERATIONLATENCIES_H
+#define COP3530_PROJECT_3_OPERATIONLATENCIES_H
+
+#include <ostream>
+#include <string>
+
+#include "AllocationTracker.h"
+#include "LatencyHistogram.h"
+#include "PerfCounters.h"
+
+using namespace std;
+
+/**
+ * The container operations whose latencies are tracked over a session.
+ */
+enum TimedOperation {
+    TIMED_BUILD,
+    TIMED_INSERT,
+    TIMED_REMOVE,
+    TIMED_SEARCH,
+    TIMED_RANGE,
+    TIMED_EXTRACT,
+    TIMED_SIZE,
+    TIMED_OPERATION_COUNT // Number of timed operations. Not an operation.
+};
+
+/**
+ * One latency histogram per container operation, accumulated over a whole session.
+ * Hardware counter samples (see PerfCounters.h) and heap allocations (see AllocationTracker.h) can be recorded alongside,
+ * and are reported as averages per operation.
+ */
+class OperationLatencies {
+private:
+    LatencyHistogram histograms[TIMED_OPERATION_COUNT];
+    PerfTotals counters[TIMED_OPERATION_COUNT];
+    AllocationTotals allocations[TIMED_OPERATION_COUNT];
+
+public:
+    static const char* operationName(TimedOperation operation);
+
+    void record(TimedOperation operation, long long nanoseconds);
+    void record(TimedOperation operation, long long nanoseconds, const PerfSample& sample);
+    const LatencyHistogram& get(TimedOperation operation) const;
+    void print(ostream& output) const;
+    bool hasCounters() const;
+    void printCounters(ostream& output) const;
+    string summary() const;
+    string counterSummary() const;
+    void recordAllocations(TimedOperation operation, const AllocationCounts& counts);
+    void printAllocations(ostream& output) const;
+    string allocationSummary() const;
+};
+
+
+#endif //COP3530_PROJECT_3_OPERATIONLATENCIES_H
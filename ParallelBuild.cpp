@@ -0,0 +1,198 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "ParallelBuild.h"
+
+static const size_t MIN_PARALLEL_SONGS = 1 << 15; // Below this, starting threads costs more than it saves.
+
+// Set on threads started by parallelFor (and on its caller while it runs), so a build nested inside another one, such
+// as a shard's inside ShardedContainer::build, stays on its thread instead of starting threads of its own:
+static thread_local bool insideParallelFor = false;
+
+
+/**
+ * Gets the number of threads to build a container of a given size with.
+ * @param songCount The number of songs being built.
+ * @return One per hardware thread for large builds. 1 for small ones, and for builds already running on a thread
+ *         started by parallelFor.
+ */
+int parallelBuildThreads(size_t songCount) {
+    if (songCount < MIN_PARALLEL_SONGS || insideParallelFor) {
+        return 1;
+    }
+    unsigned int threads = thread::hardware_concurrency();
+    return threads == 0 ? 1 : static_cast<int>(threads);
+}
+
+
+/**
+ * Splits the items 0 to itemCount - 1 into contiguous blocks of about the same size and runs each block on its own
+ * thread. The calling thread runs the first block itself.
+ * @param threadCount The number of blocks (and threads). Capped at itemCount.
+ * @param itemCount The number of items.
+ * @param body Called once per block with the first item of the block and one past its last item.
+ */
+void parallelFor(size_t threadCount, size_t itemCount, const function<void(size_t first, size_t last)>& body) {
+    size_t blocks = min(threadCount, itemCount);
+    if (blocks <= 1) {
+        if (itemCount > 0) {
+            body(0, itemCount);
+        }
+        return;
+    }
+
+    bool wasInside = insideParallelFor;
+    insideParallelFor = true;
+    vector<thread> workers;
+    for (size_t b = 1; b < blocks; b++) {
+        workers.push_back(thread([&body, b, blocks, itemCount]() {
+            insideParallelFor = true;
+            body(itemCount * b / blocks, itemCount * (b + 1) / blocks);
+        }));
+    }
+    body(0, itemCount / blocks);
+    for (unsigned int i = 0; i < workers.size(); i++) {
+        workers.at(i).join();
+    }
+    insideParallelFor = wasInside;
+}
+
+
+/**
+ * The order songs are sorted in: by score, with ties broken by name. The same order as the nodes of a SplayTree.
+ * @return true if the song a points to comes before the one b points to.
+ */
+bool songPointerLess(const Song* a, const Song* b) {
+    if (a->getScore() != b->getScore()) {
+        return a->getScore() < b->getScore();
+    }
+    return a->getName() < b->getName();
+}
+
+
+/**
+ * Sorts songs by score, then name, on several threads. Pointers are sorted rather than the songs, so nothing but
+ * pointers is ever moved and the caller's vector is left as it is.
+ *
+ * Scores usually cover a small range (the narcissism scores are well under a thousand), so when there are fewer
+ * distinct scores than songs per thread, the songs are bucketed with a parallel counting sort and only songs that share
+ * a score are compared. Otherwise each thread sorts a block and the blocks are merged in pairs, in parallel.
+ * @param songs The songs to sort.
+ * @param threadCount The number of threads to use.
+ * @return Pointers to the songs, in order.
+ */
+vector<const Song*> sortSongs(const vector<Song>& songs, int threadCount) {
+    size_t count = songs.size();
+    vector<const Song*> sorted(count);
+    if (count == 0) {
+        return sorted;
+    }
+    size_t blocks = threadCount < 1 ? 1 : min(static_cast<size_t>(threadCount), count);
+
+    // Every step below splits the songs into the same blocks, one per thread:
+    vector<size_t> bounds(blocks + 1);
+    for (size_t block = 0; block <= blocks; block++) {
+        bounds.at(block) = count * block / blocks;
+    }
+
+    // Find the range of scores:
+    vector<int> blockMin(blocks, songs.front().getScore());
+    vector<int> blockMax(blocks, songs.front().getScore());
+    parallelFor(blocks, blocks, [&songs, &bounds, &blockMin, &blockMax](size_t firstBlock, size_t lastBlock) {
+        for (size_t block = firstBlock; block < lastBlock; block++) {
+            for (size_t i = bounds.at(block); i < bounds.at(block + 1); i++) {
+                blockMin.at(block) = min(blockMin.at(block), songs.at(i).getScore());
+                blockMax.at(block) = max(blockMax.at(block), songs.at(i).getScore());
+            }
+        }
+    });
+    int minScore = *min_element(blockMin.begin(), blockMin.end());
+    int maxScore = *max_element(blockMax.begin(), blockMax.end());
+    size_t scoreRange = static_cast<size_t>(static_cast<long long>(maxScore) - minScore + 1);
+
+    if (scoreRange * blocks <= count) {
+        // Counting sort. Each thread counts the scores in its block:
+        vector<vector<size_t>> counts(blocks, vector<size_t>(scoreRange, 0));
+        parallelFor(blocks, blocks, [&songs, &bounds, &counts, minScore](size_t firstBlock, size_t lastBlock) {
+            for (size_t block = firstBlock; block < lastBlock; block++) {
+                for (size_t i = bounds.at(block); i < bounds.at(block + 1); i++) {
+                    counts.at(block).at(songs.at(i).getScore() - minScore)++;
+                }
+            }
+        });
+
+        // Turn the counts into the position each block writes its first song of each score to:
+        vector<size_t> bucketStart(scoreRange + 1, 0);
+        size_t position = 0;
+        for (size_t score = 0; score < scoreRange; score++) {
+            bucketStart.at(score) = position;
+            for (size_t block = 0; block < blocks; block++) {
+                size_t blockCount = counts.at(block).at(score);
+                counts.at(block).at(score) = position;
+                position += blockCount;
+            }
+        }
+        bucketStart.at(scoreRange) = position;
+
+        // Each thread places its block's songs. Blocks never write to the same position:
+        parallelFor(blocks, blocks, [&songs, &bounds, &counts, &sorted, minScore](size_t firstBlock, size_t lastBlock) {
+            for (size_t block = firstBlock; block < lastBlock; block++) {
+                vector<size_t>& next = counts.at(block);
+                for (size_t i = bounds.at(block); i < bounds.at(block + 1); i++) {
+                    sorted.at(next.at(songs.at(i).getScore() - minScore)++) = &songs.at(i);
+                }
+            }
+        });
+
+        // Sort each score's songs by name. Threads take the next unsorted score as they finish, to balance the load:
+        atomic<size_t> nextScore(0);
+        parallelFor(blocks, blocks, [&sorted, &bucketStart, &nextScore, scoreRange](size_t, size_t) {
+            for (size_t score = nextScore.fetch_add(1); score < scoreRange; score = nextScore.fetch_add(1)) {
+                sort(sorted.begin() + bucketStart.at(score), sorted.begin() + bucketStart.at(score + 1), songPointerLess);
+            }
+        });
+        return sorted;
+    }
+
+    // Merge sort. Each thread sorts a block:
+    for (size_t i = 0; i < count; i++) {
+        sorted.at(i) = &songs.at(i);
+    }
+    parallelFor(blocks, blocks, [&sorted, &bounds](size_t firstBlock, size_t lastBlock) {
+        for (size_t block = firstBlock; block < lastBlock; block++) {
+            sort(sorted.begin() + bounds.at(block), sorted.begin() + bounds.at(block + 1), songPointerLess);
+        }
+    });
+
+    // Merge neighbouring blocks in pairs until one is left. The pairs of each round are merged in parallel:
+    vector<const Song*> buffer(count);
+    while (bounds.size() > 2) {
+        size_t pairs = (bounds.size() - 1) / 2;
+        parallelFor(pairs, pairs, [&sorted, &buffer, &bounds](size_t firstPair, size_t lastPair) {
+            for (size_t pair = firstPair; pair < lastPair; pair++) {
+                size_t begin = bounds.at(pair * 2), middle = bounds.at(pair * 2 + 1), end = bounds.at(pair * 2 + 2);
+                merge(sorted.begin() + begin, sorted.begin() + middle, sorted.begin() + middle, sorted.begin() + end,
+                      buffer.begin() + begin, songPointerLess);
+            }
+        });
+        // A block left without a partner is copied across as it is:
+        if ((bounds.size() - 1) % 2 == 1) {
+            copy(sorted.begin() + bounds.at(bounds.size() - 2), sorted.end(), buffer.begin() + bounds.at(bounds.size() - 2));
+        }
+        vector<size_t> mergedBounds;
+        for (size_t i = 0; i < bounds.size(); i += 2) {
+            mergedBounds.push_back(bounds.at(i));
+        }
+        if (mergedBounds.back() != count) {
+            mergedBounds.push_back(count);
+        }
+        bounds.swap(mergedBounds);
+        sorted.swap(buffer);
+    }
+    return sorted;
+}
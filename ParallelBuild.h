@@ -0,0 +1,23 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_PARALLELBUILD_H
+#define COP3530_PROJECT_3_PARALLELBUILD_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "Song.h"
+
+using namespace std;
+
+// Helpers for building containers from a whole vector of songs on several threads. See the .cpp implementation file:
+int parallelBuildThreads(size_t songCount);
+void parallelFor(size_t threadCount, size_t itemCount, const function<void(size_t first, size_t last)>& body);
+bool songPointerLess(const Song* a, const Song* b);
+vector<const Song*> sortSongs(const vector<Song>& songs, int threadCount);
+
+
+#endif //COP3530_PROJECT_3_PARALLELBUILD_H
@@ -0,0 +1,285 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Constructor. Every event starts out invalid with a count of 0.
+ */
+PerfSample::PerfSample() {
+    for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+        values[i] = 0;
+        valid[i] = false;
+    }
+}
+
+
+/**
+ * Constructor.
+ */
+PerfTotals::PerfTotals() {
+    for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+        sums[i] = 0;
+        sampleCounts[i] = 0;
+    }
+}
+
+
+/**
+ * Adds the valid events of a sample to the totals.
+ * @param sample The sample to add.
+ */
+void PerfTotals::add(const PerfSample& sample) {
+    for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+        if (sample.valid[i]) {
+            sums[i] += sample.values[i];
+            sampleCounts[i]++;
+        }
+    }
+}
+
+
+/**
+ * Checks whether any valid sample has been added.
+ * @return true if there is at least one sample, false otherwise.
+ */
+bool PerfTotals::hasSamples() const {
+    for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+        if (sampleCounts[i] > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * Gets the average count of an event per sample.
+ * @param event The event.
+ * @param result Set to the average.
+ * @return true if the event has any samples, false otherwise.
+ */
+bool PerfTotals::mean(PerfEvent event, double& result) const {
+    if (sampleCounts[event] == 0) {
+        return false;
+    }
+    result = static_cast<double>(sums[event]) / sampleCounts[event];
+    return true;
+}
+
+
+/**
+ * Constructor. No counters are opened until open() is called.
+ */
+PerfCounters::PerfCounters() : groupFd(-1), groupSize(0), startEnabled(0), startRunning(0) {
+    for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+        fds[i] = -1;
+        groupSlot[i] = -1;
+        startValues[i] = 0;
+    }
+}
+
+
+/**
+ * Destructor.
+ */
+PerfCounters::~PerfCounters() {
+    close();
+}
+
+
+/**
+ * Gets the name of an event, as used in printed output.
+ * @param event The event.
+ * @return The event's name.
+ */
+const char* PerfCounters::eventName(PerfEvent event) {
+    switch (event) {
+        case PERF_CYCLES: return "cycles";
+        case PERF_INSTRUCTIONS: return "instructions";
+        case PERF_L1D_MISSES: return "l1d_misses";
+        case PERF_LLC_MISSES: return "llc_misses";
+        case PERF_BRANCH_MISSES: return "branch_misses";
+        default: return "unknown";
+    }
+}
+
+
+/**
+ * Opens every event the system allows, as one group so they are all read at the same moment.
+ * Only user space is counted, which most systems allow without special privileges.
+ * @return true if at least one event could be opened, false otherwise (see getError()).
+ */
+bool PerfCounters::open() {
+    close();
+
+#ifdef __linux__
+    // Type and config of each event, in the order of the PerfEvent enum:
+    const uint32_t types[PERF_EVENT_COUNT] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+                                              PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE};
+    const uint64_t configs[PERF_EVENT_COUNT] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = types[i];
+        attr.config = configs[i];
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attr.disabled = (groupFd == -1) ? 1 : 0; // The group starts when its leader is enabled below.
+
+        // Count this thread, on any CPU:
+        int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+        if (fd == -1) {
+            if (error.empty()) {
+                error = string(eventName(static_cast<PerfEvent>(i))) + ": " + strerror(errno);
+            }
+            continue;
+        }
+
+        fds[i] = fd;
+        groupSlot[i] = groupSize++;
+        if (groupFd == -1) {
+            groupFd = fd;
+        }
+    }
+
+    if (groupFd == -1) {
+        return false;
+    }
+    ioctl(groupFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    error.clear();
+    return true;
+#else
+    error = "hardware counters are only supported on Linux";
+    return false;
+#endif
+}
+
+
+/**
+ * Closes every open event.
+ */
+void PerfCounters::close() {
+#ifdef __linux__
+    for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+        if (fds[i] != -1) {
+            ::close(fds[i]);
+        }
+    }
+#endif
+    for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+        fds[i] = -1;
+        groupSlot[i] = -1;
+    }
+    groupFd = -1;
+    groupSize = 0;
+}
+
+
+/**
+ * Checks whether any event is being counted.
+ * @return true if at least one event is open, false otherwise.
+ */
+bool PerfCounters::isAvailable() const {
+    return groupFd != -1;
+}
+
+
+/**
+ * Gets the reason no events could be opened.
+ * @return The error of the first event that failed to open, or an empty string.
+ */
+const string& PerfCounters::getError() const {
+    return error;
+}
+
+
+/**
+ * Reads every open event at once.
+ * @param values Populated with the current count of each open event.
+ * @param enabled Set to the time the group has been enabled, in nanoseconds.
+ * @param running Set to the time the group has actually been counting, in nanoseconds.
+ * @return true if the counters could be read, false otherwise.
+ */
+bool PerfCounters::readGroup(uint64_t values[PERF_EVENT_COUNT], uint64_t& enabled, uint64_t& running) {
+#ifdef __linux__
+    // Layout of a group read: event count, time enabled, time running, then one value per event:
+    uint64_t buffer[3 + PERF_EVENT_COUNT];
+    ssize_t expected = static_cast<ssize_t>((3 + groupSize) * sizeof(uint64_t));
+    if (groupFd == -1 || read(groupFd, buffer, sizeof(buffer)) != expected) {
+        return false;
+    }
+    enabled = buffer[1];
+    running = buffer[2];
+    for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+        values[i] = groupSlot[i] != -1 ? buffer[3 + groupSlot[i]] : 0;
+    }
+    return true;
+#else
+    (void) values;
+    (void) enabled;
+    (void) running;
+    return false;
+#endif
+}
+
+
+/**
+ * Reads the counters at the start of the code being measured.
+ */
+void PerfCounters::start() {
+    if (!readGroup(startValues, startEnabled, startRunning)) {
+        startEnabled = 0;
+        startRunning = 0;
+    }
+}
+
+
+/**
+ * Reads the counters at the end of the code being measured.
+ * @param sample Populated with the events counted since start(). Events that are not open are marked invalid.
+ */
+void PerfCounters::stop(PerfSample& sample) {
+    sample = PerfSample();
+
+    uint64_t endValues[PERF_EVENT_COUNT];
+    uint64_t endEnabled;
+    uint64_t endRunning;
+    if (!readGroup(endValues, endEnabled, endRunning)) {
+        return;
+    }
+
+    // When the kernel has more events than hardware counters it takes turns, so scale up to the full time enabled:
+    uint64_t enabled = endEnabled - startEnabled;
+    uint64_t running = endRunning - startRunning;
+    if (running == 0) {
+        return; // The group was never scheduled during the measured code.
+    }
+    double scale = static_cast<double>(enabled) / running;
+
+    for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+        if (groupSlot[i] != -1) {
+            sample.values[i] = static_cast<uint64_t>((endValues[i] - startValues[i]) * scale + 0.5);
+            sample.valid[i] = true;
+        }
+    }
+}
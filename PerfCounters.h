@@ -0,0 +1,88 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_PERFCOUNTERS_H
+#define COP3530_PROJECT_3_PERFCOUNTERS_H
+
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+/**
+ * The hardware events counted around each timed operation.
+ */
+enum PerfEvent {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_L1D_MISSES, // Level 1 data cache read misses.
+    PERF_LLC_MISSES, // Last level cache misses.
+    PERF_BRANCH_MISSES,
+    PERF_EVENT_COUNT // Number of events. Not an event.
+};
+
+/**
+ * Counter values for one stretch of code. An event that could not be counted is marked invalid.
+ */
+struct PerfSample {
+    uint64_t values[PERF_EVENT_COUNT];
+    bool valid[PERF_EVENT_COUNT];
+
+    PerfSample(); // ctr
+};
+
+/**
+ * Running totals of the samples taken around one kind of operation, for reporting averages per operation.
+ */
+class PerfTotals {
+private:
+    uint64_t sums[PERF_EVENT_COUNT];
+    uint64_t sampleCounts[PERF_EVENT_COUNT]; // Number of valid samples of each event.
+
+public:
+    PerfTotals(); // ctr
+
+    void add(const PerfSample& sample);
+    bool hasSamples() const;
+    bool mean(PerfEvent event, double& result) const;
+};
+
+/**
+ * Counts hardware events for the calling thread with the Linux perf_event_open system call.
+ * Counters that the CPU, kernel or container does not allow are simply left out: if none can be opened, every sample
+ * comes back invalid and the program carries on with wall-clock times only. On other platforms nothing is counted.
+ *
+ * Usage: call start() right before the code to measure and stop() right after it. The counters are read, not reset,
+ * so each pair costs two read() system calls. Keep them outside any wall-clock timing of the same code.
+ */
+class PerfCounters {
+private:
+    int fds[PERF_EVENT_COUNT]; // File descriptor of each event, or -1 if it could not be opened.
+    int groupFd; // The first event that opened. Every other event is read together with it.
+    int groupSize; // Number of events that opened.
+    int groupSlot[PERF_EVENT_COUNT]; // Position of each event in a group read, or -1.
+    uint64_t startValues[PERF_EVENT_COUNT];
+    uint64_t startEnabled; // Time the group was enabled at start(), for scaling multiplexed counts.
+    uint64_t startRunning; // Time the group was actually counting at start().
+    string error; // Why no counters could be opened, if so.
+
+    bool readGroup(uint64_t values[PERF_EVENT_COUNT], uint64_t& enabled, uint64_t& running);
+
+public:
+    PerfCounters(); // ctr
+    ~PerfCounters(); // dtr
+
+    bool open();
+    void close();
+    bool isAvailable() const;
+    const string& getError() const;
+
+    void start();
+    void stop(PerfSample& sample);
+
+    static const char* eventName(PerfEvent event);
+};
+
+
+#endif //COP3530_PROJECT_3_PERFCOUNTERS_H
@@ -0,0 +1,577 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <random>
+
+#include "ParallelBuild.h"
+#include "PersistentTreap.h"
+
+/**
+ * Constructor. Creates an empty tree.
+ */
+PersistentTreap::PersistentTreap() : root(nullptr) {
+}
+
+
+/**
+ * Destructor. Nodes still shared with a snapshot are freed along with the last snapshot.
+ */
+PersistentTreap::~PersistentTreap() {
+}
+
+
+/**
+ * Picks the priority of a new node. Random priorities make the tree's shape random, whatever order songs arrive in.
+ * @return A random priority.
+ */
+unsigned int PersistentTreap::randomPriority() {
+    static thread_local mt19937 random(random_device{}());
+    return random();
+}
+
+
+/**
+ * Gets the number of songs in a subtree.
+ * @param node The subtree's root, or nullptr.
+ * @return The number of songs.
+ */
+int PersistentTreap::countOf(const NodePtr& node) {
+    return node == nullptr ? 0 : node->count;
+}
+
+
+/**
+ * Checks whether a song comes before a key in the tree: a lower score, or the same score and a smaller track ID.
+ * @param song The song.
+ * @param score The key's score.
+ * @param name The key's track ID.
+ * @return true if the song comes first, false otherwise.
+ */
+bool PersistentTreap::comesBefore(const Song& song, int score, const string& name) {
+    return song.getScore() < score || (song.getScore() == score && song.getName() < name);
+}
+
+
+/**
+ * Creates a node. Used both for new songs and for the copies of the nodes on a changed path.
+ * @param song The song the node holds.
+ * @param priority The node's priority.
+ * @param left The subtree of songs before it.
+ * @param right The subtree of songs after it.
+ * @return The node.
+ */
+PersistentTreap::NodePtr PersistentTreap::makeNode(const Song& song, unsigned int priority, NodePtr left, NodePtr right) {
+    shared_ptr<Node> node = make_shared<Node>();
+    node->val = song;
+    node->priority = priority;
+    node->count = 1 + countOf(left) + countOf(right);
+    node->left = move(left);
+    node->right = move(right);
+    return node;
+}
+
+
+/**
+ * Finds the first song at or after a key.
+ * @param node The root of the subtree to search.
+ * @param score The key's score.
+ * @param name The key's track ID. "" finds the first song with the score.
+ * @return The node, or nullptr if every song comes before the key.
+ */
+const PersistentTreap::Node* PersistentTreap::firstAtOrAfter(const Node* node, int score, const string& name) {
+    const Node* best = nullptr;
+    while (node != nullptr) {
+        if (comesBefore(node->val, score, name)) {
+            node = node->right.get();
+        }
+        else {
+            best = node;
+            node = node->left.get();
+        }
+    }
+    return best;
+}
+
+
+/**
+ * Splits a subtree into the songs before a key and the rest, copying only the nodes on the path to the key.
+ * @param node The subtree's root.
+ * @param score The key's score.
+ * @param name The key's track ID.
+ * @param less Populated with the songs that come before the key.
+ * @param notLess Populated with the songs at or after the key.
+ */
+void PersistentTreap::split(const NodePtr& node, int score, const string& name, NodePtr& less, NodePtr& notLess) {
+    if (node == nullptr) {
+        less = nullptr;
+        notLess = nullptr;
+        return;
+    }
+    NodePtr lower;
+    NodePtr upper;
+    if (comesBefore(node->val, score, name)) {
+        split(node->right, score, name, lower, upper);
+        less = makeNode(node->val, node->priority, node->left, lower);
+        notLess = upper;
+    }
+    else {
+        split(node->left, score, name, lower, upper);
+        less = lower;
+        notLess = makeNode(node->val, node->priority, upper, node->right);
+    }
+}
+
+
+/**
+ * Joins two subtrees, copying only the nodes along the seam between them.
+ * @param less A subtree whose songs all come before the other's.
+ * @param greater A subtree whose songs all come after the other's.
+ * @return The root of the joined subtree.
+ */
+PersistentTreap::NodePtr PersistentTreap::merge(const NodePtr& less, const NodePtr& greater) {
+    if (less == nullptr) {
+        return greater;
+    }
+    if (greater == nullptr) {
+        return less;
+    }
+    if (less->priority > greater->priority) {
+        return makeNode(less->val, less->priority, less->left, merge(less->right, greater));
+    }
+    return makeNode(greater->val, greater->priority, merge(less, greater->left), greater->right);
+}
+
+
+/**
+ * Inserts a song into a subtree. The path down to where the song belongs is copied; the new node is placed as high
+ * as its priority allows, splitting the subtree it lands on.
+ * @param node The subtree's root.
+ * @param song The song to insert. No song with the same key may be in the subtree.
+ * @param priority The new node's priority.
+ * @return The root of the new subtree.
+ */
+PersistentTreap::NodePtr PersistentTreap::insertNode(const NodePtr& node, const Song& song, unsigned int priority) {
+    if (node == nullptr || priority > node->priority) {
+        NodePtr less;
+        NodePtr notLess;
+        split(node, song.getScore(), song.getName(), less, notLess);
+        return makeNode(song, priority, less, notLess);
+    }
+    if (comesBefore(song, node->val.getScore(), node->val.getName())) {
+        return makeNode(node->val, node->priority, insertNode(node->left, song, priority), node->right);
+    }
+    return makeNode(node->val, node->priority, node->left, insertNode(node->right, song, priority));
+}
+
+
+/**
+ * Removes a song from a subtree by its key, copying the path down to it.
+ * @param node The subtree's root.
+ * @param score The song's score.
+ * @param name The song's track ID.
+ * @param removed Set to true if the song was found.
+ * @return The root of the new subtree, or node itself if the song was not found.
+ */
+PersistentTreap::NodePtr PersistentTreap::removeNode(const NodePtr& node, int score, const string& name, bool& removed) {
+    if (node == nullptr) {
+        return node;
+    }
+    if (comesBefore(node->val, score, name)) {
+        NodePtr right = removeNode(node->right, score, name, removed);
+        return removed ? makeNode(node->val, node->priority, node->left, right) : node;
+    }
+    if (node->val.getScore() != score || node->val.getName() != name) {
+        NodePtr left = removeNode(node->left, score, name, removed);
+        return removed ? makeNode(node->val, node->priority, left, node->right) : node;
+    }
+    removed = true;
+    return merge(node->left, node->right);
+}
+
+
+/**
+ * Creates a tree from songs in key order in one pass, as a Cartesian tree of random priorities: each song becomes the
+ * right child of the last song before it with a higher priority, and takes the songs in between as its left subtree.
+ * A song's subtree covers a run of the input, so its size is known when the run ends.
+ * @param songs The songs, in key order with no duplicate keys.
+ * @return The root of the tree.
+ */
+PersistentTreap::NodePtr PersistentTreap::buildFromSorted(const vector<const Song*>& songs) {
+    vector<shared_ptr<Node>> spine; // The rightmost path of the tree so far. Its nodes can still gain a right child.
+    vector<int> spineFirst; // Index of the first song in each spine node's subtree.
+    for (unsigned int i = 0; i < songs.size(); i++) {
+        shared_ptr<Node> node = make_shared<Node>();
+        node->val = *songs.at(i);
+        node->priority = randomPriority();
+
+        int first = static_cast<int>(i);
+        while (!spine.empty() && spine.back()->priority < node->priority) {
+            spine.back()->count = static_cast<int>(i) - spineFirst.back(); // Its run ends just before this song.
+            node->left = spine.back();
+            first = spineFirst.back();
+            spine.pop_back();
+            spineFirst.pop_back();
+        }
+        if (!spine.empty()) {
+            spine.back()->right = node;
+        }
+        spine.push_back(node);
+        spineFirst.push_back(first);
+    }
+
+    // The runs of the nodes left on the spine end with the last song:
+    for (unsigned int i = 0; i < spine.size(); i++) {
+        spine.at(i)->count = static_cast<int>(songs.size()) - spineFirst.at(i);
+    }
+    return spine.empty() ? nullptr : spine.front();
+}
+
+
+/**
+ * Takes a reference to the current version, so it stays alive for as long as the caller keeps it.
+ * @return The current root.
+ */
+PersistentTreap::NodePtr PersistentTreap::snapshotRoot() const {
+    lock_guard<mutex> lock(rootMutex);
+    return root;
+}
+
+
+/**
+ * Makes a new version the current one. Must be called by the writer holding writeMutex.
+ * @param newRoot The new version's root.
+ */
+void PersistentTreap::publish(NodePtr newRoot) {
+    {
+        lock_guard<mutex> lock(rootMutex);
+        root.swap(newRoot);
+    }
+    // newRoot now holds the old version, which is freed here (if no snapshot still uses it) after the lock is released.
+}
+
+
+/**
+ * Adds songs to the tree all at once: they are sorted, merged with the songs already in the tree (which win over new
+ * songs with the same key), and linked into a new tree in one pass. Readers see the old version until the whole new
+ * one is published.
+ * @param inputSongs The songs to add.
+ */
+void PersistentTreap::build(vector<Song>& inputSongs) {
+    lock_guard<mutex> lock(writeMutex);
+    vector<const Song*> sorted = sortSongs(inputSongs, parallelBuildThreads(inputSongs.size()));
+    vector<Song> existing = snapshot().toVector();
+
+    vector<const Song*> merged;
+    merged.reserve(existing.size() + sorted.size());
+    unsigned int existingIndex = 0;
+    for (unsigned int i = 0; i < sorted.size(); i++) {
+        const Song* song = sorted.at(i);
+        while (existingIndex < existing.size() && songPointerLess(&existing.at(existingIndex), song)) {
+            merged.push_back(&existing.at(existingIndex));
+            existingIndex++;
+        }
+        const Song* previous = merged.empty() ? nullptr : merged.back();
+        bool duplicate = previous != nullptr && !songPointerLess(previous, song);
+        if (existingIndex < existing.size() && !songPointerLess(song, &existing.at(existingIndex))) {
+            duplicate = true; // The same key is already in the tree.
+        }
+        if (!duplicate) {
+            merged.push_back(song);
+        }
+    }
+    while (existingIndex < existing.size()) {
+        merged.push_back(&existing.at(existingIndex));
+        existingIndex++;
+    }
+    publish(buildFromSorted(merged));
+}
+
+
+/**
+ * Removes the song with the highest score (and the highest track ID among songs with that score).
+ * @return A copy of the Song that was removed, or an empty Song if the tree is empty.
+ */
+Song PersistentTreap::extractMax() {
+    lock_guard<mutex> lock(writeMutex);
+    NodePtr current = snapshotRoot();
+    if (current == nullptr) {
+        return Song();
+    }
+    const Node* last = current.get();
+    while (last->right != nullptr) {
+        last = last->right.get();
+    }
+    Song result = last->val;
+    bool removed = false;
+    publish(removeNode(current, result.getScore(), result.getName(), removed));
+    return result;
+}
+
+
+Song PersistentTreap::peekMax() {
+    return snapshot().peekMax();
+}
+
+
+/**
+ * Searches for a song by score in the current version.
+ * @param targetScore The score to search for.
+ * @return A copy of the Song with the score and the smallest track ID, or an empty Song if no song has the score.
+ */
+Song PersistentTreap::search(int targetScore) {
+    return snapshot().search(targetScore);
+}
+
+
+/**
+ * Inserts a song, publishing a new version that shares every node off the song's path with the old one.
+ * @param song The song to insert. Nothing happens if a song with the same score and track ID is already in the tree.
+ */
+void PersistentTreap::insert(Song song) {
+    lock_guard<mutex> lock(writeMutex);
+    NodePtr current = snapshotRoot();
+    const Node* found = firstAtOrAfter(current.get(), song.getScore(), song.getName());
+    if (found != nullptr && found->val.getScore() == song.getScore() && found->val.getName() == song.getName()) {
+        return;
+    }
+    publish(insertNode(current, song, randomPriority()));
+}
+
+
+/**
+ * Removes a song by track ID. The tree is ordered by score, so every song is checked until the name is found. The scan
+ * reads a snapshot, so other writers carry on meanwhile; the song is then removed by its key, and looked for again if
+ * another thread removed it first. Use removeKey() when the score is known.
+ * @param songName The track ID of the song to remove.
+ * @param removed If not nullptr, receives a copy of the song that was removed.
+ * @return true if the song was found and removed, false otherwise.
+ */
+bool PersistentTreap::remove(string songName, Song* removed) {
+    while (true) {
+        NodePtr current = snapshotRoot();
+        const Node* found = nullptr;
+        vector<const Node*> stack;
+        if (current != nullptr) {
+            stack.push_back(current.get());
+        }
+        while (!stack.empty() && found == nullptr) {
+            const Node* node = stack.back();
+            stack.pop_back();
+            if (node->val.getName() == songName) {
+                found = node;
+            }
+            if (node->left != nullptr) {
+                stack.push_back(node->left.get());
+            }
+            if (node->right != nullptr) {
+                stack.push_back(node->right.get());
+            }
+        }
+        if (found == nullptr) {
+            return false;
+        }
+        if (removeKey(found->val.getScore(), songName)) {
+            if (removed != nullptr) {
+                *removed = found->val; // 'current' keeps the snapshot, and so the node, alive.
+            }
+            return true;
+        }
+    }
+}
+
+
+/**
+ * Removes a song by its score and track ID, which takes a search rather than a scan of the whole tree.
+ * @param score The song's score.
+ * @param songName The song's track ID.
+ * @return true if the song was found and removed, false otherwise.
+ */
+bool PersistentTreap::removeKey(int score, const string& songName) {
+    lock_guard<mutex> lock(writeMutex);
+    bool removed = false;
+    NodePtr updated = removeNode(snapshotRoot(), score, songName, removed);
+    if (removed) {
+        publish(updated);
+    }
+    return removed;
+}
+
+
+vector<Song> PersistentTreap::searchRange(int lowerBound, int upperBound) {
+    return snapshot().searchRange(lowerBound, upperBound);
+}
+
+
+vector<Song> PersistentTreap::top(int n) {
+    return snapshot().top(n);
+}
+
+
+int PersistentTreap::size() {
+    return snapshot().size();
+}
+
+
+/**
+ * Measures the memory used by the current version. Nodes only kept alive by older snapshots are not counted.
+ * @return The breakdown of the container's memory.
+ */
+MemoryUsage PersistentTreap::memoryUsage() {
+    // make_shared puts each node and its reference counts (a vtable pointer and two counters) in one allocation:
+    const size_t nodeBytes = sizeof(Node) + sizeof(void*) + 2 * sizeof(int);
+    MemoryUsage usage;
+    NodePtr current = snapshotRoot();
+    vector<const Node*> stack;
+    if (current != nullptr) {
+        stack.push_back(current.get());
+    }
+    while (!stack.empty()) {
+        const Node* node = stack.back();
+        stack.pop_back();
+        usage.songCount++;
+        usage.addString(node->val.getName());
+        usage.structureBytes += nodeBytes;
+        usage.addAllocation(nodeBytes);
+        if (node->left != nullptr) {
+            stack.push_back(node->left.get());
+        }
+        if (node->right != nullptr) {
+            stack.push_back(node->right.get());
+        }
+    }
+    return usage;
+}
+
+
+/**
+ * Copies every song in the current version.
+ * @return The songs, in ascending order of score, then track ID.
+ */
+vector<Song> PersistentTreap::toVector() {
+    return snapshot().toVector();
+}
+
+
+bool PersistentTreap::isThreadSafe() {
+    return true;
+}
+
+
+/**
+ * Pins the current version of the tree. Later inserts and removes do not change it.
+ * @return The snapshot.
+ */
+PersistentTreap::Snapshot PersistentTreap::snapshot() const {
+    return Snapshot(snapshotRoot());
+}
+
+
+/**
+ * Constructor.
+ * @param root The root of the version to keep.
+ */
+PersistentTreap::Snapshot::Snapshot(NodePtr root) : root(move(root)) {
+}
+
+
+/**
+ * Searches for a song by score.
+ * @param targetScore The score to search for.
+ * @return A copy of the Song with the score and the smallest track ID, or an empty Song if no song has the score.
+ */
+Song PersistentTreap::Snapshot::search(int targetScore) const {
+    const Node* node = firstAtOrAfter(root.get(), targetScore, "");
+    if (node != nullptr && node->val.getScore() == targetScore) {
+        return node->val;
+    }
+    return Song();
+}
+
+
+Song PersistentTreap::Snapshot::peekMax() const {
+    const Node* node = root.get();
+    if (node == nullptr) {
+        return Song();
+    }
+    while (node->right != nullptr) {
+        node = node->right.get();
+    }
+    return node->val;
+}
+
+
+/**
+ * Searches for one song per score in a range. Each song found leads straight to the next higher score with one more
+ * search, so songs that share a score are skipped rather than walked over.
+ * @param lowerBound The minimum score to search for.
+ * @param upperBound The maximum score to search for.
+ * @return The songs that were found, in ascending order of score. Scores with no song are left out.
+ */
+vector<Song> PersistentTreap::Snapshot::searchRange(int lowerBound, int upperBound) const {
+    vector<Song> results;
+    const Node* node = firstAtOrAfter(root.get(), lowerBound, "");
+    while (node != nullptr && node->val.getScore() <= upperBound) {
+        results.push_back(node->val);
+        if (node->val.getScore() == upperBound) {
+            break;
+        }
+        node = firstAtOrAfter(root.get(), node->val.getScore() + 1, "");
+    }
+    return results;
+}
+
+
+/**
+ * Gets the highest scoring songs.
+ * @param n The number of songs to get.
+ * @return Up to n songs, highest score first.
+ */
+vector<Song> PersistentTreap::Snapshot::top(int n) const {
+    vector<Song> results;
+    vector<const Node*> stack; // Nodes whose right subtree has been visited, but not the node itself.
+    const Node* node = root.get();
+    while ((node != nullptr || !stack.empty()) && static_cast<int>(results.size()) < n) {
+        if (node != nullptr) {
+            stack.push_back(node);
+            node = node->right.get();
+        }
+        else {
+            node = stack.back();
+            stack.pop_back();
+            results.push_back(node->val);
+            node = node->left.get();
+        }
+    }
+    return results;
+}
+
+
+/**
+ * Gets every song.
+ * @return The songs, in ascending order of score, then track ID.
+ */
+vector<Song> PersistentTreap::Snapshot::toVector() const {
+    vector<Song> results;
+    results.reserve(size());
+    vector<const Node*> stack;
+    const Node* node = root.get();
+    while (node != nullptr || !stack.empty()) {
+        if (node != nullptr) {
+            stack.push_back(node);
+            node = node->left.get();
+        }
+        else {
+            node = stack.back();
+            stack.pop_back();
+            results.push_back(node->val);
+            node = node->right.get();
+        }
+    }
+    return results;
+}
+
+
+int PersistentTreap::Snapshot::size() const {
+    return countOf(root);
+}
@@ -0,0 +1,107 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_PERSISTENTTREAP_H
+#define COP3530_PROJECT_3_PERSISTENTTREAP_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Song.h"
+#include "SongContainer.h"
+
+using namespace std;
+
+/**
+ * A treap ordered by score, then track ID, whose nodes are never changed once another thread can see them.
+ *
+ * Every insert or remove copies the nodes on the path it changes and shares the rest with the previous version, then
+ * publishes the new root by swapping one pointer. A reader takes the root once (see snapshot()) and works on that
+ * version for as long as it likes: it never waits for a writer to build its version, and never sees an update half
+ * done, however long a range search or top-K report takes. Nodes are reference counted (shared_ptr), so a version is
+ * freed once the tree and every snapshot have moved past it.
+ *
+ * Writers take turns on a mutex, since each one builds on the root the previous one published. Readers never take it.
+ * The root itself sits behind a second mutex, held only while the pointer is copied or swapped (which is all that
+ * atomic<shared_ptr> does in libstdc++, where it is not lock-free either). Inserting a song with the same score and
+ * track ID as one already in the tree does nothing.
+ */
+class PersistentTreap : public SongContainer {
+private:
+    /**
+     * A song and its subtrees. Only changed while it is being created, before it is published.
+     */
+    struct Node {
+        Song val;
+        unsigned int priority; // No child has a higher priority than its parent, which keeps the tree balanced.
+        int count; // Number of songs in the subtree rooted at this node, so each version knows its own size.
+        shared_ptr<const Node> left;
+        shared_ptr<const Node> right;
+    };
+
+    typedef shared_ptr<const Node> NodePtr;
+
+    NodePtr root; // The current version.
+    mutable mutex rootMutex; // Held while root is copied or replaced, and nothing else.
+    mutex writeMutex; // Held by the one thread building the next version.
+
+    static unsigned int randomPriority();
+    static int countOf(const NodePtr& node);
+    static bool comesBefore(const Song& song, int score, const string& name);
+    static NodePtr makeNode(const Song& song, unsigned int priority, NodePtr left, NodePtr right);
+    static const Node* firstAtOrAfter(const Node* node, int score, const string& name);
+    static void split(const NodePtr& node, int score, const string& name, NodePtr& less, NodePtr& notLess);
+    static NodePtr merge(const NodePtr& less, const NodePtr& greater);
+    static NodePtr insertNode(const NodePtr& node, const Song& song, unsigned int priority);
+    static NodePtr removeNode(const NodePtr& node, int score, const string& name, bool& removed);
+    static NodePtr buildFromSorted(const vector<const Song*>& songs);
+
+    NodePtr snapshotRoot() const;
+    void publish(NodePtr newRoot);
+
+public:
+    /**
+     * One version of the tree, which stays exactly as it was however the tree changes afterwards.
+     * Any number of threads can read the same snapshot at once.
+     */
+    class Snapshot {
+    private:
+        NodePtr root;
+
+    public:
+        explicit Snapshot(NodePtr root); // ctr
+
+        Song search(int targetScore) const;
+        Song peekMax() const;
+        vector<Song> searchRange(int lowerBound, int upperBound) const;
+        vector<Song> top(int n) const;
+        vector<Song> toVector() const;
+        int size() const;
+    };
+
+    PersistentTreap(); // ctr
+    virtual ~PersistentTreap(); // dtr
+
+    // Overridden functions. See the .cpp implementation file:
+    virtual void build(vector<Song>& inputSongs);
+    virtual Song extractMax();
+    virtual Song peekMax();
+    virtual Song search(int targetScore);
+    virtual void insert(Song song);
+    virtual bool remove(string songName, Song* removed = nullptr);
+    virtual bool removeKey(int score, const string& songName);
+    virtual int size();
+    virtual MemoryUsage memoryUsage();
+    virtual vector<Song> toVector();
+    virtual bool isThreadSafe();
+
+    Snapshot snapshot() const;
+    vector<Song> searchRange(int lowerBound, int upperBound);
+    vector<Song> top(int n);
+};
+
+
+#endif //COP3530_PROJECT_3_PERSISTENTTREAP_H
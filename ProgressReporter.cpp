@@ -0,0 +1,107 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <iostream>
+
+#include "ProgressReporter.h"
+#include "Tracer.h"
+
+/**
+ * Constructor. The timer thread is not started until start() is called.
+ * @param label Text printed in front of every progress line.
+ * @param intervalMs Milliseconds between two progress lines.
+ */
+ProgressReporter::ProgressReporter(const string& label, int intervalMs)
+    : label(label), rowCount(0), expectedRows(0), interval(intervalMs), stopRequested(false) {}
+
+
+/**
+ * Destructor makes sure the timer thread is not left running.
+ */
+ProgressReporter::~ProgressReporter() {
+    stop();
+}
+
+
+/**
+ * Starts the timer thread. Rows counted before this call are included in the progress.
+ */
+void ProgressReporter::start() {
+    if (timerThread.joinable()) {
+        return; // Already running.
+    }
+    stopRequested = false;
+    startTime = chrono::steady_clock::now();
+    timerThread = thread(&ProgressReporter::run, this);
+}
+
+
+/**
+ * Stops the timer thread and prints a final progress line. Does nothing if the reporter is not running.
+ */
+void ProgressReporter::stop() {
+    if (!timerThread.joinable()) {
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(stopMutex);
+        stopRequested = true;
+    }
+    stopCondition.notify_one();
+    timerThread.join();
+
+    printProgress(); // Final line so the printed count matches the real total.
+    cout << endl;
+}
+
+
+/**
+ * Adds to the total number of rows expected. Used to work out the estimated time remaining.
+ * @param rows The number of additional rows expected.
+ */
+void ProgressReporter::addExpectedRows(long long rows) {
+    expectedRows.fetch_add(rows, memory_order_relaxed);
+}
+
+
+long long ProgressReporter::getRowCount() const {
+    return rowCount.load(memory_order_relaxed);
+}
+
+
+/**
+ * Body of the timer thread. Prints a progress line every interval until stop() is called.
+ */
+void ProgressReporter::run() {
+    traceThreadName("progress: " + label);
+    unique_lock<mutex> lock(stopMutex);
+    while (!stopCondition.wait_for(lock, interval, [this] { return stopRequested; })) {
+        printProgress();
+    }
+}
+
+
+/**
+ * Prints one progress line, overwriting the previous one.
+ */
+void ProgressReporter::printProgress() {
+    long long rows = rowCount.load(memory_order_relaxed);
+    long long expected = expectedRows.load(memory_order_relaxed);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    long long rowsPerSecond = seconds > 0 ? static_cast<long long>(rows / seconds) : 0;
+    traceCounter("rows ingested", rows); // Sampled here rather than per row, so tracing adds nothing to the hot loop.
+
+    cout << "\r" << label << ": " << rows;
+    if (expected > 0) {
+        cout << " / " << expected;
+    }
+    cout << " rows (" << rowsPerSecond << " rows/s";
+
+    // The ETA can only be estimated once the total and the current rate are both known:
+    if (expected > rows && rowsPerSecond > 0) {
+        cout << ", ETA " << (expected - rows) / rowsPerSecond << "s";
+    }
+    cout << ")    " << flush; // Trailing spaces clear leftovers from a longer previous line.
+}
@@ -0,0 +1,57 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_PROGRESSREPORTER_H
+#define COP3530_PROJECT_3_PROGRESSREPORTER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+/**
+ * Prints the progress of a long running import from a separate timer thread.
+ * The thread doing the work only increments an atomic counter. The timer thread samples the counter a few times
+ * per second and prints the rate and the estimated time remaining, so no console I/O happens on the hot path.
+ */
+class ProgressReporter {
+private:
+    string label; // Printed in front of every progress line.
+    atomic<long long> rowCount; // Number of rows processed so far. Incremented by the worker thread(s).
+    atomic<long long> expectedRows; // Total number of rows expected, or 0 if unknown.
+    chrono::milliseconds interval; // Time between two progress lines.
+    chrono::steady_clock::time_point startTime;
+
+    // Timer thread and the state used to wake it up early when stopping:
+    thread timerThread;
+    mutex stopMutex;
+    condition_variable stopCondition;
+    bool stopRequested;
+
+    void run();
+    void printProgress();
+
+public:
+    ProgressReporter(const string& label, int intervalMs = 250); // ctr
+    ~ProgressReporter(); // dtr
+
+    void start();
+    void stop();
+    void addExpectedRows(long long rows);
+    long long getRowCount() const;
+
+    /**
+     * Records that one more row has been processed. This is the only call made from the hot loop.
+     */
+    void addRow() {
+        rowCount.fetch_add(1, memory_order_relaxed);
+    }
+};
+
+
+#endif //COP3530_PROJECT_3_PROGRESSREPORTER_H
@@ -0,0 +1,255 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include "QueryProtocol.h"
+
+static const size_t MAX_STRING_BYTES = 0xFFFF; // Strings have a 2 byte length. Longer ones are cut short.
+
+Request::Request() : type(REQUEST_SIZE), firstNumber(0), secondNumber(0) {}
+
+Response::Response() : status(RESPONSE_OK), containerSize(0) {}
+
+
+// Writing fields to the end of a message:
+// =======================================
+
+static void appendUint32(string& message, uint32_t value) {
+    message += static_cast<char>((value >> 24) & 0xFF);
+    message += static_cast<char>((value >> 16) & 0xFF);
+    message += static_cast<char>((value >> 8) & 0xFF);
+    message += static_cast<char>(value & 0xFF);
+}
+
+static void appendString(string& message, const string& value) {
+    size_t length = value.size() < MAX_STRING_BYTES ? value.size() : MAX_STRING_BYTES;
+    message += static_cast<char>((length >> 8) & 0xFF);
+    message += static_cast<char>(length & 0xFF);
+    message.append(value, 0, length);
+}
+
+/**
+ * Fills in the 4 byte length at the start of a frame.
+ * @param frame The frame, which starts with FRAME_HEADER_BYTES bytes of space for the length.
+ */
+static void finishFrame(string& frame) {
+    uint32_t length = static_cast<uint32_t>(frame.size() - FRAME_HEADER_BYTES);
+    frame[0] = static_cast<char>((length >> 24) & 0xFF);
+    frame[1] = static_cast<char>((length >> 16) & 0xFF);
+    frame[2] = static_cast<char>((length >> 8) & 0xFF);
+    frame[3] = static_cast<char>(length & 0xFF);
+}
+
+
+// Reading fields from a message, stopping at the end of it:
+// ========================================================
+
+/**
+ * A position in a message body being decoded. Every read fails once the body runs out, rather than reading past it.
+ */
+struct FieldReader {
+    const unsigned char* next;
+    const unsigned char* end;
+
+    FieldReader(const char* body, size_t length)
+        : next(reinterpret_cast<const unsigned char*>(body)), end(reinterpret_cast<const unsigned char*>(body) + length) {}
+
+    bool readByte(uint8_t& value) {
+        if (end - next < 1) {
+            return false;
+        }
+        value = *next++;
+        return true;
+    }
+
+    bool readUint32(uint32_t& value) {
+        if (end - next < 4) {
+            return false;
+        }
+        value = (static_cast<uint32_t>(next[0]) << 24) | (static_cast<uint32_t>(next[1]) << 16)
+                | (static_cast<uint32_t>(next[2]) << 8) | static_cast<uint32_t>(next[3]);
+        next += 4;
+        return true;
+    }
+
+    bool readInt32(int& value) {
+        uint32_t bits;
+        if (!readUint32(bits)) {
+            return false;
+        }
+        value = static_cast<int>(static_cast<int32_t>(bits));
+        return true;
+    }
+
+    bool readString(string& value) {
+        if (end - next < 2) {
+            return false;
+        }
+        size_t length = (static_cast<size_t>(next[0]) << 8) | next[1];
+        next += 2;
+        if (static_cast<size_t>(end - next) < length) {
+            return false;
+        }
+        value.assign(reinterpret_cast<const char*>(next), length);
+        next += length;
+        return true;
+    }
+
+    bool atEnd() const {
+        return next == end;
+    }
+};
+
+
+// Public functions:
+// =================
+
+/**
+ * Encodes a request as a complete frame, ready to be sent.
+ * @param request The request.
+ * @return The frame.
+ */
+string encodeRequest(const Request& request) {
+    string frame(FRAME_HEADER_BYTES, '\0');
+    frame += static_cast<char>(request.type);
+    switch (request.type) {
+        case REQUEST_SEARCH:
+        case REQUEST_TOPK:
+            appendUint32(frame, static_cast<uint32_t>(request.firstNumber));
+            break;
+        case REQUEST_RANGE:
+            appendUint32(frame, static_cast<uint32_t>(request.firstNumber));
+            appendUint32(frame, static_cast<uint32_t>(request.secondNumber));
+            break;
+        case REQUEST_INSERT:
+            appendUint32(frame, static_cast<uint32_t>(request.firstNumber));
+            appendString(frame, request.songName);
+            break;
+        case REQUEST_REMOVE:
+            appendString(frame, request.songName);
+            break;
+        case REQUEST_SIZE:
+            break;
+    }
+    finishFrame(frame);
+    return frame;
+}
+
+
+/**
+ * Decodes the body of a request frame.
+ * @param body The body, without the 4 byte length.
+ * @param length The length of the body.
+ * @param request Populated with the request.
+ * @return true if the body is a well formed request, false if the type is unknown or the fields do not fit the body.
+ */
+bool decodeRequest(const char* body, size_t length, Request& request) {
+    FieldReader reader(body, length);
+    uint8_t type;
+    if (!reader.readByte(type)) {
+        return false;
+    }
+    request = Request();
+    request.type = static_cast<RequestType>(type);
+    bool valid;
+    switch (type) {
+        case REQUEST_SEARCH:
+        case REQUEST_TOPK:
+            valid = reader.readInt32(request.firstNumber);
+            break;
+        case REQUEST_RANGE:
+            valid = reader.readInt32(request.firstNumber) && reader.readInt32(request.secondNumber);
+            break;
+        case REQUEST_INSERT:
+            valid = reader.readInt32(request.firstNumber) && reader.readString(request.songName);
+            break;
+        case REQUEST_REMOVE:
+            valid = reader.readString(request.songName);
+            break;
+        case REQUEST_SIZE:
+            valid = true;
+            break;
+        default:
+            valid = false;
+    }
+    return valid && reader.atEnd();
+}
+
+
+/**
+ * Encodes a response as a complete frame, ready to be sent.
+ * @param response The response.
+ * @return The frame.
+ */
+string encodeResponse(const Response& response) {
+    string frame(FRAME_HEADER_BYTES, '\0');
+    frame.reserve(FRAME_HEADER_BYTES + 11 + response.songs.size() * 24 + response.message.size());
+    frame += static_cast<char>(response.status);
+    appendUint32(frame, response.containerSize);
+    appendUint32(frame, static_cast<uint32_t>(response.songs.size()));
+    for (unsigned int i = 0; i < response.songs.size(); i++) {
+        appendUint32(frame, static_cast<uint32_t>(response.songs.at(i).getScore()));
+        appendString(frame, response.songs.at(i).getName());
+    }
+    appendString(frame, response.message);
+    finishFrame(frame);
+    return frame;
+}
+
+
+/**
+ * Decodes the body of a response frame.
+ * @param body The body, without the 4 byte length.
+ * @param length The length of the body.
+ * @param response Populated with the response.
+ * @return true if the body is a well formed response, false otherwise.
+ */
+bool decodeResponse(const char* body, size_t length, Response& response) {
+    FieldReader reader(body, length);
+    uint8_t status;
+    uint32_t songCount;
+    if (!reader.readByte(status) || status > RESPONSE_ERROR || !reader.readUint32(response.containerSize)
+        || !reader.readUint32(songCount)) {
+        return false;
+    }
+    response.status = static_cast<ResponseStatus>(status);
+    response.songs.clear();
+    for (uint32_t i = 0; i < songCount; i++) {
+        int score;
+        string name;
+        if (!reader.readInt32(score) || !reader.readString(name)) {
+            return false;
+        }
+        response.songs.push_back(Song(name, score));
+    }
+    return reader.readString(response.message) && reader.atEnd();
+}
+
+
+/**
+ * Reads the length at the start of a frame.
+ * @param header The first FRAME_HEADER_BYTES bytes of the frame.
+ * @return The length of the body that follows.
+ */
+uint32_t readFrameLength(const char* header) {
+    FieldReader reader(header, FRAME_HEADER_BYTES);
+    uint32_t length = 0;
+    reader.readUint32(length);
+    return length;
+}
+
+
+/**
+ * Gets the name of a request type, as used by the client's commands.
+ */
+const char* requestTypeName(RequestType type) {
+    switch (type) {
+        case REQUEST_SEARCH: return "search";
+        case REQUEST_RANGE: return "range";
+        case REQUEST_TOPK: return "topk";
+        case REQUEST_INSERT: return "insert";
+        case REQUEST_REMOVE: return "remove";
+        case REQUEST_SIZE: return "size";
+    }
+    return "unknown";
+}
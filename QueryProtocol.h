@@ -0,0 +1,83 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_QUERYPROTOCOL_H
+#define COP3530_PROJECT_3_QUERYPROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Song.h"
+
+using namespace std;
+
+/**
+ * The binary protocol spoken between QueryServer and its clients.
+ *
+ * Every message is a frame: a 4 byte length, then that many bytes of body. All integers are big-endian (network byte
+ * order), and a string is a 2 byte length followed by its bytes. A client sends request frames and gets exactly one
+ * response frame per request, in the order the requests were sent, so it may send several before reading any.
+ *
+ * Request body: 1 byte request type, then
+ *   search  <int32 score>
+ *   range   <int32 min score> <int32 max score>
+ *   topk    <int32 n>
+ *   insert  <int32 score> <string song id>
+ *   remove  <string song id>
+ *   size    (nothing)
+ *
+ * Response body: 1 byte status, <uint32 container size after the request>, <uint32 song count>, then each song as
+ * <int32 score> <string song id>, and last a <string message> (empty unless the status is an error).
+ */
+
+// Frames longer than these are refused. A request is only ever a few bytes plus a song id:
+const uint32_t MAX_REQUEST_BYTES = 1 << 17;
+const uint32_t MAX_RESPONSE_BYTES = 1u << 31;
+const size_t FRAME_HEADER_BYTES = 4;
+
+enum RequestType {
+    REQUEST_SEARCH = 1,
+    REQUEST_RANGE = 2,
+    REQUEST_TOPK = 3,
+    REQUEST_INSERT = 4,
+    REQUEST_REMOVE = 5,
+    REQUEST_SIZE = 6
+};
+
+enum ResponseStatus {
+    RESPONSE_OK = 0,
+    RESPONSE_NOT_FOUND = 1, // A search found no song with the score, or a remove found no song with the id.
+    RESPONSE_ERROR = 2 // The request could not be understood. The message says why.
+};
+
+struct Request {
+    RequestType type;
+    int firstNumber; // The score, minimum score or n.
+    int secondNumber; // The maximum score of a range.
+    string songName;
+
+    Request(); // ctr
+};
+
+struct Response {
+    ResponseStatus status;
+    uint32_t containerSize;
+    vector<Song> songs;
+    string message;
+
+    Response(); // ctr
+};
+
+// Encoding and decoding. See the .cpp implementation file:
+string encodeRequest(const Request& request);
+bool decodeRequest(const char* body, size_t length, Request& request);
+string encodeResponse(const Response& response);
+bool decodeResponse(const char* body, size_t length, Response& response);
+uint32_t readFrameLength(const char* header);
+const char* requestTypeName(RequestType type);
+
+
+#endif //COP3530_PROJECT_3_QUERYPROTOCOL_H
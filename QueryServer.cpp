@@ -0,0 +1,432 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "AsyncOperations.h"
+#include "ContainerOperations.h"
+#include "PersistentTreap.h"
+#include "QueryServer.h"
+#include "Tracer.h"
+
+static const unsigned int REPLAY_CHANGES_PER_SLICE = 4096; // Logged changes made between yields while loading.
+
+/**
+ * Constructor. Nothing is opened until start().
+ * @param container The container requests are answered from.
+ * @param socketPath The file system path of the Unix domain socket to listen on.
+ */
+QueryServer::QueryServer(SongContainer* container, const string& socketPath)
+    : container(container), socketPath(socketPath), listenFd(-1), wakeFd(-1), commitFd(-1), loaded(true), changeLog(nullptr),
+      requestsServed(0), clientsServed(0) {}
+
+
+const string& QueryServer::getError() const {
+    return error;
+}
+
+
+long long QueryServer::getRequestsServed() const {
+    return requestsServed;
+}
+
+
+long long QueryServer::getClientsServed() const {
+    return clientsServed;
+}
+
+
+const OperationLatencies& QueryServer::getLatencies() const {
+    return latencies;
+}
+
+
+/**
+ * Logs every insert and remove from now on, and makes the changes already in the log once the songs are loaded (see
+ * loadInBackground()). The files to load should be the log's base, if it has one. Call after start() and before
+ * loadInBackground().
+ * @param changeLog The open log. Must stay open until the server is destroyed.
+ * @param changes The changes read back from the log.
+ */
+void QueryServer::useLog(WriteAheadLog* changeLog, const vector<LogChange>& changes) {
+    this->changeLog = changeLog;
+    replayChanges = changes;
+    changeLog->setCommitNotifier(commitFd);
+}
+
+
+/**
+ * Waits until a log record has been written. Awaited by a request before it answers an insert or remove.
+ * @param position The record's position, as returned by WriteAheadLog::logInsert() or logRemove().
+ * @return The awaiter.
+ */
+QueryServer::CommitAwaiter QueryServer::committed(uint64_t position) {
+    return CommitAwaiter{this, position};
+}
+
+
+/**
+ * Loads the container from database or snapshot files while the server runs, instead of before it starts. Requests
+ * that arrive before the load has finished get an error response saying so. Call after start() and before run().
+ * @param filepaths The paths to the SQLite database or snapshot files.
+ * @param policy How to combine the scores of a track that appears in more than one file.
+ */
+void QueryServer::loadInBackground(const vector<string>& filepaths, MergePolicy policy) {
+    loaded = false;
+    executor.spawn(loadSongs(filepaths, policy));
+}
+
+
+/**
+ * Reads the songs a slice of rows at a time, so the clients keep being answered between slices, then builds the
+ * container on a helper thread and makes the changes read back from the log, if there is one. Requests are refused until
+ * it is done, so nothing else touches the container meanwhile. If a file cannot be read, the server stops.
+ */
+Task<void> QueryServer::loadSongs(vector<string> filepaths, MergePolicy policy) {
+    chrono::high_resolution_clock::time_point startTime = chrono::high_resolution_clock::now();
+    TrackScoreMap songScores;
+    if (!co_await loadAsync(executor, filepaths, songScores, policy)) {
+        error = "could not read database";
+        executor.stop();
+        co_return;
+    }
+    co_await buildAsync(executor, container, songScores.getSongs());
+    for (unsigned int i = 0; i < replayChanges.size(); i++) {
+        applyLogChange(container, replayChanges.at(i));
+        if (i % REPLAY_CHANGES_PER_SLICE == REPLAY_CHANGES_PER_SLICE - 1) {
+            co_await executor.yield();
+        }
+    }
+    if (changeLog != nullptr) {
+        changeLog->logBase(filepaths, policy); // Only recorded by a new log. An existing one already has its base.
+        cout << "Replayed " << replayChanges.size() << " changes from the log." << endl;
+        replayChanges = vector<LogChange>();
+    }
+    loaded = true;
+    chrono::high_resolution_clock::time_point endTime = chrono::high_resolution_clock::now();
+    traceCounter("container size", container->size());
+    cout << "Loaded " << container->size() << " songs in "
+         << chrono::duration_cast<chrono::milliseconds>(endTime - startTime).count() << " ms." << endl;
+}
+
+
+/**
+ * Answers one request from the container, timing the container operation. A range search yields to the other clients
+ * between slices of scores, however wide its range, so its time includes theirs.
+ * @param request The request.
+ * @return The response to send back.
+ */
+Task<Response> QueryServer::answer(Request request) {
+    Response response;
+    if (!loaded) {
+        response.status = RESPONSE_ERROR;
+        response.message = "still loading";
+        co_return response;
+    }
+    TimedOperation operation = TIMED_SIZE;
+    uint64_t logPosition = 0; // The change's log record, if the request made one.
+    chrono::high_resolution_clock::time_point startTime = chrono::high_resolution_clock::now();
+
+    if (request.type == REQUEST_SEARCH) {
+        operation = TIMED_SEARCH;
+        Song song = container->search(request.firstNumber);
+        if (song.getName().empty()) {
+            response.status = RESPONSE_NOT_FOUND;
+        }
+        else {
+            response.songs.push_back(song);
+        }
+    }
+    else if (request.type == REQUEST_RANGE) {
+        operation = TIMED_RANGE;
+        response.songs = co_await rangeSearchAsync(executor, container, request.firstNumber, request.secondNumber);
+    }
+    else if (request.type == REQUEST_TOPK) {
+        // Clients share the container, so the songs are put straight back rather than removed for good. No other request
+        // runs in between, so no client ever sees them missing:
+        operation = TIMED_EXTRACT;
+        PersistentTreap* treap = dynamic_cast<PersistentTreap*>(container);
+        if (request.firstNumber < 0) {
+            response.status = RESPONSE_ERROR;
+            response.message = "n must not be negative";
+        }
+        else if (treap != nullptr) {
+            response.songs = treap->top(request.firstNumber); // Read from one snapshot, which never changes the tree.
+        }
+        else {
+            response.songs = extractTop(container, request.firstNumber);
+            for (unsigned int i = 0; i < response.songs.size(); i++) {
+                container->insert(response.songs.at(i));
+            }
+        }
+    }
+    else if (request.type == REQUEST_INSERT) {
+        operation = TIMED_INSERT;
+        if (request.songName.empty()) {
+            response.status = RESPONSE_ERROR;
+            response.message = "song id must not be empty";
+        }
+        else {
+            container->insert(Song(request.songName, request.firstNumber));
+            if (changeLog != nullptr) {
+                logPosition = changeLog->logInsert(Song(request.songName, request.firstNumber));
+            }
+        }
+    }
+    else if (request.type == REQUEST_REMOVE) {
+        operation = TIMED_REMOVE;
+        Song removed;
+        if (!container->remove(request.songName, &removed)) {
+            response.status = RESPONSE_NOT_FOUND;
+        }
+        else if (changeLog != nullptr) {
+            logPosition = changeLog->logRemove(removed);
+        }
+    }
+    response.containerSize = static_cast<uint32_t>(container->size());
+
+    chrono::high_resolution_clock::time_point endTime = chrono::high_resolution_clock::now();
+    latencies.record(operation, chrono::duration_cast<chrono::nanoseconds>(endTime - startTime).count());
+    traceSpan(requestTypeName(request.type), "query", startTime, endTime);
+    requestsServed++;
+
+    // Compaction stops every client while it writes the snapshot, but only happens once per compaction size of changes:
+    if (changeLog != nullptr && changeLog->needsCompaction() && !changeLog->compact(container)) {
+        cerr << "Could not compact the log: " << changeLog->getError() << endl;
+    }
+
+    // Only acknowledge a change once it is in the log, letting the other clients run meanwhile:
+    if (logPosition != 0) {
+        co_await committed(logPosition);
+        if (!changeLog->getError().empty()) {
+            response.status = RESPONSE_ERROR;
+            response.message = "the change was made but could not be logged";
+        }
+    }
+    co_return response;
+}
+
+
+#ifdef __linux__
+
+/**
+ * Destructor. Disconnects every client and removes the socket file.
+ */
+QueryServer::~QueryServer() {
+    if (listenFd != -1) {
+        close(listenFd);
+        unlink(socketPath.c_str());
+    }
+    if (wakeFd != -1) {
+        close(wakeFd);
+    }
+    if (commitFd != -1) {
+        if (changeLog != nullptr) {
+            changeLog->setCommitNotifier(-1);
+        }
+        close(commitFd);
+    }
+}
+
+
+/**
+ * Creates the socket and starts listening. A socket file left behind by a server that is no longer running is
+ * replaced; one that a running server still answers on is not.
+ * @return true if the server is listening, false otherwise (see getError()).
+ */
+bool QueryServer::start() {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+        error = "socket path must be 1 to " + to_string(sizeof(address.sun_path) - 1) + " characters long";
+        return false;
+    }
+    strcpy(address.sun_path, socketPath.c_str());
+
+    // Replace a stale socket file, but never one a running server is using:
+    struct stat fileStatus;
+    if (stat(socketPath.c_str(), &fileStatus) == 0) {
+        if (!S_ISSOCK(fileStatus.st_mode)) {
+            error = socketPath + " already exists and is not a socket";
+            return false;
+        }
+        int probeFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        bool inUse = probeFd != -1 && connect(probeFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+        if (probeFd != -1) {
+            close(probeFd);
+        }
+        if (inUse) {
+            error = "another server is already listening on " + socketPath;
+            return false;
+        }
+        unlink(socketPath.c_str());
+    }
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd == -1 || bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1
+        || listen(listenFd, SOMAXCONN) == -1) {
+        error = string("could not listen on ") + socketPath + ": " + strerror(errno);
+        if (listenFd != -1) {
+            close(listenFd);
+            listenFd = -1;
+        }
+        return false;
+    }
+
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd == -1) {
+        error = string("could not create the stop signal: ") + strerror(errno);
+        return false;
+    }
+    commitFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (commitFd == -1) {
+        error = string("could not create the commit signal: ") + strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * Serves clients until stop() is called, or a background load fails. Must be called after a successful start().
+ * Clients still connected when it returns are disconnected when the server is destroyed.
+ */
+void QueryServer::run() {
+    traceThreadName("query server");
+    executor.spawn(waitForStop());
+    executor.spawn(acceptClients());
+    if (changeLog != nullptr) {
+        executor.spawn(watchCommits());
+    }
+    executor.run();
+}
+
+
+/**
+ * Makes run() return. Only writes to an eventfd, so it is safe to call from a signal handler or another thread.
+ */
+void QueryServer::stop() {
+    if (wakeFd != -1) {
+        uint64_t one = 1;
+        ssize_t written = write(wakeFd, &one, sizeof(one));
+        (void) written; // The counter can only fail to take the write if it is already nonzero, which wakes run() too.
+    }
+}
+
+
+/**
+ * Waits for stop() to be called, then stops the executor.
+ */
+Task<void> QueryServer::waitForStop() {
+    co_await executor.readable(wakeFd);
+    executor.stop();
+}
+
+
+/**
+ * Resumes the requests waiting for their log records each time the log's committer finishes a batch.
+ */
+Task<void> QueryServer::watchCommits() {
+    while (true) {
+        co_await executor.readable(commitFd);
+        uint64_t batches;
+        ssize_t bytesRead = read(commitFd, &batches, sizeof(batches));
+        (void) bytesRead; // Reading resets the counter. Only the number of records written matters:
+        uint64_t written = changeLog->getWrittenRecords();
+        while (!commitWaiters.empty() && commitWaiters.front().position <= written) {
+            executor.schedule(commitWaiters.front().handle);
+            commitWaiters.pop_front();
+        }
+    }
+}
+
+
+/**
+ * Accepts clients for as long as the server runs, starting a task for each.
+ */
+Task<void> QueryServer::acceptClients() {
+    while (true) {
+        co_await executor.readable(listenFd);
+        int fd;
+        // Take every client waiting to connect. Stops at EAGAIN, or at an error that only affects one client:
+        while ((fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) != -1) {
+            clientsServed++;
+            executor.spawn(serveClient(fd));
+        }
+    }
+}
+
+
+/**
+ * Answers one client's requests, one at a time, until it hangs up or sends something that is not a request frame.
+ * @param fd The client's socket. Closed when the task ends, or is destroyed with the server.
+ */
+Task<void> QueryServer::serveClient(int fd) {
+    struct ClientSocket {
+        int fd;
+
+        ~ClientSocket() {
+            close(fd);
+        }
+    };
+    ClientSocket client{fd};
+
+    char header[FRAME_HEADER_BYTES];
+    string body;
+    while (co_await executor.receiveAll(fd, header, FRAME_HEADER_BYTES)) {
+        uint32_t length = readFrameLength(header);
+        if (length > MAX_REQUEST_BYTES) {
+            co_return; // Not a client of this protocol. There is no telling where its next frame starts.
+        }
+        body.resize(length);
+        if (!co_await executor.receiveAll(fd, &body[0], length)) {
+            co_return;
+        }
+
+        Request request;
+        Response response;
+        if (decodeRequest(body.data(), length, request)) {
+            response = co_await answer(request);
+        }
+        else {
+            response.status = RESPONSE_ERROR;
+            response.message = "malformed request";
+            response.containerSize = loaded ? static_cast<uint32_t>(container->size()) : 0;
+        }
+        if (!co_await executor.sendAll(fd, encodeResponse(response))) {
+            co_return;
+        }
+        co_await executor.yield(); // Take turns with the other clients, even if this one has more requests waiting.
+    }
+}
+
+#else
+
+QueryServer::~QueryServer() {}
+
+bool QueryServer::start() {
+    error = "the query server needs Unix domain sockets, which are only supported on Linux";
+    return false;
+}
+
+void QueryServer::run() {}
+void QueryServer::stop() {}
+Task<void> QueryServer::waitForStop() { co_return; }
+Task<void> QueryServer::watchCommits() { co_return; }
+Task<void> QueryServer::acceptClients() { co_return; }
+Task<void> QueryServer::serveClient(int) { co_return; }
+
+#endif
@@ -0,0 +1,102 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_QUERYSERVER_H
+#define COP3530_PROJECT_3_QUERYSERVER_H
+
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "AsyncExecutor.h"
+#include "AsyncTask.h"
+#include "OperationLatencies.h"
+#include "QueryProtocol.h"
+#include "SongContainer.h"
+#include "TrackScoreMap.h"
+#include "WriteAheadLog.h"
+
+using namespace std;
+
+/**
+ * Answers search, range, topk, insert, remove and size requests from many clients over a Unix domain socket, so that
+ * a container loaded once can be queried by any number of jobs. See QueryProtocol.h for the messages.
+ *
+ * Everything runs as coroutines on one thread (see AsyncExecutor.h): one task accepts connections, each client gets a
+ * task that reads a request, answers it and writes the response, and the songs can be loaded by another task while the
+ * server is already listening. A task waiting for its client's next request, or for room to write a response, hands
+ * the thread to the others, so a slow client only holds up its own responses. Each client's requests are answered in
+ * the order they were sent, and a client takes turns with the others after each one. Linux only.
+ *
+ * Given a WriteAheadLog (see useLog()), the server replays the log's changes after loading and logs every insert and
+ * remove it answers, so a restarted server picks up where the last one stopped. An insert or remove is only answered
+ * once the log's committer has written the batch holding it, so a client is never told about a change a crash could
+ * still lose. The request's task waits for that without holding up the others, and every request in a batch shares
+ * its one write and sync, so an acknowledged change costs up to the commit interval plus a sync in latency but no
+ * extra system calls.
+ */
+class QueryServer {
+private:
+    SongContainer* container; // The container requests are answered from. Not owned.
+    string socketPath;
+    int listenFd;
+    int wakeFd; // An eventfd written by stop(), which wakes the task that stops the executor.
+    int commitFd; // An eventfd the log's committer writes after each batch (see WriteAheadLog::setCommitNotifier()).
+    AsyncExecutor executor;
+    bool loaded; // false while a background load is running. Requests get an error response until it finishes.
+    OperationLatencies latencies; // Latency of every request answered so far, by operation.
+    WriteAheadLog* changeLog; // Where inserts and removes are logged, or nullptr. Not owned.
+    vector<LogChange> replayChanges; // Changes read back from the log, made once the songs are loaded.
+    long long requestsServed;
+    long long clientsServed;
+    string error;
+
+    /**
+     * A request waiting for the log record of its change to be written.
+     */
+    struct CommitWaiter {
+        uint64_t position; // The record's position, as returned by WriteAheadLog::logInsert() or logRemove().
+        coroutine_handle<> handle;
+    };
+    deque<CommitWaiter> commitWaiters; // In order of position, since records are only appended from this thread.
+
+    /**
+     * Awaited by committed(): suspends the awaiting coroutine until watchCommits() sees its record written.
+     */
+    struct CommitAwaiter {
+        QueryServer* server;
+        uint64_t position;
+
+        bool await_ready() { return server->commitFd == -1 || server->changeLog->getWrittenRecords() >= position; }
+        void await_suspend(coroutine_handle<> handle) { server->commitWaiters.push_back(CommitWaiter{position, handle}); }
+        void await_resume() noexcept {}
+    };
+
+    CommitAwaiter committed(uint64_t position);
+    Task<void> watchCommits();
+    Task<void> acceptClients();
+    Task<void> serveClient(int fd);
+    Task<void> waitForStop();
+    Task<void> loadSongs(vector<string> filepaths, MergePolicy policy);
+    Task<Response> answer(Request request);
+
+public:
+    QueryServer(SongContainer* container, const string& socketPath); // ctr
+    ~QueryServer(); // dtr
+
+    bool start();
+    void useLog(WriteAheadLog* changeLog, const vector<LogChange>& changes);
+    void loadInBackground(const vector<string>& filepaths, MergePolicy policy);
+    void run();
+    void stop();
+    const string& getError() const;
+    long long getRequestsServed() const;
+    long long getClientsServed() const;
+    const OperationLatencies& getLatencies() const;
+};
+
+
+#endif //COP3530_PROJECT_3_QUERYSERVER_H
@@ -0,0 +1,317 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <queue>
+#include <thread>
+
+#include "ContainerOperations.h"
+#include "ParallelBuild.h"
+#include "ShardedContainer.h"
+
+/**
+ * Constructor.
+ * @param innerKind The kind of container each shard uses ("heap" or "splay", see createContainer).
+ * @param shardCount The number of shards. Values below 1 are treated as 1.
+ */
+ShardedContainer::ShardedContainer(const string& innerKind, int shardCount) : innerKind(innerKind) {
+    if (shardCount < 1) {
+        shardCount = 1;
+    }
+    for (int i = 0; i < shardCount; i++) {
+        Shard* shard = new Shard();
+        shard->container = createContainer(innerKind);
+        shards.push_back(shard);
+    }
+}
+
+
+/**
+ * Destructor. Deletes every shard and the songs in it.
+ */
+ShardedContainer::~ShardedContainer() {
+    for (unsigned int i = 0; i < shards.size(); i++) {
+        delete shards.at(i)->container;
+        delete shards.at(i);
+    }
+}
+
+
+/**
+ * Picks the shard a song belongs to, using the FNV-1a hash of its track ID.
+ * Every track ID starts with "TR", so the whole ID is hashed rather than just its first characters.
+ * @param songName The song's track ID.
+ * @return The index of the song's shard.
+ */
+unsigned int ShardedContainer::shardIndex(const string& songName) const {
+    unsigned long long hash = 14695981039346656037ULL;
+    for (unsigned int i = 0; i < songName.size(); i++) {
+        hash ^= static_cast<unsigned char>(songName[i]);
+        hash *= 1099511628211ULL;
+    }
+    return static_cast<unsigned int>(hash % shards.size());
+}
+
+
+/**
+ * Locks every shard, always in index order so two threads doing this can never deadlock.
+ */
+void ShardedContainer::lockAll() {
+    for (unsigned int i = 0; i < shards.size(); i++) {
+        shards.at(i)->lock.lock();
+    }
+}
+
+
+/**
+ * Unlocks every shard locked by lockAll().
+ */
+void ShardedContainer::unlockAll() {
+    for (unsigned int i = shards.size(); i > 0; i--) {
+        shards.at(i - 1)->lock.unlock();
+    }
+}
+
+
+/**
+ * Finds the shard holding the highest scoring song. The caller must hold every shard's lock.
+ * Ties go to the lowest shard index, so the result does not depend on timing.
+ * @return The index of the shard, or -1 if every shard is empty.
+ */
+int ShardedContainer::maxShard() {
+    int best = -1;
+    int bestScore = 0;
+    for (unsigned int i = 0; i < shards.size(); i++) {
+        if (shards.at(i)->container->size() > 0) {
+            int score = shards.at(i)->container->peekMax().getScore();
+            if (best == -1 || score > bestScore) {
+                best = static_cast<int>(i);
+                bestScore = score;
+            }
+        }
+    }
+    return best;
+}
+
+
+/**
+ * Builds every shard from a set of songs. The songs are split by shard first, then the shards are built in parallel.
+ * @param inputSongs The songs to populate the container with.
+ */
+void ShardedContainer::build(vector<Song>& inputSongs) {
+    vector<vector<Song>> shardSongs(shards.size());
+    for (unsigned int i = 0; i < shardSongs.size(); i++) {
+        shardSongs.at(i).reserve(inputSongs.size() / shards.size() + 1);
+    }
+    for (unsigned int i = 0; i < inputSongs.size(); i++) {
+        shardSongs.at(shardIndex(inputSongs.at(i).getName())).push_back(inputSongs.at(i));
+    }
+
+    // One thread per shard. Each holds its shard's lock, so other threads simply wait for the build to finish. The
+    // shards' own builds run on these threads rather than starting more (see parallelBuildThreads):
+    parallelFor(shards.size(), shards.size(), [this, &shardSongs](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) {
+            lock_guard<mutex> lock(shards.at(i)->lock);
+            shards.at(i)->container->build(shardSongs.at(i));
+        }
+    });
+}
+
+
+/**
+ * Removes the highest scoring song of any shard.
+ * @return A copy of the Song that was removed, or an empty Song if the container is empty.
+ */
+Song ShardedContainer::extractMax() {
+    lockAll();
+    int best = maxShard();
+    Song output = best == -1 ? Song() : shards.at(best)->container->extractMax();
+    unlockAll();
+    return output;
+}
+
+
+/**
+ * Gets the highest scoring song of any shard without removing it.
+ * @return A copy of the Song, or an empty Song if the container is empty.
+ */
+Song ShardedContainer::peekMax() {
+    lockAll();
+    int best = maxShard();
+    Song output = best == -1 ? Song() : shards.at(best)->container->peekMax();
+    unlockAll();
+    return output;
+}
+
+
+/**
+ * Removes the n highest scoring songs with a k-way merge: the maximum of each shard goes into a small heap, and each
+ * time one is taken, that shard's next maximum replaces it. Every shard stays locked for the whole merge, so the
+ * result is exactly the top n at the moment the call started.
+ * @param n The number of songs to remove. Stops early if the container runs out of songs.
+ * @return The removed songs, highest score first.
+ */
+vector<Song> ShardedContainer::extractTop(int n) {
+    // Score and shard of each shard's current maximum. Lower shard indexes win ties, like maxShard():
+    typedef pair<int, int> ShardMax; // (score, -shard index)
+    priority_queue<ShardMax> maxima;
+
+    vector<Song> results;
+    lockAll();
+    for (unsigned int i = 0; i < shards.size(); i++) {
+        if (shards.at(i)->container->size() > 0) {
+            maxima.push(ShardMax(shards.at(i)->container->peekMax().getScore(), -static_cast<int>(i)));
+        }
+    }
+    while (static_cast<int>(results.size()) < n && !maxima.empty()) {
+        int index = -maxima.top().second;
+        SongContainer* shard = shards.at(index)->container;
+        maxima.pop();
+        results.push_back(shard->extractMax());
+        if (shard->size() > 0) {
+            maxima.push(ShardMax(shard->peekMax().getScore(), -index));
+        }
+    }
+    unlockAll();
+    return results;
+}
+
+
+/**
+ * Searches every shard in order for a song with the given score. Only one shard is locked at a time.
+ * @param targetScore The score to search for.
+ * @return A copy of the first Song found, or an empty Song if no shard has the score.
+ */
+Song ShardedContainer::search(int targetScore) {
+    for (unsigned int i = 0; i < shards.size(); i++) {
+        lock_guard<mutex> lock(shards.at(i)->lock);
+        Song result = shards.at(i)->container->search(targetScore);
+        if (!result.getName().empty()) {
+            return result;
+        }
+    }
+    return Song();
+}
+
+
+/**
+ * Inserts a song into its shard. Only that shard is locked.
+ * @param song The song to insert.
+ */
+void ShardedContainer::insert(Song song) {
+    Shard* shard = shards.at(shardIndex(song.getName()));
+    lock_guard<mutex> lock(shard->lock);
+    shard->container->insert(move(song));
+}
+
+
+/**
+ * Removes a song from its shard. Only that shard is locked, and only that shard is searched.
+ * @param songName The track ID of the song to remove.
+ * @param removed If not nullptr, receives a copy of the song that was removed.
+ * @return true if the song was found and removed, false otherwise.
+ */
+bool ShardedContainer::remove(string songName, Song* removed) {
+    Shard* shard = shards.at(shardIndex(songName));
+    lock_guard<mutex> lock(shard->lock);
+    return shard->container->remove(move(songName), removed);
+}
+
+
+/**
+ * Removes the song with both the given score and track ID from its shard. Only that shard is locked.
+ * @param score The song's score.
+ * @param songName The song's track ID.
+ * @return true if the song was found and removed, false otherwise.
+ */
+bool ShardedContainer::removeKey(int score, const string& songName) {
+    Shard* shard = shards.at(shardIndex(songName));
+    lock_guard<mutex> lock(shard->lock);
+    return shard->container->removeKey(score, songName);
+}
+
+
+/**
+ * Counts the songs in every shard. Shards are locked one at a time, so with other threads running the total is only
+ * a snapshot.
+ * @return The number of songs.
+ */
+int ShardedContainer::size() {
+    int total = 0;
+    for (unsigned int i = 0; i < shards.size(); i++) {
+        lock_guard<mutex> lock(shards.at(i)->lock);
+        total += shards.at(i)->container->size();
+    }
+    return total;
+}
+
+
+/**
+ * Measures the memory used by every shard, plus the shards themselves.
+ * @return The breakdown of the container's memory.
+ */
+MemoryUsage ShardedContainer::memoryUsage() {
+    MemoryUsage usage;
+    for (unsigned int i = 0; i < shards.size(); i++) {
+        MemoryUsage shardUsage;
+        {
+            lock_guard<mutex> lock(shards.at(i)->lock);
+            shardUsage = shards.at(i)->container->memoryUsage();
+        }
+        usage.songCount += shardUsage.songCount;
+        usage.structureBytes += shardUsage.structureBytes;
+        usage.stringHeapBytes += shardUsage.stringHeapBytes;
+        usage.slackBytes += shardUsage.slackBytes;
+        usage.allocatorOverheadBytes += shardUsage.allocatorOverheadBytes;
+        usage.allocationCount += shardUsage.allocationCount;
+    }
+
+    // The shard list and every shard are allocations of their own:
+    usage.structureBytes += shards.size() * sizeof(Shard*) + shards.size() * sizeof(Shard);
+    usage.addAllocation(shards.capacity() * sizeof(Shard*));
+    for (unsigned int i = 0; i < shards.size(); i++) {
+        usage.addAllocation(sizeof(Shard));
+    }
+    usage.slackBytes += (shards.capacity() - shards.size()) * sizeof(Shard*);
+    return usage;
+}
+
+
+/**
+ * Copies every song, one shard at a time. Each shard is only locked while its songs are copied.
+ * @return The songs, shard by shard.
+ */
+vector<Song> ShardedContainer::toVector() {
+    vector<Song> songs;
+    for (unsigned int i = 0; i < shards.size(); i++) {
+        lock_guard<mutex> lock(shards.at(i)->lock);
+        vector<Song> shardSongs = shards.at(i)->container->toVector();
+        songs.insert(songs.end(), shardSongs.begin(), shardSongs.end());
+    }
+    return songs;
+}
+
+
+bool ShardedContainer::isThreadSafe() {
+    return true;
+}
+
+
+int ShardedContainer::getShardCount() const {
+    return static_cast<int>(shards.size());
+}
+
+
+const string& ShardedContainer::getInnerKind() const {
+    return innerKind;
+}
+
+
+/**
+ * Gets the number of shards used when none is given: a few per hardware thread, so that threads rarely share one.
+ * @return The default number of shards.
+ */
+int ShardedContainer::defaultShardCount() {
+    unsigned int threads = thread::hardware_concurrency();
+    return threads == 0 ? 4 : static_cast<int>(threads) * 4;
+}
@@ -0,0 +1,68 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_SHARDEDCONTAINER_H
+#define COP3530_PROJECT_3_SHARDEDCONTAINER_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Song.h"
+#include "SongContainer.h"
+
+using namespace std;
+
+/**
+ * A container that can be used from several threads at once.
+ *
+ * Songs are split across a number of inner containers (shards) by a hash of their track ID, and each shard has its own
+ * lock. Inserts and removes only lock the one shard the song belongs to, so threads working on different shards never
+ * wait for each other. extractMax() compares the maximum of every shard, so it locks them all (always in shard order,
+ * which rules out deadlocks). search() returns the first song found with the score, checking the shards in order.
+ */
+class ShardedContainer : public SongContainer {
+private:
+    /**
+     * One inner container and the lock that guards it.
+     */
+    struct Shard {
+        SongContainer* container;
+        mutex lock;
+    };
+
+    vector<Shard*> shards;
+    string innerKind; // Name of the inner containers, as given to createContainer.
+
+    unsigned int shardIndex(const string& songName) const;
+    void lockAll();
+    void unlockAll();
+    int maxShard(); // Shard with the highest scoring song. Every shard must be locked.
+
+public:
+    ShardedContainer(const string& innerKind, int shardCount); // ctr
+    virtual ~ShardedContainer(); // dtr
+
+    // Overridden functions. See the .cpp implementation file:
+    virtual void build(vector<Song>& inputSongs);
+    virtual Song extractMax();
+    virtual Song peekMax();
+    virtual Song search(int targetScore);
+    virtual void insert(Song song);
+    virtual bool remove(string songName, Song* removed = nullptr);
+    virtual bool removeKey(int score, const string& songName);
+    virtual int size();
+    virtual MemoryUsage memoryUsage();
+    virtual vector<Song> toVector();
+    virtual bool isThreadSafe();
+
+    vector<Song> extractTop(int n);
+    int getShardCount() const;
+    const string& getInnerKind() const;
+
+    static int defaultShardCount();
+};
+
+
+#endif //COP3530_PROJECT_3_SHARDEDCONTAINER_H
@@ -5,7 +5,7 @@
 #include "Song.h"
 
 // Accessors:
-string Song::getName() const {
+const string& Song::getName() const {
     return name;
 }
 
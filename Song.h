@@ -19,7 +19,7 @@ private:
 
 public:
     // Accessors:
-    string getName() const;
+    const string& getName() const;
     int getScore() const;
 
     // Mutators:
@@ -7,6 +7,8 @@
 
 #include <vector>
 
+#include "MemoryUsage.h"
+
 /**
  * Abstract base class for the SplayTree and MaxHeap classes.
  * Enables use of polymorphism in the main method of the program.
@@ -16,10 +18,19 @@ public:
     // All method are pure virtual and should be overridden by subclasses:
     virtual void build(std::vector<Song>& inputSongs) = 0;
     virtual Song extractMax() = 0;
+    virtual Song peekMax() = 0; // Highest scoring song, without removing it.
     virtual Song search(int targetScore) = 0;
     virtual void insert(Song song) = 0;
-    virtual bool remove(string songName) = 0;
+    virtual bool remove(string songName, Song* removed = nullptr) = 0; // By track ID. Copies the song to 'removed'.
+    virtual bool removeKey(int score, const string& songName) = 0; // Exactly the song with this score and track ID.
     virtual int size() = 0;
+    virtual MemoryUsage memoryUsage() = 0; // Bytes used by the container, broken down by category.
+    virtual std::vector<Song> toVector() = 0; // Copy of every song, in no particular order.
+
+    // Whether the container can be used from several threads at once (e.g. ShardedContainer and LockFreeSkipList can):
+    virtual bool isThreadSafe() { return false; }
+
+    virtual ~SongContainer() {} // Virtual so that subclasses are destroyed correctly through a base class pointer.
 };
 
 
@@ -0,0 +1,735 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "ProgressReporter.h"
+#include "SongDatabase.h"
+#include "SongSnapshot.h"
+#include "TopKHeap.h"
+#include "Tracer.h"
+// Please note: the below import sqlite3.h is not my code. It is a header file required for using the sqlite3 dll. Source: https://www.sqlite.org/download.html (taken from the amalgamation file).
+#include "sqlite3.h"
+
+using namespace std;
+
+// The query used to read the word counts that make up the narcissism score:
+static const char* SELECT_QUERY = "SELECT track_id, word, count FROM lyrics WHERE word IN ('i', 'me', 'my')";
+
+
+/**
+ * Default constructor gives the bulk read profile.
+ * A 32 bit process does not have the address space to map a large database, so the mmap limit is lower there.
+ */
+SqliteReadProfile::SqliteReadProfile()
+    : maxMmapBytes(sizeof(void*) >= 8 ? 4LL * 1024 * 1024 * 1024 : 256LL * 1024 * 1024),
+      cacheKibibytes(64 * 1024),
+      memoryTempStore(true),
+      offerIndexBuild(true) {}
+
+
+/**
+ * Gets the path of the copy of a database that has a covering index for the ingest query.
+ * @param dbFilepath The path to the original SQLite database file.
+ * @return The path of the sidecar copy.
+ */
+string sidecarIndexPath(const char* dbFilepath) {
+    return string(dbFilepath) + ".bulkread.db";
+}
+
+
+/**
+ * Runs a query that returns a single integer.
+ * @param connection An open database connection.
+ * @param query The SQL query to run.
+ * @param result Populated with the first column of the first row.
+ * @return true if the query produced a row, false otherwise.
+ */
+static bool queryInt64(sqlite3* connection, const char* query, long long& result) {
+    sqlite3_stmt* stmt;
+    bool success = false;
+    if (sqlite3_prepare_v2(connection, query, -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+        result = sqlite3_column_int64(stmt, 0);
+        success = true;
+    }
+    sqlite3_finalize(stmt);
+    return success;
+}
+
+
+/**
+ * Opens a database read-only and applies the settings of a read profile to the connection.
+ * @param dbFilepath The path to the SQLite database file.
+ * @param profile The settings to apply.
+ * @return The open connection, or nullptr if the file could not be opened.
+ */
+static sqlite3* openForBulkRead(const char* dbFilepath, const SqliteReadProfile& profile) {
+    // Only one thread ever uses the connection, so SQLite's internal mutexes are not needed:
+    sqlite3* connection = nullptr;
+    if (sqlite3_open_v2(dbFilepath, &connection, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr) != SQLITE_OK) {
+        sqlite3_close(connection);
+        return nullptr;
+    }
+
+    // Map the whole database into memory if the profile allows it, so pages are read without a copy through the page cache:
+    long long pageCount = 0;
+    long long pageSize = 0;
+    long long mmapBytes = profile.maxMmapBytes;
+    if (queryInt64(connection, "PRAGMA page_count", pageCount) && queryInt64(connection, "PRAGMA page_size", pageSize)
+        && pageCount * pageSize < mmapBytes) {
+        mmapBytes = pageCount * pageSize;
+    }
+
+    string pragmas = "PRAGMA mmap_size=" + to_string(mmapBytes) + ";";
+    pragmas += "PRAGMA cache_size=-" + to_string(profile.cacheKibibytes) + ";"; // A negative value is a size in KiB rather than pages.
+    if (profile.memoryTempStore) {
+        pragmas += "PRAGMA temp_store=MEMORY;";
+    }
+    sqlite3_exec(connection, pragmas.c_str(), nullptr, nullptr, nullptr);
+
+    return connection;
+}
+
+
+/**
+ * Checks with EXPLAIN QUERY PLAN whether the ingest query can use an index for its word filter.
+ * @param connection An open database connection.
+ * @return true if the query plan uses an index, false if it scans the whole table.
+ */
+static bool isWordFilterIndexed(sqlite3* connection) {
+    string explainQuery = string("EXPLAIN QUERY PLAN ") + SELECT_QUERY;
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(connection, explainQuery.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        sqlite3_finalize(stmt);
+        return false;
+    }
+
+    // Column 3 of each plan row holds a description such as "SEARCH lyrics USING INDEX idx_lyrics2 (word=?)".
+    // Only a SEARCH looks rows up through the index. "SCAN lyrics USING COVERING INDEX ..." still reads every entry:
+    bool indexed = false;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char* detail = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+        if (detail != nullptr && strncmp(detail, "SEARCH", 6) == 0 && strstr(detail, "INDEX") != nullptr) {
+            indexed = true;
+        }
+    }
+    sqlite3_finalize(stmt);
+    return indexed;
+}
+
+
+/**
+ * Gets the size and modification time of a database, which the sidecar copy records to tell whether it is out of date.
+ * @param dbFilepath The path to the original SQLite database file.
+ * @param size Set to the file's size in bytes.
+ * @param modifiedTime Set to the file's last modification time, in the file system clock's ticks.
+ * @return true if the file could be inspected, false otherwise.
+ */
+static bool sourceFileStamp(const char* dbFilepath, long long& size, long long& modifiedTime) {
+    error_code error;
+    uintmax_t fileSize = filesystem::file_size(dbFilepath, error);
+    if (error) {
+        return false;
+    }
+    filesystem::file_time_type writeTime = filesystem::last_write_time(dbFilepath, error);
+    if (error) {
+        return false;
+    }
+    size = static_cast<long long>(fileSize);
+    modifiedTime = static_cast<long long>(writeTime.time_since_epoch().count());
+    return true;
+}
+
+
+/**
+ * Checks that a sidecar copy was built from the database as it is now. A copy built before the database was replaced or
+ * updated (or one without the recorded size and time) would give stale rows.
+ * @param sidecar An open connection to the sidecar copy.
+ * @param dbFilepath The path to the original SQLite database file.
+ * @return true if the copy matches the original's size and modification time, false otherwise.
+ */
+static bool isSidecarCurrent(sqlite3* sidecar, const char* dbFilepath) {
+    long long size = 0;
+    long long modifiedTime = 0;
+    long long recordedSize = -1;
+    long long recordedTime = -1;
+    return sourceFileStamp(dbFilepath, size, modifiedTime)
+           && queryInt64(sidecar, "SELECT size FROM bulkread_source", recordedSize)
+           && queryInt64(sidecar, "SELECT modified_time FROM bulkread_source", recordedTime)
+           && recordedSize == size && recordedTime == modifiedTime;
+}
+
+
+/**
+ * Copies a database to a sidecar file and builds a covering index for the ingest query in the copy. An existing copy
+ * is overwritten. The copy records the original's size and modification time (see isSidecarCurrent()).
+ * The original database is never modified.
+ * @param source An open connection to the original database.
+ * @param dbFilepath The path to the original SQLite database file.
+ * @param sidecarPath The path of the copy to create.
+ * @return true if the copy and index were created, false otherwise.
+ */
+static bool buildSidecarIndex(sqlite3* source, const char* dbFilepath, const string& sidecarPath) {
+    // Stamped before copying, so a change made to the original during the copy makes the copy out of date:
+    long long size = 0;
+    long long modifiedTime = 0;
+    if (!sourceFileStamp(dbFilepath, size, modifiedTime)) {
+        return false;
+    }
+
+    sqlite3* destination = nullptr;
+    if (sqlite3_open_v2(sidecarPath.c_str(), &destination, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr) != SQLITE_OK) {
+        sqlite3_close(destination);
+        return false;
+    }
+
+    // Copy every page of the original database with the online backup API:
+    bool success = false;
+    sqlite3_backup* backup = sqlite3_backup_init(destination, "main", source, "main");
+    if (backup != nullptr) {
+        sqlite3_backup_step(backup, -1);
+        success = (sqlite3_backup_finish(backup) == SQLITE_OK);
+    }
+
+    // With (word, track_id, count) in the index, the ingest query never has to read the table itself:
+    if (success) {
+        const char* createIndex = "CREATE INDEX IF NOT EXISTS idx_lyrics_bulkread ON lyrics (word, track_id, count)";
+        success = (sqlite3_exec(destination, createIndex, nullptr, nullptr, nullptr) == SQLITE_OK);
+    }
+    if (success) {
+        string recordSource = "CREATE TABLE bulkread_source (size INTEGER, modified_time INTEGER);"
+                              "INSERT INTO bulkread_source VALUES (" + to_string(size) + ", " + to_string(modifiedTime) + ");";
+        success = (sqlite3_exec(destination, recordSource.c_str(), nullptr, nullptr, nullptr) == SQLITE_OK);
+    }
+
+    sqlite3_close(destination);
+    if (!success) {
+        remove(sidecarPath.c_str()); // Do not leave a half built copy behind to be picked up next time.
+    }
+    return success;
+}
+
+
+/**
+ * Opens a database for ingest. If a sidecar copy with a covering index exists next to the database, the copy is opened instead.
+ * If the word filter is not indexed and the profile allows it, the user is offered to build the sidecar copy.
+ * @param dbFilepath The path to the SQLite database file.
+ * @param profile The connection settings to use for the read.
+ * @param indexed Set to whether the ingest query can use an index on the returned connection.
+ * @return The open connection, or nullptr if the database could not be opened.
+ */
+static sqlite3* openIngestConnection(const char* dbFilepath, const SqliteReadProfile& profile, bool& indexed) {
+    // Prefer a previously built sidecar copy, as long as the database has not changed since. Opening read-only fails if
+    // it does not exist:
+    string sidecarPath = sidecarIndexPath(dbFilepath);
+    sqlite3* connection = openForBulkRead(sidecarPath.c_str(), profile);
+    if (connection != nullptr && !isSidecarCurrent(connection, dbFilepath)) {
+        cout << "Ignoring the indexed copy " << sidecarPath << ", which is older than " << dbFilepath << "." << endl;
+        sqlite3_close(connection);
+        connection = nullptr;
+    }
+    if (connection != nullptr) {
+        cout << "Using indexed copy of the database: " << sidecarPath << endl;
+    }
+    else {
+        connection = openForBulkRead(dbFilepath, profile);
+    }
+
+    if (connection == nullptr) {
+        cout << "Error reading database " << dbFilepath << ". Canceling DB operation." << endl;
+        return nullptr;
+    }
+
+    // Without an index on 'word', SQLite has to scan every row of the lyrics table:
+    indexed = isWordFilterIndexed(connection);
+    if (!indexed) {
+        cout << "Warning: " << dbFilepath << " has no index on the 'word' column, so every row of the lyrics table will be scanned." << endl;
+
+        if (profile.offerIndexBuild) {
+            cout << "Build a covering index in a copy of the database at " << sidecarPath << "? (y/n): ";
+            string answer;
+            cin >> answer;
+
+            if (answer == "y" || answer == "Y") {
+                cout << "Building index. This only needs to be done once..." << endl;
+                if (buildSidecarIndex(connection, dbFilepath, sidecarPath)) {
+                    sqlite3_close(connection);
+                    connection = openForBulkRead(sidecarPath.c_str(), profile);
+                    indexed = (connection != nullptr);
+                }
+                else {
+                    cout << "Could not build the index. Reading the original database instead." << endl;
+                }
+            }
+        }
+
+        // The sidecar could fail to reopen (e.g. it was deleted in the meantime), so fall back to the original:
+        if (connection == nullptr) {
+            connection = openForBulkRead(dbFilepath, profile);
+            if (connection == nullptr) {
+                cout << "Error reading database " << dbFilepath << ". Canceling DB operation." << endl;
+            }
+        }
+    }
+
+    return connection;
+}
+
+
+/**
+ * Reads and aggregates the word counts from an open database, then closes the connection.
+ * Does no console I/O, so several of these can run at once on different threads.
+ * @param connection An open connection returned by openIngestConnection. Closed by this function.
+ * @param indexed Whether the ingest query can use an index on this connection.
+ * @param resultsMap A map to contain each song name and its calculated narcissism score.
+ * @param progress Reporter to count the rows on.
+ * @param skippedRows Set to the number of rows whose track ID was not in the expected format.
+ */
+static void scanLyrics(sqlite3* connection, bool indexed, TrackScoreMap* resultsMap, ProgressReporter* progress, long long* skippedRows) {
+    sqlite3_stmt* selectStmt; // Stores a prepared statement. Will be populatef by sqlite3_prepare_v2
+    TraceScope scanScope("scan database", "ingest");
+
+    // Size the map for every track in the database up front so it never has to grow during the import:
+    TraceScope countScope("count tracks", "ingest");
+    long long trackCount = 0;
+    if (queryInt64(connection, "SELECT COUNT(DISTINCT track_id) FROM lyrics", trackCount)) {
+        resultsMap->reserve(trackCount);
+    }
+
+    // The total row count is only worth getting when the index makes it cheap. It is used for the estimated time remaining:
+    long long rowCount = 0;
+    if (indexed && queryInt64(connection, "SELECT COUNT(*) FROM lyrics WHERE word IN ('i', 'me', 'my')", rowCount)) {
+        progress->addExpectedRows(rowCount);
+    }
+    countScope.end();
+
+    // Library documentation specifies to use v2 method because the original method is a deprecated legacy function:
+    sqlite3_prepare_v2(connection, SELECT_QUERY, -1, &selectStmt, nullptr);
+
+    // Loop through every row that resulted from the SELECT SQL statement to create the Songs.
+    // The reporter prints from its own thread, so the loop does no console I/O:
+    *skippedRows = 0;
+    TraceScope stepScope("step loop", "ingest"); // Each row is aggregated into the map as it is read.
+    while(sqlite3_step(selectStmt) == SQLITE_ROW) { // While there are still rows in the result set:
+        progress->addRow();
+        const char* name = reinterpret_cast<const char*>(sqlite3_column_text(selectStmt, 0));
+        int nameLength = sqlite3_column_bytes(selectStmt, 0);
+        int score = sqlite3_column_int(selectStmt, 2);
+
+        // Add the word count to the song's score. The song is created by the map if it has not yet been encountered:
+        if (!resultsMap->addScore(name, nameLength, score)) {
+            (*skippedRows)++;
+        }
+    }
+    stepScope.addArgument("tracks", static_cast<long long>(resultsMap->size()));
+    stepScope.addArgument("skipped rows", *skippedRows);
+    stepScope.end();
+
+    // Close all database connections and statements to free up memory:
+    sqlite3_finalize(selectStmt);
+    sqlite3_close(connection);
+}
+
+
+/**
+ * Reads every record of an open snapshot file into a map, then closes the file.
+ * Like scanLyrics, does no console I/O so it can run on its own thread.
+ * @param reader An open snapshot reader. Closed by this function.
+ * @param resultsMap A map to contain each song name and its narcissism score.
+ * @param progress Reporter to count the records on.
+ * @param skippedRows Set to the number of records that could not be added, including any missing from a truncated file.
+ */
+static void scanSnapshot(SnapshotReader* reader, TrackScoreMap* resultsMap, ProgressReporter* progress, long long* skippedRows) {
+    TraceScope scanScope("scan snapshot", "ingest");
+    long long recordCount = static_cast<long long>(reader->getRecordCount());
+    resultsMap->reserve(recordCount);
+    progress->addExpectedRows(recordCount);
+
+    const char* name;
+    int nameLength;
+    int score;
+    long long added = 0;
+    while (reader->next(name, nameLength, score)) {
+        progress->addRow();
+        if (resultsMap->addScore(name, nameLength, score)) {
+            added++;
+        }
+    }
+
+    *skippedRows = recordCount - added;
+    scanScope.addArgument("records", added);
+    reader->close();
+}
+
+
+/**
+ * Reads a Million Song Dataset 'bag of words'-style SQLite database.
+ * @param dbFilepath The path to the SQLite database file.
+ * @param resultsMap A map to contain each song name and its calculated narcissism score.
+ * @param profile The connection settings to use for the read.
+ * @return true if the database was read, false if it could not be opened.
+ */
+bool readSqliteDb(const char* dbFilepath, TrackScoreMap& resultsMap, const SqliteReadProfile& profile) {
+    vector<string> dbFilepaths(1, dbFilepath);
+    return readSqliteDbs(dbFilepaths, resultsMap, MergePolicy::SUM, profile);
+}
+
+
+/**
+ * Reads several databases at once, one thread per file, and merges the per-track scores into one map.
+ * Databases are opened one at a time first, so any question about building an index is asked before reading starts.
+ * Any of the files can also be a snapshot (see SongSnapshot.h), which is read as already aggregated songs.
+ * @param dbFilepaths The paths to the SQLite database or snapshot files.
+ * @param resultsMap A map to contain each song name and its merged narcissism score.
+ * @param policy How to combine the scores of a track that appears in more than one database.
+ * @param profile The connection settings to use for the reads.
+ * @return true if every database was read, false if any of them could not be opened. Nothing is read in that case.
+ */
+bool readSqliteDbs(const vector<string>& dbFilepaths, TrackScoreMap& resultsMap, MergePolicy policy, const SqliteReadProfile& profile) {
+    // Open every file up front. Each file has either a database connection or a snapshot reader, the other is nullptr:
+    TraceScope openScope("open files", "ingest");
+    vector<sqlite3*> connections;
+    vector<SnapshotReader*> snapshots;
+    vector<bool> indexed;
+    for (unsigned int i = 0; i < dbFilepaths.size(); i++) {
+        const char* filepath = dbFilepaths.at(i).c_str();
+        bool isIndexed = false;
+        sqlite3* connection = nullptr;
+        SnapshotReader* snapshot = nullptr;
+
+        if (isSnapshotFile(filepath)) {
+            snapshot = new SnapshotReader();
+            if (!snapshot->open(filepath)) {
+                cout << "Error reading snapshot " << filepath << ". It was written by an incompatible version of this program." << endl;
+                delete snapshot;
+                snapshot = nullptr;
+            }
+        }
+        else {
+            connection = openIngestConnection(filepath, profile, isIndexed);
+        }
+
+        if (connection == nullptr && snapshot == nullptr) {
+            for (unsigned int j = 0; j < connections.size(); j++) {
+                if (connections.at(j) != nullptr) {
+                    sqlite3_close(connections.at(j));
+                }
+                delete snapshots.at(j);
+            }
+            return false;
+        }
+        connections.push_back(connection);
+        snapshots.push_back(snapshot);
+        indexed.push_back(isIndexed);
+    }
+    openScope.addArgument("files", static_cast<long long>(dbFilepaths.size()));
+    openScope.end();
+
+    // A single database is read straight into the results. Otherwise, each database gets its own map to be merged afterwards:
+    vector<TrackScoreMap> fileMaps(connections.size() > 1 ? connections.size() : 0);
+    vector<long long> skippedRows(connections.size(), 0);
+    ProgressReporter progress("reading database result rows");
+    cout << endl;
+
+    chrono::high_resolution_clock::time_point startTime = chrono::high_resolution_clock::now(); // Start timing
+    progress.start();
+
+    if (connections.size() == 1 && snapshots.at(0) != nullptr) {
+        scanSnapshot(snapshots.at(0), &resultsMap, &progress, &skippedRows.at(0));
+    }
+    else if (connections.size() == 1) {
+        scanLyrics(connections.at(0), indexed.at(0), &resultsMap, &progress, &skippedRows.at(0));
+    }
+    else {
+        vector<thread> readers;
+        for (unsigned int i = 0; i < connections.size(); i++) {
+            if (snapshots.at(i) != nullptr) {
+                readers.push_back(thread(scanSnapshot, snapshots.at(i), &fileMaps.at(i), &progress, &skippedRows.at(i)));
+            }
+            else {
+                readers.push_back(thread(scanLyrics, connections.at(i), indexed.at(i), &fileMaps.at(i), &progress, &skippedRows.at(i)));
+            }
+        }
+        for (unsigned int i = 0; i < readers.size(); i++) {
+            readers.at(i).join();
+        }
+    }
+
+    progress.stop();
+
+    // Merge in file order so that the 'last' policy favours databases later in the list:
+    TraceScope mergeScope("merge", "ingest");
+    for (unsigned int i = 0; i < fileMaps.size(); i++) {
+        resultsMap.merge(fileMaps.at(i), policy);
+        fileMaps.at(i) = TrackScoreMap(); // Free each map as soon as it has been merged.
+    }
+    mergeScope.addArgument("tracks", static_cast<long long>(resultsMap.size()));
+    mergeScope.end();
+
+    chrono::high_resolution_clock::time_point endTime = chrono::high_resolution_clock::now(); // Stop timing
+
+    // Print the time taken for the data import step to complete:
+    auto timeTaken = std::chrono::duration_cast<std::chrono::seconds>(endTime - startTime);
+    cout << "Database import into program took " << timeTaken.count() << " seconds." << endl;
+    for (unsigned int i = 0; i < skippedRows.size(); i++) {
+        if (skippedRows.at(i) > 0) {
+            if (snapshots.at(i) != nullptr) {
+                cout << skippedRows.at(i) << " records in " << dbFilepaths.at(i) << " could not be read. The snapshot may be truncated." << endl;
+            }
+            else {
+                cout << skippedRows.at(i) << " rows in " << dbFilepaths.at(i) << " were skipped because their track ID was not "
+                     << TrackScoreMap::KEY_LENGTH << " characters long." << endl;
+            }
+        }
+        delete snapshots.at(i);
+    }
+    cout << endl << endl;
+
+    return true;
+}
+
+
+/**
+ * Constructor. Nothing is open until open().
+ */
+IngestCursor::IngestCursor() : connection(nullptr), statement(nullptr), snapshot(nullptr), resultsMap(nullptr), rowsRead(0),
+                               skippedRows(0) {}
+
+
+/**
+ * Destructor. Closes the file if it is still open.
+ */
+IngestCursor::~IngestCursor() {
+    close();
+}
+
+
+/**
+ * Opens a database or snapshot file and prepares to read it. Nothing is read until step().
+ * @param filepath The path to the SQLite database or snapshot file.
+ * @param resultsMap The map the rows are aggregated into. Must outlive the read.
+ * @param profile The connection settings to use for a database. Its offerIndexBuild setting is ignored.
+ * @return true if the file is open, false if it could not be opened.
+ */
+bool IngestCursor::open(const char* filepath, TrackScoreMap& resultsMap, const SqliteReadProfile& profile) {
+    close();
+    this->resultsMap = &resultsMap;
+    rowsRead = 0;
+    skippedRows = 0;
+
+    if (isSnapshotFile(filepath)) {
+        snapshot = new SnapshotReader();
+        if (!snapshot->open(filepath)) {
+            delete snapshot;
+            snapshot = nullptr;
+            return false;
+        }
+        resultsMap.reserve(static_cast<size_t>(snapshot->getRecordCount()));
+        return true;
+    }
+
+    // The cursor's owner may be serving other work on this thread, so it must never stop to ask a question:
+    SqliteReadProfile quietProfile = profile;
+    quietProfile.offerIndexBuild = false;
+    bool indexed = false;
+    connection = openIngestConnection(filepath, quietProfile, indexed);
+    if (connection == nullptr) {
+        return false;
+    }
+    long long trackCount = 0;
+    if (queryInt64(connection, "SELECT COUNT(DISTINCT track_id) FROM lyrics", trackCount)) {
+        resultsMap.reserve(trackCount);
+    }
+    if (sqlite3_prepare_v2(connection, SELECT_QUERY, -1, &statement, nullptr) != SQLITE_OK) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * Reads and aggregates up to a given number of rows (records, for a snapshot).
+ * @param maxRows The most rows to read before returning.
+ * @return true if there may be more rows to read, false once the whole file has been read (it is then closed).
+ */
+bool IngestCursor::step(int maxRows) {
+    if (statement != nullptr) {
+        for (int i = 0; i < maxRows; i++) {
+            if (sqlite3_step(statement) != SQLITE_ROW) {
+                close();
+                return false;
+            }
+            rowsRead++;
+            const char* name = reinterpret_cast<const char*>(sqlite3_column_text(statement, 0));
+            int nameLength = sqlite3_column_bytes(statement, 0);
+            if (!resultsMap->addScore(name, nameLength, sqlite3_column_int(statement, 2))) {
+                skippedRows++;
+            }
+        }
+        return true;
+    }
+
+    if (snapshot != nullptr) {
+        const char* name;
+        int nameLength;
+        int score;
+        for (int i = 0; i < maxRows; i++) {
+            if (!snapshot->next(name, nameLength, score)) {
+                skippedRows += static_cast<long long>(snapshot->getRecordCount()) - rowsRead; // Missing from a truncated file.
+                close();
+                return false;
+            }
+            rowsRead++;
+            if (!resultsMap->addScore(name, nameLength, score)) {
+                skippedRows++;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+
+/**
+ * Closes the file. Rows already read stay in the map.
+ */
+void IngestCursor::close() {
+    if (statement != nullptr) {
+        sqlite3_finalize(statement);
+        statement = nullptr;
+    }
+    if (connection != nullptr) {
+        sqlite3_close(connection);
+        connection = nullptr;
+    }
+    if (snapshot != nullptr) {
+        snapshot->close();
+        delete snapshot;
+        snapshot = nullptr;
+    }
+}
+
+
+long long IngestCursor::getRowsRead() const {
+    return rowsRead;
+}
+
+
+/**
+ * Gets the number of rows skipped so far because their track ID was not in the expected format, plus, for a snapshot,
+ * any records missing from a truncated file.
+ */
+long long IngestCursor::getSkippedRows() const {
+    return skippedRows;
+}
+
+
+/**
+ * Finds the top K songs of a snapshot file, holding only K songs in memory.
+ * @param filepath The path to the snapshot file.
+ * @param k The number of songs to find.
+ * @param topSongs Populated with the top K songs, highest score first.
+ * @return true if the snapshot was read, false if it could not be opened.
+ */
+static bool streamTopSnapshotSongs(const char* filepath, int k, vector<Song>& topSongs) {
+    SnapshotReader reader;
+    if (!reader.open(filepath)) {
+        cout << "Error reading snapshot " << filepath << ". Canceling DB operation." << endl;
+        return false;
+    }
+
+    TraceScope streamScope("stream snapshot top k", "ingest");
+    TopKHeap topK(k);
+    ProgressReporter progress("streaming snapshot records");
+    progress.addExpectedRows(static_cast<long long>(reader.getRecordCount()));
+    cout << endl;
+
+    chrono::high_resolution_clock::time_point startTime = chrono::high_resolution_clock::now(); // Start timing
+    progress.start();
+
+    const char* name;
+    int nameLength;
+    int score;
+    while (reader.next(name, nameLength, score)) {
+        progress.addRow();
+        topK.offer(Song(string(name, nameLength), score));
+    }
+
+    progress.stop();
+    chrono::high_resolution_clock::time_point endTime = chrono::high_resolution_clock::now(); // Stop timing
+
+    topSongs = topK.takeSorted();
+
+    auto timeTaken = std::chrono::duration_cast<std::chrono::seconds>(endTime - startTime);
+    cout << "Streaming the snapshot took " << timeTaken.count() << " seconds." << endl << endl;
+    return true;
+}
+
+
+/**
+ * Finds the top K songs of a database without loading the whole dataset.
+ * SQLite sums the word counts per track, and each aggregated track is offered to a bounded heap as it arrives,
+ * so this program only ever holds K songs in memory.
+ * @param dbFilepath The path to the SQLite database file, or a snapshot file.
+ * @param k The number of songs to find.
+ * @param topSongs Populated with the top K songs, highest score first.
+ * @param profile The connection settings to use for the read.
+ * @return true if the database was read, false if it could not be opened.
+ */
+bool streamTopSongs(const char* dbFilepath, int k, vector<Song>& topSongs, const SqliteReadProfile& profile) {
+    // A snapshot is already aggregated, so its records can be offered to the heap directly:
+    if (isSnapshotFile(dbFilepath)) {
+        return streamTopSnapshotSongs(dbFilepath, k, topSongs);
+    }
+
+    // The GROUP BY may need a temporary sorter. Keep it on disk, otherwise SQLite would hold every track in memory for us:
+    SqliteReadProfile streamProfile = profile;
+    streamProfile.memoryTempStore = false;
+
+    bool indexed = false;
+    sqlite3* connection = openIngestConnection(dbFilepath, streamProfile, indexed);
+    if (connection == nullptr) {
+        return false;
+    }
+
+    const char* groupedQuery = "SELECT track_id, SUM(count) FROM lyrics WHERE word IN ('i', 'me', 'my') GROUP BY track_id";
+    sqlite3_stmt* groupedStmt;
+    sqlite3_prepare_v2(connection, groupedQuery, -1, &groupedStmt, nullptr);
+
+    TraceScope streamScope("stream grouped top k", "ingest"); // SQLite aggregates, so this covers the GROUP BY and the heap.
+    TopKHeap topK(k);
+    ProgressReporter progress("streaming aggregated tracks");
+    cout << endl;
+
+    chrono::high_resolution_clock::time_point startTime = chrono::high_resolution_clock::now(); // Start timing
+    progress.start();
+
+    // Each result row is one fully aggregated track:
+    while (sqlite3_step(groupedStmt) == SQLITE_ROW) {
+        progress.addRow();
+        const char* name = reinterpret_cast<const char*>(sqlite3_column_text(groupedStmt, 0));
+        int nameLength = sqlite3_column_bytes(groupedStmt, 0);
+        int score = sqlite3_column_int(groupedStmt, 1);
+        topK.offer(Song(string(name, nameLength), score));
+    }
+
+    progress.stop();
+    chrono::high_resolution_clock::time_point endTime = chrono::high_resolution_clock::now(); // Stop timing
+
+    sqlite3_finalize(groupedStmt);
+    sqlite3_close(connection);
+
+    topSongs = topK.takeSorted();
+
+    auto timeTaken = std::chrono::duration_cast<std::chrono::seconds>(endTime - startTime);
+    cout << "Streaming the database took " << timeTaken.count() << " seconds." << endl << endl;
+    return true;
+}
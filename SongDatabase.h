@@ -0,0 +1,64 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_SONGDATABASE_H
+#define COP3530_PROJECT_3_SONGDATABASE_H
+
+#include <string>
+#include <vector>
+
+#include "TrackScoreMap.h"
+
+/**
+ * Connection settings used when bulk reading the lyrics table.
+ * The default constructor gives a read-only profile sized for a full scan of the database.
+ */
+struct SqliteReadProfile {
+    long long maxMmapBytes; // Upper limit for PRAGMA mmap_size. The database is mapped up to its full size below this limit.
+    int cacheKibibytes; // Page cache size for PRAGMA cache_size.
+    bool memoryTempStore; // Whether temporary tables and indices should be kept in memory (PRAGMA temp_store=MEMORY).
+    bool offerIndexBuild; // Whether to ask the user to build a covering index when the word filter cannot use an index.
+
+    SqliteReadProfile(); // ctr
+};
+
+// Declared by sqlite3.h and SongSnapshot.h, which only the .cpp implementation file needs:
+struct sqlite3;
+struct sqlite3_stmt;
+class SnapshotReader;
+
+/**
+ * Reads one database or snapshot file a slice of rows at a time, for callers that interleave the read with other work
+ * on the same thread (see AsyncOperations.h). Aggregates the rows exactly like readSqliteDb, but never asks about
+ * building an index and never starts a thread.
+ */
+class IngestCursor {
+private:
+    sqlite3* connection; // Open while a database is being read, otherwise nullptr.
+    sqlite3_stmt* statement;
+    SnapshotReader* snapshot; // Open while a snapshot is being read, otherwise nullptr.
+    TrackScoreMap* resultsMap;
+    long long rowsRead;
+    long long skippedRows;
+
+public:
+    IngestCursor(); // ctr
+    ~IngestCursor(); // dtr
+
+    bool open(const char* filepath, TrackScoreMap& resultsMap, const SqliteReadProfile& profile = SqliteReadProfile());
+    bool step(int maxRows);
+    void close();
+    long long getRowsRead() const;
+    long long getSkippedRows() const;
+};
+
+// Ingest functions. See the .cpp implementation file:
+bool readSqliteDb(const char* dbFilepath, TrackScoreMap& resultsMap, const SqliteReadProfile& profile = SqliteReadProfile());
+bool readSqliteDbs(const vector<string>& dbFilepaths, TrackScoreMap& resultsMap, MergePolicy policy,
+                   const SqliteReadProfile& profile = SqliteReadProfile());
+bool streamTopSongs(const char* dbFilepath, int k, vector<Song>& topSongs, const SqliteReadProfile& profile = SqliteReadProfile());
+string sidecarIndexPath(const char* dbFilepath);
+
+
+#endif //COP3530_PROJECT_3_SONGDATABASE_H
@@ -0,0 +1,291 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <cstring>
+
+#include "SongSnapshot.h"
+#include "TrackScoreMap.h"
+
+static const char SNAPSHOT_MAGIC[8] = {'L', 'P', 'S', 'Y', 'S', 'N', 'A', 'P'};
+static const uint32_t SNAPSHOT_VERSION = 1;
+static const int HEADER_SIZE = 24; // Magic, version, ID length and record count.
+static const int RECORDS_PER_BUFFER = 64 * 1024; // Records moved to or from the file per fread/fwrite call.
+
+
+/**
+ * Stores an integer as little-endian bytes, so snapshots are portable between machines.
+ * @param bytes Where to store the integer.
+ * @param value The integer to store.
+ * @param size The number of bytes to store.
+ */
+static void storeLittleEndian(unsigned char* bytes, uint64_t value, int size) {
+    for (int i = 0; i < size; i++) {
+        bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+
+/**
+ * Loads an integer stored by storeLittleEndian.
+ * @param bytes Where the integer is stored.
+ * @param size The number of bytes to load.
+ * @return The integer.
+ */
+static uint64_t loadLittleEndian(const unsigned char* bytes, int size) {
+    uint64_t value = 0;
+    for (int i = 0; i < size; i++) {
+        value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+    }
+    return value;
+}
+
+
+/**
+ * Checks whether a file is a snapshot by looking at its first bytes.
+ * @param filepath The path to the file.
+ * @return true if the file starts with the snapshot magic, false otherwise (including if it cannot be opened).
+ */
+bool isSnapshotFile(const char* filepath) {
+    FILE* file = fopen(filepath, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    char magic[sizeof(SNAPSHOT_MAGIC)];
+    bool matches = fread(magic, 1, sizeof(magic), file) == sizeof(magic) && memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) == 0;
+    fclose(file);
+    return matches;
+}
+
+
+/**
+ * Writes every song in a list to a snapshot file.
+ * @param filepath The path of the snapshot file. Overwritten if it exists.
+ * @param songs The songs to write.
+ * @return true if the snapshot was written, false otherwise.
+ */
+bool writeSnapshot(const char* filepath, const vector<Song>& songs) {
+    SnapshotWriter writer;
+    if (!writer.open(filepath)) {
+        return false;
+    }
+    for (unsigned int i = 0; i < songs.size(); i++) {
+        if (!writer.write(songs.at(i))) {
+            return false;
+        }
+    }
+    return writer.close();
+}
+
+
+// SnapshotWriter:
+// ===============
+
+/**
+ * Constructor.
+ */
+SnapshotWriter::SnapshotWriter() : file(nullptr), recordCount(0) {}
+
+
+/**
+ * Destructor. Finishes the file if close() was not called.
+ */
+SnapshotWriter::~SnapshotWriter() {
+    close();
+}
+
+
+/**
+ * Creates the snapshot file. The header is rewritten with the final record count by close().
+ * @param filepath The path of the snapshot file. Overwritten if it exists.
+ * @return true if the file could be created, false otherwise.
+ */
+bool SnapshotWriter::open(const char* filepath) {
+    close();
+    file = fopen(filepath, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    recordCount = 0;
+    buffer.clear();
+    buffer.reserve(static_cast<size_t>(RECORDS_PER_BUFFER) * (TrackScoreMap::KEY_LENGTH + 4));
+
+    // Placeholder header until the record count is known:
+    unsigned char header[HEADER_SIZE] = {};
+    return fwrite(header, 1, HEADER_SIZE, file) == HEADER_SIZE;
+}
+
+
+/**
+ * Adds one song to the snapshot.
+ * @param trackId The song's track ID. Not null terminated.
+ * @param idLength The length of the track ID. Must be TrackScoreMap::KEY_LENGTH.
+ * @param score The song's narcissism score.
+ * @return true if the record was added, false if the ID has the wrong length or the file could not be written.
+ */
+bool SnapshotWriter::write(const char* trackId, int idLength, int score) {
+    if (file == nullptr || idLength != TrackScoreMap::KEY_LENGTH) {
+        return false;
+    }
+
+    unsigned char scoreBytes[4];
+    storeLittleEndian(scoreBytes, static_cast<uint32_t>(score), 4);
+    buffer.insert(buffer.end(), trackId, trackId + idLength);
+    buffer.insert(buffer.end(), scoreBytes, scoreBytes + 4);
+    recordCount++;
+
+    if (buffer.size() >= buffer.capacity()) {
+        return flushBuffer();
+    }
+    return true;
+}
+
+
+/**
+ * Adds one song to the snapshot.
+ * @param song The song to add.
+ * @return true if the record was added, false otherwise.
+ */
+bool SnapshotWriter::write(const Song& song) {
+    const string& name = song.getName();
+    return write(name.data(), static_cast<int>(name.size()), song.getScore());
+}
+
+
+/**
+ * Writes the buffered records to the file.
+ * @return true if every record was written, false otherwise.
+ */
+bool SnapshotWriter::flushBuffer() {
+    bool written = fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    buffer.clear();
+    return written;
+}
+
+
+/**
+ * Writes the remaining records and the final header, then closes the file.
+ * @return true if the snapshot is complete, false if anything could not be written.
+ */
+bool SnapshotWriter::close() {
+    if (file == nullptr) {
+        return false;
+    }
+
+    unsigned char header[HEADER_SIZE];
+    memcpy(header, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    storeLittleEndian(header + 8, SNAPSHOT_VERSION, 4);
+    storeLittleEndian(header + 12, TrackScoreMap::KEY_LENGTH, 4);
+    storeLittleEndian(header + 16, recordCount, 8);
+
+    bool success = flushBuffer();
+    success = fseek(file, 0, SEEK_SET) == 0 && success;
+    success = fwrite(header, 1, HEADER_SIZE, file) == HEADER_SIZE && success;
+    success = fclose(file) == 0 && success;
+    file = nullptr;
+    return success;
+}
+
+
+// SnapshotReader:
+// ===============
+
+/**
+ * Constructor.
+ */
+SnapshotReader::SnapshotReader() : file(nullptr), recordCount(0), recordsRead(0), idLength(0), bufferPosition(0) {}
+
+
+/**
+ * Destructor.
+ */
+SnapshotReader::~SnapshotReader() {
+    close();
+}
+
+
+/**
+ * Opens a snapshot file and checks its header.
+ * @param filepath The path to the snapshot file.
+ * @return true if the file is a snapshot this program can read, false otherwise.
+ */
+bool SnapshotReader::open(const char* filepath) {
+    close();
+    file = fopen(filepath, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    unsigned char header[HEADER_SIZE];
+    if (fread(header, 1, HEADER_SIZE, file) != HEADER_SIZE || memcmp(header, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0
+        || loadLittleEndian(header + 8, 4) != SNAPSHOT_VERSION || loadLittleEndian(header + 12, 4) != TrackScoreMap::KEY_LENGTH) {
+        close();
+        return false;
+    }
+
+    idLength = TrackScoreMap::KEY_LENGTH;
+    recordCount = loadLittleEndian(header + 16, 8);
+    recordsRead = 0;
+    buffer.clear();
+    bufferPosition = 0;
+    return true;
+}
+
+
+/**
+ * Reads the next record.
+ * @param trackId Set to the record's track ID. Not null terminated, and only valid until the next call.
+ * @param idLength Set to the length of the track ID.
+ * @param score Set to the record's narcissism score.
+ * @return true if a record was read, false at the end of the file or if the file is truncated.
+ */
+bool SnapshotReader::next(const char*& trackId, int& idLength, int& score) {
+    if (file == nullptr || recordsRead == recordCount) {
+        return false;
+    }
+
+    // Refill the buffer with the next batch of records:
+    size_t recordSize = this->idLength + 4;
+    if (bufferPosition >= buffer.size()) {
+        uint64_t remaining = recordCount - recordsRead;
+        size_t batch = remaining < RECORDS_PER_BUFFER ? static_cast<size_t>(remaining) : RECORDS_PER_BUFFER;
+        buffer.resize(batch * recordSize);
+
+        // A truncated file still gives every complete record before the point where it was cut off:
+        size_t bytesRead = fread(buffer.data(), 1, buffer.size(), file);
+        buffer.resize(bytesRead - bytesRead % recordSize);
+        if (buffer.empty()) {
+            close();
+            return false;
+        }
+        bufferPosition = 0;
+    }
+
+    const unsigned char* record = buffer.data() + bufferPosition;
+    trackId = reinterpret_cast<const char*>(record);
+    idLength = this->idLength;
+    score = static_cast<int>(static_cast<uint32_t>(loadLittleEndian(record + this->idLength, 4)));
+    bufferPosition += recordSize;
+    recordsRead++;
+    return true;
+}
+
+
+/**
+ * Gets the number of records in the open snapshot.
+ * @return The record count from the header.
+ */
+uint64_t SnapshotReader::getRecordCount() const {
+    return recordCount;
+}
+
+
+/**
+ * Closes the file.
+ */
+void SnapshotReader::close() {
+    if (file != nullptr) {
+        fclose(file);
+        file = nullptr;
+    }
+}
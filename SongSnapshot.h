@@ -0,0 +1,74 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_SONGSNAPSHOT_H
+#define COP3530_PROJECT_3_SONGSNAPSHOT_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Song.h"
+
+using namespace std;
+
+/**
+ * A snapshot file holds already aggregated songs, so it can be loaded without running the SQL query.
+ *
+ * Layout (all integers little-endian):
+ *   8 bytes   magic "LPSYSNAP"
+ *   uint32    format version (currently 1)
+ *   uint32    track ID length in bytes (always TrackScoreMap::KEY_LENGTH)
+ *   uint64    number of records
+ *   records   one per song: the track ID bytes followed by an int32 narcissism score
+ *
+ * Writes a snapshot file one record at a time, so a dataset never has to be held in memory to be saved.
+ */
+class SnapshotWriter {
+private:
+    FILE* file; // The open snapshot file, or nullptr.
+    uint64_t recordCount; // Number of records written so far. Stored in the header on close.
+    vector<unsigned char> buffer; // Records waiting to be written.
+
+    bool flushBuffer();
+
+public:
+    SnapshotWriter(); // ctr
+    ~SnapshotWriter(); // dtr
+
+    bool open(const char* filepath);
+    bool write(const char* trackId, int idLength, int score);
+    bool write(const Song& song);
+    bool close();
+};
+
+/**
+ * Reads a snapshot file one record at a time.
+ */
+class SnapshotReader {
+private:
+    FILE* file; // The open snapshot file, or nullptr.
+    uint64_t recordCount; // Number of records in the file, from the header.
+    uint64_t recordsRead; // Number of records returned by next() so far.
+    int idLength; // Length of every track ID in the file.
+    vector<unsigned char> buffer; // Records read from the file but not yet returned.
+    size_t bufferPosition; // Offset of the next record in the buffer.
+
+public:
+    SnapshotReader(); // ctr
+    ~SnapshotReader(); // dtr
+
+    bool open(const char* filepath);
+    bool next(const char*& trackId, int& idLength, int& score);
+    uint64_t getRecordCount() const;
+    void close();
+};
+
+// Snapshot functions. See the .cpp implementation file:
+bool isSnapshotFile(const char* filepath);
+bool writeSnapshot(const char* filepath, const vector<Song>& songs);
+
+
+#endif //COP3530_PROJECT_3_SONGSNAPSHOT_H
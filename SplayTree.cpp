@@ -4,7 +4,9 @@
 
 #include <stack>
 #include <stdexcept>
+#include <thread>
 
+#include "ParallelBuild.h"
 #include "SplayTree.h"
 
 using namespace std;
@@ -13,19 +15,82 @@ using namespace std;
 /**
  * Default Constructor.
  */
-SplayTree::SplayTree() : root(nullptr), numElements(0)  {}
+SplayTree::SplayTree() : root(nullptr), numElements(0)  {
+#ifdef SPLAYTREE_STATS
+    lastAccessDepth = 0;
+#endif
+}
+
+
+/**
+ * Destructor frees every node in the tree.
+ */
+SplayTree::~SplayTree() {
+    vector<Node*> nodes = preorderNodes(root);
+    for (unsigned int i = 0; i < nodes.size(); i++) {
+        delete nodes.at(i);
+    }
+}
 
 
 /**
- * Build the SplayTree from Songs in a vector.
+ * The ordering of the nodes in the tree: by score, with ties broken by song name.
+ * Rotations can move a node with the same score to either side of another, so a score-only ordering is not enough for
+ * splay() to retrace the path to a node. With the name as a tie breaker the path to every node is unambiguous.
+ * @return true if a comes before b in the tree.
+ */
+bool SplayTree::nodeLess(const Song& a, const Song& b) {
+    if (a.getScore() != b.getScore()) {
+        return a.getScore() < b.getScore();
+    }
+    return a.getName() < b.getName();
+}
+
+
+/**
+ * Build the SplayTree from Songs in a vector, adding them to any songs already in the tree.
+ * Rather than inserting and splaying one song at a time, the songs are sorted and the tree is rebuilt perfectly
+ * balanced from the sorted nodes, in linear time after the sort. Large builds sort, create the nodes and link the
+ * subtrees on several threads (see ParallelBuild.h). A song with the same name and score as one already in the tree
+ * is left out, as insert() would.
  * @param songs A vector of songs from which to populate the SplayTree.
  */
 void SplayTree::build(vector<Song>& songs) {
-    for (unsigned int i = 0; i < songs.size(); i++) {
-        Node* newNode = insertSong(songs.at(i)); // Insert the song and obtain pointer to the node in which it is stored.
-        numElements++;
-        root = splay(root, newNode); // Move the node that was found to the root.
+    int threadCount = parallelBuildThreads(songs.size());
+    vector<const Song*> sorted = sortSongs(songs, threadCount);
+
+    // Create the nodes, each thread copying a block of the songs:
+    vector<Node*> nodes(sorted.size());
+    parallelFor(threadCount, sorted.size(), [&sorted, &nodes](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) {
+            nodes.at(i) = new Node(*sorted.at(i));
+        }
+    });
+
+    // Merge in the nodes already in the tree, dropping repeats. On a tie the node already in the tree comes first and
+    // is the one kept:
+    vector<Node*> existing = inorderNodes(root);
+    vector<Node*> merged;
+    merged.reserve(existing.size() + nodes.size());
+    unsigned int e = 0;
+    unsigned int n = 0;
+    while (e < existing.size() || n < nodes.size()) {
+        bool takeExisting = n == nodes.size() || (e < existing.size() && !nodeLess(nodes.at(n)->val, existing.at(e)->val));
+        Node* next = takeExisting ? existing.at(e++) : nodes.at(n++);
+        if (!merged.empty() && !nodeLess(merged.back()->val, next->val)) {
+            delete next; // Same name and score as the song before it, so only ever one of the new nodes.
+            continue;
+        }
+        merged.push_back(next);
     }
+
+    // Link the nodes into a balanced tree, the top few levels' subtrees on their own threads:
+    int parallelLevels = 0;
+    while ((1 << parallelLevels) < threadCount) {
+        parallelLevels++;
+    }
+    root = linkBalanced(merged, 0, merged.size(), parallelLevels);
+    numElements = merged.size();
 }
 
 
@@ -141,38 +206,51 @@ SplayTree::Node* SplayTree::splay(Node *node, Node *target) {
     }
 
     if (node == target) { // This should only occur if node is the root node of the entire Splay Tree
+#ifdef SPLAYTREE_STATS
+        if (node == root) {
+            lastAccessDepth = 0;
+        }
+#endif
         return node;
     }
 
-    stack<Node*> path; // This will keep track of the path from node to the target node.
-    path.push(node);
+    vector<Node*>& path = splayPath; // This will keep track of the path from node to the target node. Used as a stack.
+    path.clear();
+    path.push_back(node);
 
     // populate the 'path' stack with the path to the target node:
-    while(path.top() != target) {
-        if(target->val < path.top()->val) {
-            path.push(path.top()->left);
+    while(path.back() != target) {
+        if(nodeLess(target->val, path.back()->val)) {
+            path.push_back(path.back()->left);
         }
         else { // if target->val > node->val:
-            path.push(path.top()->right);
+            path.push_back(path.back()->right);
         }
-        if (path.top() == nullptr) {
+        if (path.back() == nullptr) {
             return nullptr;
         }
     }
 
-    path.pop(); // Remove the target from the stack. Our iteration needs to start from its parent.
+#ifdef SPLAYTREE_STATS
+    // Only splays of the whole tree count as accesses. removeNode also splays the left subtree of the root:
+    if (node == root) {
+        lastAccessDepth = static_cast<int>(path.size()) - 1;
+    }
+#endif
+
+    path.pop_back(); // Remove the target from the stack. Our iteration needs to start from its parent.
 
     // Work down the stack with ZigZig, ZigZag and Zig operations to get the target node to the root of the subtree:
     while(path.size() > 1) {
         // Determine the direction of the pointer to target.
-        Node* parent = path.top();
+        Node* parent = path.back();
         bool lowerDirectionLeft = (parent->left == target);
-        path.pop();
+        path.pop_back();
 
         // Determine the direction of the pointer to target.
-        Node* grandParent = path.top();
+        Node* grandParent = path.back();
         bool upperDirectionLeft = (grandParent->left == parent);
-        path.pop();
+        path.pop_back();
 
         // Perform zig/zag operation to rearrange the subtree so that target is at the root of the current subtree:
         Node* newSubtree = nullptr;
@@ -188,25 +266,36 @@ SplayTree::Node* SplayTree::splay(Node *node, Node *target) {
         else { // !lowerDirectionLeft && upperDirectionLeft
             newSubtree = zigZagLeftRight(grandParent);
         }
+#ifdef SPLAYTREE_STATS
+        if (lowerDirectionLeft == upperDirectionLeft) {
+            stats.zigZigSteps++;
+        }
+        else {
+            stats.zigZagSteps++;
+        }
+#endif
 
         // Attach the newly rearranged subtree:
         if (!path.empty()) {
-            if (path.top()->left == grandParent) {
-                path.top()->left = newSubtree;
+            if (path.back()->left == grandParent) {
+                path.back()->left = newSubtree;
             }
-            else { //path.top()->right == grandparent
-                path.top()->right = newSubtree;
+            else { //path.back()->right == grandparent
+                path.back()->right = newSubtree;
             }
         }
     }
 
     // Perform final Zig operation if necessary:
     if (!path.empty()) {
-        if (path.top()->left == target) {
-            zigRight(path.top());
+#ifdef SPLAYTREE_STATS
+        stats.zigSteps++;
+#endif
+        if (path.back()->left == target) {
+            zigRight(path.back());
         }
-        else { //path.top()->right == target
-            zigLeft(path.top());
+        else { //path.back()->right == target
+            zigLeft(path.back());
         }
     }
 
@@ -220,7 +309,7 @@ SplayTree::Node* SplayTree::splay(Node *node, Node *target) {
  * @param targetScore The score to be searched for.
  * @return A pointer to the node that has been found.
  */
-SplayTree::Node* SplayTree::searchNode(int targetScore) {
+SplayTree::Node* SplayTree::searchNode(int targetScore) const {
     Node* curr = root;
     while (curr != nullptr) {
         if (targetScore < curr->val.getScore()) {
@@ -239,15 +328,19 @@ SplayTree::Node* SplayTree::searchNode(int targetScore) {
 
 /**
  * Helper method that inserts a song in a valid location to maintain BST ordering.
- * If the song already exists, then this method simply updates its score field.
+ * If a song with the same name and score already exists, then the existing node is returned instead and nothing is
+ * added. A song with the same name but a different score is a different song and gets its own node.
  * Does NOT splay the newly inserted node to the root position. Splay must be called separately if needed.
  * @param song The new song object to be inserted.
- * @return The node that was updated or created and inserted.
+ * @param created Set to true if a new node was added, false if the song was already in the tree.
+ * @return The node that was found or created and inserted.
  */
-SplayTree::Node* SplayTree::insertSong(Song song) {
+SplayTree::Node* SplayTree::insertSong(Song song, bool& created) {
+    created = true;
+
     // Corner case: Tree is empty:
     if (root == nullptr) { // newNode can simply be placed at root of SplayTree.
-        root = new Node(song);
+        root = new Node(move(song));
         return root;
     }
     // We must find the correct leaf and insert the new node as a child of that leaf.
@@ -259,25 +352,25 @@ SplayTree::Node* SplayTree::insertSong(Song song) {
     // Find the appropriate leaf node:
     while (curr != nullptr) {
         // First, check for edge case where song already exists:
-        if(curr->val.getName() == song.getName()) {
-            curr->val.setScore(song.getScore()); // Update the score because this song already exists.
-            return curr; // return the updated node so it can be splayed by the caller if necessary.
+        if(curr->val.getName() == song.getName() && curr->val.getScore() == song.getScore()) {
+            created = false;
+            return curr; // return the existing node so it can be splayed by the caller if necessary.
         }
 
         leaf = curr; // 'leaf' will keep being updated each iteration until we have found a real leaf.
 
-        if (song < curr->val) {
+        if (nodeLess(song, curr->val)) {
             curr = curr->left; // new node must be attached in left subtree.
         }
-        else if (song >= curr->val) {
+        else {
             curr = curr->right; // new node must be attached in right subtree.
         }
     }
 
-    Node* newNode = new Node(song); // Nodes always live in heap memory.
+    Node* newNode = new Node(move(song)); // Nodes always live in heap memory. 'song' is a copy, so its name is moved in.
 
     // Add the new node as a child of the leaf node:
-    if (song < leaf->val) {
+    if (nodeLess(newNode->val, leaf->val)) {
         leaf->left = newNode;
     }
     else { // newNode->val >= leaf->val
@@ -320,10 +413,13 @@ void SplayTree::removeNode(Node* node) {
 /**
  * Find the highest node in a subtree (based on the ordering of the nodes)
  * @param node The root of the subtree.
- * @return The highest node in the subtree.
+ * @return The highest node in the subtree, or nullptr if the subtree is empty.
  */
 SplayTree::Node* SplayTree::getMaxNode(Node* node) {
     Node* maxNode = node; // Initialize maxNode to the root of the tree/subtree.
+    if (maxNode == nullptr) { // Empty subtree has no highest node.
+        return nullptr;
+    }
 
     // If maxNode has a right child, that right child must be higher than maxNode, so reassign it:
     while(maxNode->right != nullptr) {
@@ -336,10 +432,13 @@ SplayTree::Node* SplayTree::getMaxNode(Node* node) {
 /**
  * Find the lowest node in a subtree (based on the ordering of the nodes)
  * @param node The root of the subtree.
- * @return The lowest node in the subtree.
+ * @return The lowest node in the subtree, or nullptr if the subtree is empty.
  */
 SplayTree::Node* SplayTree::getMinNode(Node* node) {
     Node* minNode = node; // Initialize maxNode to the root of the tree/subtree.
+    if (minNode == nullptr) { // Empty subtree has no lowest node.
+        return nullptr;
+    }
 
     // If minNode has a left child, that left child must be lower than minNode, so reassign it:
     while(minNode->left != nullptr) {
@@ -386,8 +485,72 @@ vector<SplayTree::Node*> SplayTree::preorderNodes(Node* node) {
 }
 
 
+/**
+ * Gets the nodes of a tree in order, from the lowest score to the highest.
+ * @param node Root node of the tree or subtree to be traversed.
+ * @return The nodes, in order.
+ */
+vector<SplayTree::Node*> SplayTree::inorderNodes(Node* node) {
+    vector<Node*> output;
+    vector<Node*> path; // Nodes whose left subtree is being visited.
+    while (node != nullptr || !path.empty()) {
+        while (node != nullptr) {
+            path.push_back(node);
+            node = node->left;
+        }
+        node = path.back();
+        path.pop_back();
+        output.push_back(node);
+        node = node->right;
+    }
+    return output;
+}
+
+
+/**
+ * Links a sorted run of nodes into a perfectly balanced tree: the middle node becomes the root and each half becomes
+ * one of its subtrees.
+ * @param nodes The nodes, in order.
+ * @param first Index of the first node of the run.
+ * @param last Index one past the last node of the run.
+ * @param parallelLevels The number of levels below which subtrees are linked on their own threads.
+ * @return The root of the tree, or nullptr if the run is empty.
+ */
+SplayTree::Node* SplayTree::linkBalanced(vector<Node*>& nodes, size_t first, size_t last, int parallelLevels) {
+    if (first >= last) {
+        return nullptr;
+    }
+    size_t middle = first + (last - first) / 2;
+    Node* node = nodes.at(middle);
+    if (parallelLevels > 0) {
+        thread leftLinker([&nodes, node, first, middle, parallelLevels]() {
+            node->left = linkBalanced(nodes, first, middle, parallelLevels - 1);
+        });
+        node->right = linkBalanced(nodes, middle + 1, last, parallelLevels - 1);
+        leftLinker.join();
+    }
+    else {
+        node->left = linkBalanced(nodes, first, middle, 0);
+        node->right = linkBalanced(nodes, middle + 1, last, 0);
+    }
+    return node;
+}
+
+
 // Public methods:
 // ===============
+/**
+ * Gets the highest scoring song without removing it.
+ * @return A copy of the Song with the highest score, or an empty Song if the tree is empty.
+ */
+Song SplayTree::peekMax() {
+    // Handle 'empty tree' edge case:
+    if (root == nullptr) {
+        return Song();
+    }
+    return getMaxNode(root)->val; // Not splayed, so looking at the maximum does not change the tree.
+}
+
 Song SplayTree::extractMax() {
     // Handle 'empty tree' edge case:
     if (root == nullptr) {
@@ -397,6 +560,9 @@ Song SplayTree::extractMax() {
     Node* maxNode = getMaxNode(root);
     Song output = maxNode->val;
     removeNode(maxNode);
+#ifdef SPLAYTREE_STATS
+    recordAccess(SPLAY_OP_EXTRACT_MAX);
+#endif
     numElements--;
     return output;
 }
@@ -407,34 +573,290 @@ Song SplayTree::search(int targetScore) {
         return Song();
     }
     root = splay(root, target); // Move the node that was found to the root
+#ifdef SPLAYTREE_STATS
+    recordAccess(SPLAY_OP_SEARCH);
+#endif
     return target->val;
 }
 
 
 void SplayTree::insert(Song song) {
-    Node* newNode = insertSong(song); // Insert the song and obtain pointer to the node in which it is stored.
-    numElements++;
+    bool created = false;
+    Node* newNode = insertSong(move(song), created); // Insert the song and obtain pointer to the node in which it is stored.
+    if (created) {
+        numElements++; // Only counted once, like build(), which also drops a song already in the tree.
+    }
     root = splay(root, newNode); // Move the node that was found to the root.
+#ifdef SPLAYTREE_STATS
+    recordAccess(SPLAY_OP_INSERT);
+#endif
 }
 
-bool SplayTree::remove(string songName) {
+bool SplayTree::remove(string songName, Song* removed) {
     // Get a preorder traversal of the Splay tree.
     // We are searching by songName, but the tree is not ordered by songName, so we have to check every node.
     vector<Node*> preorderTraversal;
     preorderTraversal = preorderNodes(root);
 
+#ifdef SPLAYTREE_STATS
+    stats.removeCalls++;
+    stats.removeNodesTraversed += preorderTraversal.size();
+#endif
+
     // Search for the song name in the preorder traversal linearly:
     for (unsigned int i = 0; i < preorderTraversal.size(); i++) {
         if (preorderTraversal.at(i)->val.getName() == songName) {
+            if (removed != nullptr) {
+                *removed = preorderTraversal.at(i)->val;
+            }
             removeNode(preorderTraversal.at(i));
             numElements--;
+#ifdef SPLAYTREE_STATS
+            stats.removeNodesCompared += i + 1;
+            recordAccess(SPLAY_OP_REMOVE);
+#endif
             return true;
         }
     }
 
+#ifdef SPLAYTREE_STATS
+    stats.removeNodesCompared += preorderTraversal.size();
+#endif
     return false; // The song was not in the Splay Tree.
 }
 
+/**
+ * Removes the song with both the given score and track ID. Nodes are ordered by that pair, so this is an ordinary
+ * binary search tree walk rather than the traversal remove() needs.
+ * @param score The score of the song to be removed.
+ * @param songName The track ID of the song to be removed.
+ * @return true if the song was found and removed, false otherwise.
+ */
+bool SplayTree::removeKey(int score, const string& songName) {
+    Song key(songName, score);
+    Node* curr = root;
+    while (curr != nullptr) {
+        if (nodeLess(key, curr->val)) {
+            curr = curr->left;
+        }
+        else if (nodeLess(curr->val, key)) {
+            curr = curr->right;
+        }
+        else {
+            removeNode(curr);
+            numElements--;
+#ifdef SPLAYTREE_STATS
+            recordAccess(SPLAY_OP_REMOVE);
+#endif
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Finds a song by score without splaying, so the tree is not changed and concurrent readers are safe.
+ * Finds the same song as search(), but leaves it where it is.
+ * @param targetScore The score to be searched for.
+ * @return A copy of the Song that was found, or an empty Song if no song has the score.
+ */
+Song SplayTree::find(int targetScore) const {
+    Node* target = searchNode(targetScore);
+    if (target == nullptr) {
+        return Song();
+    }
+    return target->val;
+}
+
+/**
+ * Finds one song per score in a range without splaying, so the tree is not changed and concurrent readers are safe.
+ * Each score is looked up on its own, like the menu's range search. A walk over every node in the range would visit
+ * all the songs sharing a score, and there are usually far more songs than scores.
+ * @param lowerBound The minimum score to search for.
+ * @param upperBound The maximum score to search for.
+ * @return The songs that were found, in ascending order of score. Scores with no song are left out.
+ */
+vector<Song> SplayTree::findRange(int lowerBound, int upperBound) const {
+    vector<Song> results;
+    long long width = static_cast<long long>(upperBound) - lowerBound + 1; // Too wide for an int at the extremes.
+    if (width <= numElements) {
+        for (long long score = lowerBound; score <= upperBound; score++) {
+            Node* target = searchNode(static_cast<int>(score));
+            if (target != nullptr) {
+                results.push_back(target->val);
+            }
+        }
+        return results;
+    }
+
+    // A range wider than the tree has songs only searches the scores the tree has, found in one in-order pass:
+    vector<Node*> nodes = inorderNodes(root);
+    for (unsigned int i = 0; i < nodes.size(); i++) {
+        int score = nodes.at(i)->val.getScore();
+        bool repeat = i > 0 && nodes.at(i - 1)->val.getScore() == score;
+        if (score >= lowerBound && score <= upperBound && !repeat) {
+            results.push_back(searchNode(score)->val);
+        }
+    }
+    return results;
+}
+
 int SplayTree::size() {
     return numElements;
 }
+
+/**
+ * Copies every song in the tree, without splaying.
+ * @return The songs, in ascending order of score.
+ */
+vector<Song> SplayTree::toVector() {
+    vector<Node*> nodes = inorderNodes(root);
+    vector<Song> songs;
+    songs.reserve(nodes.size());
+    for (unsigned int i = 0; i < nodes.size(); i++) {
+        songs.push_back(nodes.at(i)->val);
+    }
+    return songs;
+}
+
+/**
+ * Measures the memory used by the tree. Every node is its own allocation, so there is no slack capacity.
+ * @return The breakdown of the tree's memory.
+ */
+MemoryUsage SplayTree::memoryUsage() {
+    MemoryUsage usage;
+    vector<Node*> nodes = preorderNodes(root);
+    usage.songCount = nodes.size();
+    usage.structureBytes = nodes.size() * sizeof(Node);
+    for (unsigned int i = 0; i < nodes.size(); i++) {
+        usage.addAllocation(sizeof(Node));
+        usage.addString(nodes.at(i)->val.getName());
+    }
+    return usage;
+}
+
+
+#ifdef SPLAYTREE_STATS
+// Statistics:
+// ===========
+
+/**
+ * Constructor. Every counter starts at 0.
+ */
+SplayTreeStats::SplayTreeStats() : zigSteps(0), zigZigSteps(0), zigZagSteps(0), removeCalls(0), removeNodesTraversed(0),
+                                   removeNodesCompared(0) {
+    for (int i = 0; i < SPLAY_OP_COUNT; i++) {
+        accessCount[i] = 0;
+        accessDepthTotal[i] = 0;
+        accessDepthMax[i] = 0;
+    }
+}
+
+
+/**
+ * Records the depth of the node the last splay of the whole tree brought to the root.
+ * @param operation The operation that accessed the node.
+ */
+void SplayTree::recordAccess(SplayOperation operation) {
+    unsigned long long depth = static_cast<unsigned long long>(lastAccessDepth);
+    stats.accessCount[operation]++;
+    stats.accessDepthTotal[operation] += depth;
+    if (depth > stats.accessDepthMax[operation]) {
+        stats.accessDepthMax[operation] = depth;
+    }
+}
+
+
+/**
+ * Gets the counters collected so far.
+ * @return The tree's statistics.
+ */
+const SplayTreeStats& SplayTree::getStats() const {
+    return stats;
+}
+
+
+/**
+ * Sets every counter back to 0, e.g. to measure only the operations after the initial build.
+ */
+void SplayTree::resetStats() {
+    stats = SplayTreeStats();
+}
+
+
+/**
+ * Counts the nodes at every depth of the tree. Walks the whole tree, so it is only meant to be called on demand.
+ * @return The number of nodes at each depth, starting with the root at depth 0. The tree's height is the size.
+ */
+vector<long long> SplayTree::depthHistogram() {
+    vector<long long> histogram;
+    if (root == nullptr) {
+        return histogram;
+    }
+
+    // Depth-first traversal that keeps the depth of each node next to it:
+    stack<pair<Node*, int>> stk;
+    stk.push(make_pair(root, 0));
+    while (!stk.empty()) {
+        Node* node = stk.top().first;
+        int depth = stk.top().second;
+        stk.pop();
+
+        if (depth >= static_cast<int>(histogram.size())) {
+            histogram.resize(depth + 1, 0);
+        }
+        histogram.at(depth)++;
+
+        if (node->right != nullptr) {
+            stk.push(make_pair(node->right, depth + 1));
+        }
+        if (node->left != nullptr) {
+            stk.push(make_pair(node->left, depth + 1));
+        }
+    }
+    return histogram;
+}
+
+
+/**
+ * Prints the counters and the current shape of the tree.
+ * @param output Where to print the statistics.
+ */
+void SplayTree::printStats(ostream& output) {
+    const char* operationNames[SPLAY_OP_COUNT] = {"insert", "search", "remove", "extractMax"};
+
+    output << "Splay steps: " << stats.zigSteps << " zig, " << stats.zigZigSteps << " zig-zig, " << stats.zigZagSteps
+           << " zig-zag (" << stats.zigSteps + 2 * (stats.zigZigSteps + stats.zigZagSteps) << " rotations)" << endl;
+
+    output << "Access depth before splaying:" << endl;
+    for (int i = 0; i < SPLAY_OP_COUNT; i++) {
+        if (stats.accessCount[i] > 0) {
+            output << "  " << operationNames[i] << ": " << stats.accessCount[i] << " accesses, mean depth "
+                   << static_cast<double>(stats.accessDepthTotal[i]) / stats.accessCount[i] << ", max depth "
+                   << stats.accessDepthMax[i] << endl;
+        }
+    }
+
+    if (stats.removeCalls > 0) {
+        output << "remove: " << stats.removeCalls << " calls, " << stats.removeNodesTraversed << " nodes traversed, "
+               << stats.removeNodesCompared << " names compared" << endl;
+    }
+
+    // Current shape of the tree:
+    vector<long long> histogram = depthHistogram();
+    long long depthTotal = 0;
+    for (unsigned int depth = 0; depth < histogram.size(); depth++) {
+        depthTotal += histogram.at(depth) * depth;
+    }
+    output << "Tree height: " << histogram.size();
+    if (numElements > 0) {
+        output << ", mean node depth " << static_cast<double>(depthTotal) / numElements;
+    }
+    output << endl;
+
+    output << "Nodes per depth:" << endl;
+    for (unsigned int depth = 0; depth < histogram.size(); depth++) {
+        output << "  " << depth << ": " << histogram.at(depth) << endl;
+    }
+}
+#endif
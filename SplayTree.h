@@ -5,10 +5,54 @@
 #ifndef COP3530_PROJECT_3_SPLAYTREE_H
 #define COP3530_PROJECT_3_SPLAYTREE_H
 
-#include "song.h"
+#include "Song.h"
 #include "SongContainer.h"
+#include <utility>
 #include <vector>
 
+#ifdef SPLAYTREE_STATS
+#include <ostream>
+
+/**
+ * The operations whose access depth is tracked. build() links a balanced tree without splaying, so it is not one.
+ */
+enum SplayOperation {
+    SPLAY_OP_INSERT,
+    SPLAY_OP_SEARCH,
+    SPLAY_OP_REMOVE,
+    SPLAY_OP_EXTRACT_MAX,
+    SPLAY_OP_COUNT // Number of operations. Not an operation.
+};
+
+/**
+ * Counters of what the tree has done since it was created or the stats were last reset.
+ * Only compiled in when SPLAYTREE_STATS is defined (make STATS=1), so normal builds pay nothing for them.
+ */
+struct SplayTreeStats {
+    // Rotation steps done while splaying. A zig-zig or zig-zag step is two single rotations:
+    unsigned long long zigSteps;
+    unsigned long long zigZigSteps;
+    unsigned long long zigZagSteps;
+
+    // Depth of the node each operation accessed, before it was splayed to the root (the root has depth 0):
+    unsigned long long accessCount[SPLAY_OP_COUNT];
+    unsigned long long accessDepthTotal[SPLAY_OP_COUNT];
+    unsigned long long accessDepthMax[SPLAY_OP_COUNT];
+
+    // remove() has to traverse the tree because it is not ordered by name:
+    unsigned long long removeCalls;
+    unsigned long long removeNodesTraversed; // Nodes put into the traversal.
+    unsigned long long removeNodesCompared; // Nodes whose name was compared before the song was found (or not).
+
+    SplayTreeStats(); // ctr
+};
+#endif
+
+/**
+ * A splay tree of songs ordered by score, then track ID. A song is identified by its track ID and score together:
+ * inserting a song that is already in the tree (same ID and same score) does nothing, while the same ID with a
+ * different score is stored as another song, as in the other containers. build() drops repeats the same way.
+ */
 class SplayTree : public SongContainer {
 private:
 
@@ -19,11 +63,19 @@ private:
         Song val;
         Node* left;
         Node* right;
-        Node(const Song& song, int height = 1, Node* left = nullptr, Node* right = nullptr) : val(song), left(left), right(right) {}
+        Node(Song song, int height = 1, Node* left = nullptr, Node* right = nullptr) : val(move(song)), left(left), right(right) {}
     };
 
     Node* root; // Always points to the root Node of the SplayTree.
     int numElements; // Keeps track of the number of elements in the SplayTree.
+    vector<Node*> splayPath; // Path used by splay(). Kept between calls so splaying does not allocate once it has grown.
+
+#ifdef SPLAYTREE_STATS
+    SplayTreeStats stats;
+    int lastAccessDepth; // Depth of the node most recently splayed to the root of the whole tree.
+
+    void recordAccess(SplayOperation operation);
+#endif
 
     // Zig/Zag methods to operate on subtrees. Very similar to AVL rotations:
     Node* zigLeft(Node* node);
@@ -34,25 +86,45 @@ private:
     Node* zigZagRightLeft(Node* node);
 
     // Tree helper methods:
+    static bool nodeLess(const Song& a, const Song& b);
     Node* splay(Node* node, Node* target);
-    Node* insertSong(Song song);
+    Node* insertSong(Song song, bool& created);
     void removeNode(Node* node);
-    Node* searchNode(int targetScore); // Plan: usual splay tree search
+    Node* searchNode(int targetScore) const; // Plan: usual splay tree search
     Node* getMaxNode(Node* node);
     Node* getMinNode(Node* node);
     int getMaxScore(Node* node);
 
     vector<Node*> preorderNodes(Node* node); // Iteratively obtains a preorder traversal of the nodes in the tree.
+    static vector<Node*> inorderNodes(Node* node);
+    static Node* linkBalanced(vector<Node*>& nodes, size_t first, size_t last, int parallelLevels);
 public:
     SplayTree(); // ctr
+    virtual ~SplayTree(); // dtr
 
     // Overridden functions. See the .cpp implementation file:
     virtual void build(vector<Song>& songs);
     virtual Song extractMax();
+    virtual Song peekMax();
     virtual Song search(int targetScore);
     virtual void insert(Song song);
-    virtual bool remove(string songName);
+    virtual bool remove(string songName, Song* removed = nullptr);
+    virtual bool removeKey(int score, const string& songName);
     virtual int size();
+    virtual MemoryUsage memoryUsage();
+    virtual vector<Song> toVector();
+
+    // Read-only lookups that never splay, so several threads can run them at once. See the .cpp implementation file:
+    Song find(int targetScore) const;
+    vector<Song> findRange(int lowerBound, int upperBound) const;
+
+#ifdef SPLAYTREE_STATS
+    // Statistics. See the .cpp implementation file:
+    const SplayTreeStats& getStats() const;
+    void resetStats();
+    vector<long long> depthHistogram();
+    void printStats(ostream& output);
+#endif
 };
 
 
@@ -0,0 +1,103 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <algorithm>
+
+#include "TopKHeap.h"
+
+/**
+ * Constructor.
+ * @param capacity The number of songs to keep. Values below 0 are treated as 0.
+ */
+TopKHeap::TopKHeap(int capacity) : capacity(capacity > 0 ? capacity : 0) {
+    songs.reserve(this->capacity);
+}
+
+
+/**
+ * Swap elements down the heap to move the Song at startPos down to its correct position.
+ * @param startPos The initial position of the Song that might need to be moved.
+ */
+void TopKHeap::adjustHeapDown(int startPos) {
+    int current = startPos;
+    int size = songs.size();
+
+    while (true) {
+        int left = current * 2 + 1;
+        int right = current * 2 + 2;
+
+        // Find the smallest of current and its children:
+        int smallest = current;
+        if (left < size && songs[left] < songs[smallest]) {
+            smallest = left;
+        }
+        if (right < size && songs[right] < songs[smallest]) {
+            smallest = right;
+        }
+
+        if (smallest == current) { // Heap layout is valid again.
+            return;
+        }
+        swap(songs[current], songs[smallest]);
+        current = smallest;
+    }
+}
+
+
+/**
+ * Swap elements up the heap to move the Song at startPos up to its correct position.
+ * @param startPos The initial position of the Song that might need to be moved.
+ */
+void TopKHeap::adjustHeapUp(int startPos) {
+    int current = startPos;
+    int parent = (current - 1) / 2;
+
+    while (current > 0 && songs[current] < songs[parent]) { // while current is not at top and heap layout is invalid:
+        swap(songs[current], songs[parent]);
+        current = parent;
+        parent = (current - 1) / 2;
+    }
+}
+
+
+/**
+ * Considers a song for the top K. It is kept if there is still room, or if it beats the lowest song kept so far.
+ * @param song The song to consider.
+ */
+void TopKHeap::offer(const Song& song) {
+    if (static_cast<int>(songs.size()) < capacity) {
+        songs.push_back(song);
+        adjustHeapUp(songs.size() - 1);
+    }
+    else if (capacity > 0 && songs.front().getScore() < song.getScore()) {
+        songs.front() = song; // Replace the lowest song kept so far.
+        adjustHeapDown(0);
+    }
+}
+
+
+int TopKHeap::size() {
+    return songs.size();
+}
+
+
+/**
+ * Empties the heap.
+ * @return The songs that were kept, highest score first.
+ */
+vector<Song> TopKHeap::takeSorted() {
+    vector<Song> output;
+    output.reserve(songs.size());
+
+    // Repeatedly remove the minimum, which gives the songs in ascending order:
+    while (!songs.empty()) {
+        output.push_back(songs.front());
+        songs.front() = songs.back();
+        songs.pop_back();
+        adjustHeapDown(0);
+    }
+
+    reverse(output.begin(), output.end());
+    return output;
+}
@@ -0,0 +1,36 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_TOPKHEAP_H
+#define COP3530_PROJECT_3_TOPKHEAP_H
+
+#include <vector>
+
+#include "Song.h"
+
+using namespace std;
+
+/**
+ * Keeps the K highest scoring songs out of a stream of songs, using O(K) memory.
+ * Internally this is a min heap of at most K songs: the root is the lowest score that is still in the top K,
+ * so each new song only has to be compared against the root to know whether it makes the cut.
+ */
+class TopKHeap {
+private:
+    vector<Song> songs; // Dynamic array representation of the min heap.
+    int capacity; // K, the number of songs to keep.
+
+    // Helper methods to correct the heap layout:
+    void adjustHeapDown(int startPos);
+    void adjustHeapUp(int startPos);
+public:
+    TopKHeap(int capacity); // ctr
+
+    void offer(const Song& song);
+    int size();
+    vector<Song> takeSorted();
+};
+
+
+#endif //COP3530_PROJECT_3_TOPKHEAP_H
@@ -0,0 +1,302 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+#include "Tracer.h"
+
+/**
+ * One event on the timeline, kept in memory until the trace is written.
+ */
+struct TraceEvent {
+    char phase; // 'X' for a span, 'C' for a counter, 'M' for a thread name.
+    string name;
+    const char* category; // Always a string literal.
+    long long timestamp; // Nanoseconds since the trace started.
+    long long duration; // Nanoseconds. Spans only.
+    int threadId;
+    string arguments; // Comma separated JSON members.
+};
+
+// Checked first by every function, so tracing costs one load while it is off. Set with release and read with acquire,
+// so a thread that sees it on also sees traceStart, which it reads without the mutex:
+static atomic<bool> tracingEnabled(false);
+static mutex eventsMutex; // Guards everything below, apart from the reads of traceStart described above.
+static vector<TraceEvent> events;
+static ofstream traceFile;
+static TraceClock::time_point traceStart;
+static atomic<int> nextThreadId(1);
+
+
+/**
+ * Gets the small number that identifies the calling thread on the timeline. Numbers are handed out on first use.
+ * @return The calling thread's number.
+ */
+static int traceThreadId() {
+    static thread_local int threadId = 0;
+    if (threadId == 0) {
+        threadId = nextThreadId.fetch_add(1);
+    }
+    return threadId;
+}
+
+
+/**
+ * Adds an event to the trace, unless tracing was stopped in the meantime.
+ * @param event The event to add.
+ */
+static void addEvent(const TraceEvent& event) {
+    lock_guard<mutex> lock(eventsMutex);
+    if (tracingEnabled.load(memory_order_relaxed)) {
+        events.push_back(event);
+    }
+}
+
+
+/**
+ * Gets the time since the trace started.
+ * @param time A time point.
+ * @return Nanoseconds from the start of the trace to 'time', or 0 if 'time' is earlier.
+ */
+static long long sinceTraceStart(TraceClock::time_point time) {
+    long long nanoseconds = chrono::duration_cast<chrono::nanoseconds>(time - traceStart).count();
+    return nanoseconds > 0 ? nanoseconds : 0;
+}
+
+
+/**
+ * Escapes a string for use inside a JSON string. File paths on Windows contain backslashes.
+ * @param text The string to escape.
+ * @return The escaped string, without surrounding quotes.
+ */
+static string escapeJson(const string& text) {
+    string escaped;
+    for (unsigned int i = 0; i < text.size(); i++) {
+        char c = text.at(i);
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20) {
+            escaped += ' '; // Control characters are never meaningful in names or paths.
+        }
+        else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+
+/**
+ * Writes a time in the trace format's unit, microseconds, keeping nanosecond precision.
+ * @param output Where to write the time.
+ * @param nanoseconds The time in nanoseconds.
+ */
+static void writeMicroseconds(ostream& output, long long nanoseconds) {
+    long long fraction = nanoseconds % 1000;
+    output << nanoseconds / 1000 << '.' << (fraction < 100 ? "0" : "") << (fraction < 10 ? "0" : "") << fraction;
+}
+
+
+/**
+ * Starts recording a trace. Events from any thread are recorded until stopTracing() is called.
+ * @param filepath The JSON file to write the trace to. It is created now, so a bad path is found straight away.
+ * @return true if the file could be created, false otherwise (or if a trace is already being recorded).
+ */
+bool startTracing(const string& filepath) {
+    lock_guard<mutex> lock(eventsMutex);
+    if (tracingEnabled.load(memory_order_relaxed)) {
+        return false;
+    }
+    traceFile.open(filepath.c_str(), ios::out | ios::trunc);
+    if (!traceFile.is_open()) {
+        traceFile.clear();
+        return false;
+    }
+    events.clear();
+    traceStart = TraceClock::now();
+    tracingEnabled.store(true, memory_order_release);
+    return true;
+}
+
+
+/**
+ * Stops recording and writes every event to the file given to startTracing().
+ * @return true if the trace was written, false if it could not be (or if no trace was being recorded).
+ */
+bool stopTracing() {
+    lock_guard<mutex> lock(eventsMutex);
+    if (!tracingEnabled.load(memory_order_relaxed)) {
+        return false;
+    }
+    tracingEnabled.store(false, memory_order_relaxed);
+
+    traceFile << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[" << endl;
+    traceFile << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"lyricpsy\"}}";
+    for (unsigned int i = 0; i < events.size(); i++) {
+        const TraceEvent& event = events.at(i);
+        traceFile << ',' << endl << "{\"name\":\"" << escapeJson(event.name) << "\",\"ph\":\"" << event.phase
+                  << "\",\"pid\":1,\"tid\":" << event.threadId;
+        if (event.phase != 'M') { // Thread names have no time.
+            traceFile << ",\"cat\":\"" << event.category << "\",\"ts\":";
+            writeMicroseconds(traceFile, event.timestamp);
+        }
+        if (event.phase == 'X') {
+            traceFile << ",\"dur\":";
+            writeMicroseconds(traceFile, event.duration);
+        }
+        traceFile << ",\"args\":{" << event.arguments << "}}";
+    }
+    traceFile << endl << "]}" << endl;
+
+    bool written = !traceFile.fail();
+    traceFile.close();
+    events.clear();
+    events.shrink_to_fit();
+    return written;
+}
+
+
+/**
+ * Checks whether a trace is being recorded. Useful to skip building arguments that would not be used.
+ * @return true between startTracing() and stopTracing(), false otherwise.
+ */
+bool isTracing() {
+    return tracingEnabled.load(memory_order_acquire);
+}
+
+
+/**
+ * Names the calling thread's row on the timeline. Unnamed threads are shown by number.
+ * @param name The name to show.
+ */
+void traceThreadName(const string& name) {
+    if (!isTracing()) {
+        return;
+    }
+    TraceEvent event = {'M', "thread_name", "", 0, 0, traceThreadId(), traceArgument("name", name)};
+    addEvent(event);
+}
+
+
+/**
+ * Records a span of time on the calling thread's row.
+ * @param name The name shown on the span.
+ * @param category The group the span belongs to (e.g. "ingest" or "query"). Must be a string literal.
+ * @param start When the span started.
+ * @param end When the span ended.
+ * @param arguments Extra details shown when the span is selected, built with traceArgument() and joined with commas.
+ */
+void traceSpan(const char* name, const char* category, TraceClock::time_point start, TraceClock::time_point end,
+               const string& arguments) {
+    if (!isTracing()) {
+        return;
+    }
+    long long startNs = sinceTraceStart(start);
+    long long endNs = sinceTraceStart(end);
+    TraceEvent event = {'X', name, category, startNs, endNs > startNs ? endNs - startNs : 0, traceThreadId(), arguments};
+    addEvent(event);
+}
+
+
+/**
+ * Records the current value of a counter. Each counter is drawn as its own graph above the thread rows.
+ * @param name The counter's name (e.g. "container size").
+ * @param value The counter's value now.
+ */
+void traceCounter(const char* name, long long value) {
+    if (!isTracing()) {
+        return;
+    }
+    TraceEvent event = {'C', name, "counter", sinceTraceStart(TraceClock::now()), 0, traceThreadId(),
+                        traceArgument("value", value)};
+    addEvent(event);
+}
+
+
+/**
+ * Formats a number argument for traceSpan().
+ * @param key The argument's name.
+ * @param value The argument's value.
+ * @return The argument as a JSON member.
+ */
+string traceArgument(const char* key, long long value) {
+    return "\"" + escapeJson(key) + "\":" + to_string(value);
+}
+
+
+/**
+ * Formats a text argument for traceSpan().
+ * @param key The argument's name.
+ * @param value The argument's value.
+ * @return The argument as a JSON member.
+ */
+string traceArgument(const char* key, const string& value) {
+    return "\"" + escapeJson(key) + "\":\"" + escapeJson(value) + "\"";
+}
+
+
+// TraceScope:
+// ===========
+
+/**
+ * Constructor. The span starts now.
+ * @param name The name shown on the span. Must be a string literal.
+ * @param category The group the span belongs to. Must be a string literal.
+ */
+TraceScope::TraceScope(const char* name, const char* category) : name(name), category(category), ended(false) {
+    if (isTracing()) {
+        startTime = TraceClock::now();
+    }
+}
+
+
+/**
+ * Destructor ends the span if end() was not called.
+ */
+TraceScope::~TraceScope() {
+    end();
+}
+
+
+/**
+ * Adds a number shown when the span is selected.
+ * @param key The argument's name.
+ * @param value The argument's value.
+ */
+void TraceScope::addArgument(const char* key, long long value) {
+    if (isTracing()) {
+        arguments += (arguments.empty() ? "" : ",") + traceArgument(key, value);
+    }
+}
+
+
+/**
+ * Adds a text shown when the span is selected.
+ * @param key The argument's name.
+ * @param value The argument's value.
+ */
+void TraceScope::addArgument(const char* key, const string& value) {
+    if (isTracing()) {
+        arguments += (arguments.empty() ? "" : ",") + traceArgument(key, value);
+    }
+}
+
+
+/**
+ * Ends the span now, before the object goes out of scope. Later calls do nothing.
+ */
+void TraceScope::end() {
+    if (ended) {
+        return;
+    }
+    ended = true;
+    if (isTracing() && startTime != TraceClock::time_point()) {
+        traceSpan(name, category, startTime, TraceClock::now(), arguments);
+    }
+}
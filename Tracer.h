@@ -0,0 +1,58 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_TRACER_H
+#define COP3530_PROJECT_3_TRACER_H
+
+#include <chrono>
+#include <string>
+
+using namespace std;
+
+/**
+ * Timeline of a session in the Chrome trace event format, which can be opened in Perfetto (ui.perfetto.dev) or
+ * chrome://tracing.
+ *
+ * Tracing is off until startTracing() is called. While it is off, every function below returns after reading a single
+ * atomic flag. While it is on, events are kept in memory and only written to the file by stopTracing(), so no file I/O
+ * happens while the program is being measured. Every thread gets its own row on the timeline.
+ *
+ * Times use the same clock as the rest of the program, so spans can reuse the time points of the existing timings.
+ */
+typedef chrono::high_resolution_clock TraceClock;
+
+// Tracing functions. See the .cpp implementation file:
+bool startTracing(const string& filepath);
+bool stopTracing();
+bool isTracing();
+void traceThreadName(const string& name);
+void traceSpan(const char* name, const char* category, TraceClock::time_point start, TraceClock::time_point end,
+               const string& arguments = "");
+void traceCounter(const char* name, long long value);
+string traceArgument(const char* key, long long value);
+string traceArgument(const char* key, const string& value);
+
+/**
+ * Records a span covering the lifetime of the object, for phases that have no timing of their own.
+ * Arguments added while the span is open are shown when the span is selected on the timeline.
+ */
+class TraceScope {
+private:
+    const char* name;
+    const char* category;
+    TraceClock::time_point startTime;
+    string arguments; // Comma separated JSON members, built by traceArgument().
+    bool ended;
+
+public:
+    TraceScope(const char* name, const char* category); // ctr
+    ~TraceScope(); // dtr
+
+    void addArgument(const char* key, long long value);
+    void addArgument(const char* key, const string& value);
+    void end();
+};
+
+
+#endif //COP3530_PROJECT_3_TRACER_H
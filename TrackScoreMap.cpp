@@ -0,0 +1,262 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <cstring>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "TrackScoreMap.h"
+
+// Definitions for the static constants, needed when they are passed by reference:
+const int TrackScoreMap::KEY_LENGTH;
+const int TrackScoreMap::GROUP_SIZE;
+const int8_t TrackScoreMap::EMPTY;
+
+
+/**
+ * Converts the name of a merge policy as typed by the user into a MergePolicy.
+ * @param name One of "sum", "max" or "last".
+ * @param policy Set to the matching policy.
+ * @return true if the name was recognised, false otherwise.
+ */
+bool parseMergePolicy(const string& name, MergePolicy& policy) {
+    if (name == "sum") {
+        policy = MergePolicy::SUM;
+    }
+    else if (name == "max") {
+        policy = MergePolicy::MAX;
+    }
+    else if (name == "last") {
+        policy = MergePolicy::LAST;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * Constructor. Optionally sizes the table up front so it never has to grow during ingest.
+ * @param expectedTracks The number of distinct tracks that are expected to be added.
+ */
+TrackScoreMap::TrackScoreMap(size_t expectedTracks) : groupMask(0) {
+    rehash(1);
+    reserve(expectedTracks);
+}
+
+
+/**
+ * Grows the table so that it can hold expectedTracks entries without rehashing.
+ * @param expectedTracks The number of distinct tracks that are expected to be added.
+ */
+void TrackScoreMap::reserve(size_t expectedTracks) {
+    // The table is kept at most 7/8 full so that probe sequences stay short:
+    size_t groupCount = groupMask + 1;
+    while (groupCount * GROUP_SIZE * 7 / 8 < expectedTracks) {
+        groupCount *= 2;
+    }
+    if (groupCount != groupMask + 1) {
+        rehash(groupCount);
+    }
+    keys.reserve(expectedTracks);
+    songs.reserve(expectedTracks);
+}
+
+
+/**
+ * Hashes a packed key. The 18 bytes are read as two 64 bit words and one 16 bit word and mixed together.
+ * @param key The key to be hashed.
+ * @return A 64 bit hash of the key.
+ */
+uint64_t TrackScoreMap::hashKey(const TrackKey& key) {
+    uint64_t first;
+    uint64_t second;
+    uint16_t third;
+    memcpy(&first, key.bytes, 8);
+    memcpy(&second, key.bytes + 8, 8);
+    memcpy(&third, key.bytes + 16, 2);
+
+    uint64_t hash = first * 0x9E3779B97F4A7C15ULL;
+    hash ^= (second + third) * 0xC2B2AE3D27D4EB4FULL;
+
+    // Final avalanche step (taken from MurmurHash3's fmix64) so that both the low and high bits are well mixed:
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+
+/**
+ * Compares every control byte in a group against a tag.
+ * @param group Pointer to the first of GROUP_SIZE control bytes.
+ * @param tag The control byte to look for.
+ * @return A bitmask with bit i set if control byte i of the group equals tag.
+ */
+unsigned int TrackScoreMap::matchGroup(const int8_t* group, int8_t tag) {
+#ifdef __SSE2__
+    __m128i controlBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    return static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(controlBytes, _mm_set1_epi8(tag))));
+#else
+    // Portable fallback for targets without SSE2:
+    unsigned int mask = 0;
+    for (int i = 0; i < GROUP_SIZE; i++) {
+        if (group[i] == tag) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+
+/**
+ * Rebuilds the slot arrays with a new number of groups and reinserts every existing entry.
+ * @param groupCount The new number of groups. Must be a power of two.
+ */
+void TrackScoreMap::rehash(size_t groupCount) {
+    groupMask = groupCount - 1;
+    control.assign(groupCount * GROUP_SIZE, EMPTY);
+    slots.assign(groupCount * GROUP_SIZE, -1);
+
+    for (unsigned int i = 0; i < keys.size(); i++) {
+        uint64_t hash = hashKey(keys.at(i));
+        int8_t tag = static_cast<int8_t>(hash & 0x7F);
+        size_t group = (hash >> 7) & groupMask;
+
+        // Entries are unique, so the first empty slot in the probe sequence is always the right place:
+        unsigned int emptyMask = matchGroup(&control[group * GROUP_SIZE], EMPTY);
+        while (emptyMask == 0) {
+            group = (group + 1) & groupMask;
+            emptyMask = matchGroup(&control[group * GROUP_SIZE], EMPTY);
+        }
+        size_t slot = group * GROUP_SIZE + __builtin_ctz(emptyMask);
+        control[slot] = tag;
+        slots[slot] = i;
+    }
+}
+
+
+/**
+ * Finds the entry for a key, creating it with a score of 0 if it does not exist yet.
+ * @param key The packed key to look for.
+ * @param hash The hash of the key.
+ * @param trackId The unpacked track ID. Only used if a new entry is created.
+ * @return The index of the entry in 'songs'.
+ */
+int TrackScoreMap::findOrInsert(const TrackKey& key, uint64_t hash, const char* trackId) {
+    int8_t tag = static_cast<int8_t>(hash & 0x7F);
+    size_t group = (hash >> 7) & groupMask;
+
+    // Probe group by group until either the key or an empty slot is found:
+    while (true) {
+        const int8_t* groupControl = &control[group * GROUP_SIZE];
+
+        // Only slots whose tag matches need their key compared:
+        unsigned int candidates = matchGroup(groupControl, tag);
+        while (candidates != 0) {
+            size_t slot = group * GROUP_SIZE + __builtin_ctz(candidates);
+            if (memcmp(keys[slots[slot]].bytes, key.bytes, KEY_LENGTH) == 0) {
+                return slots[slot];
+            }
+            candidates &= candidates - 1; // Clear the lowest set bit.
+        }
+
+        // Nothing is ever erased, so an empty slot means the key is not in the table:
+        unsigned int emptyMask = matchGroup(groupControl, EMPTY);
+        if (emptyMask != 0) {
+            int index = songs.size();
+            keys.push_back(key);
+            songs.push_back(Song(string(trackId, KEY_LENGTH), 0));
+
+            // Grow if the table is now too full. Rehashing also places the new entry, so we are done:
+            if (songs.size() > (groupMask + 1) * GROUP_SIZE * 7 / 8) {
+                rehash((groupMask + 1) * 2);
+                return index;
+            }
+
+            size_t slot = group * GROUP_SIZE + __builtin_ctz(emptyMask);
+            control[slot] = tag;
+            slots[slot] = index;
+            return index;
+        }
+
+        group = (group + 1) & groupMask;
+    }
+}
+
+
+/**
+ * Adds a word count to the score of a track, creating the track if it has not been seen before.
+ * @param trackId The track ID. Does not need to be null terminated.
+ * @param idLength The number of characters in trackId.
+ * @param score The amount to add to the track's score.
+ * @return true if the score was added, false if the track ID does not have the expected length.
+ */
+bool TrackScoreMap::addScore(const char* trackId, int idLength, int score) {
+    if (idLength != KEY_LENGTH) {
+        return false;
+    }
+
+    TrackKey key;
+    memcpy(key.bytes, trackId, KEY_LENGTH);
+
+    Song& song = songs[findOrInsert(key, hashKey(key), trackId)];
+    song.setScore(song.getScore() + score);
+    return true;
+}
+
+
+/**
+ * Merges the entries of another map into this one.
+ * @param other The map to merge in. Left in a valid but unspecified state, because its storage may be taken over.
+ * @param policy How to combine the scores of tracks that are in both maps.
+ */
+void TrackScoreMap::merge(TrackScoreMap& other, MergePolicy policy) {
+    // Every policy gives the other map's scores when this map is empty, so its storage can simply be taken over:
+    if (songs.empty()) {
+        *this = move(other);
+        return;
+    }
+
+    reserve(songs.size() + other.songs.size());
+    for (unsigned int i = 0; i < other.keys.size(); i++) {
+        const TrackKey& key = other.keys[i];
+        int otherScore = other.songs[i].getScore();
+
+        unsigned int sizeBefore = songs.size();
+        Song& song = songs[findOrInsert(key, hashKey(key), key.bytes)];
+        bool isNew = songs.size() > sizeBefore;
+
+        if (isNew || policy == MergePolicy::LAST) {
+            song.setScore(otherScore);
+        }
+        else if (policy == MergePolicy::SUM) {
+            song.setScore(song.getScore() + otherScore);
+        }
+        else if (otherScore > song.getScore()) { // MergePolicy::MAX
+            song.setScore(otherScore);
+        }
+    }
+}
+
+
+int TrackScoreMap::size() const {
+    return songs.size();
+}
+
+
+/**
+ * Provides the aggregated entries. The vector can be passed directly to SongContainer::build.
+ * @return A reference to the dense vector of Songs held by the map.
+ */
+vector<Song>& TrackScoreMap::getSongs() {
+    return songs;
+}
@@ -0,0 +1,70 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_TRACKSCOREMAP_H
+#define COP3530_PROJECT_3_TRACKSCOREMAP_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Song.h"
+
+using namespace std;
+
+/**
+ * How to combine the scores of a track that appears in more than one map.
+ */
+enum class MergePolicy {
+    SUM, // Add the scores together.
+    MAX, // Keep the highest score.
+    LAST // Keep the score from the map merged last.
+};
+
+bool parseMergePolicy(const string& name, MergePolicy& policy);
+
+/**
+ * Open-addressing hash map from track ID to narcissism score. Used to aggregate the word counts read from the database.
+ * Slots are probed linearly in groups of 16. Each slot has a control byte holding 7 bits of the key's hash, so a whole
+ * group can be checked against a key with one SIMD comparison before any key bytes are touched (Swiss table style).
+ * The aggregated entries are stored densely as Songs, so the finished map can be handed straight to build().
+ */
+class TrackScoreMap {
+public:
+    static const int KEY_LENGTH = 18; // Every track ID in the dataset is exactly 18 characters long, e.g. TRAAAAV128F421A322.
+
+private:
+    static const int GROUP_SIZE = 16; // Number of control bytes compared at once.
+    static const int8_t EMPTY = -128; // Control byte of an unused slot. Hash tags are always in the range 0-127.
+
+    /**
+     * Inner struct to store a track ID packed into a fixed number of bytes.
+     */
+    struct TrackKey {
+        char bytes[KEY_LENGTH];
+    };
+
+    vector<int8_t> control; // One control byte per slot: either EMPTY or the 7 bit tag of the key stored in the slot.
+    vector<int> slots; // For every used slot, the index of its entry in 'keys' and 'songs'.
+    vector<TrackKey> keys; // Packed key of every entry. Parallel to 'songs'.
+    vector<Song> songs; // Dense entry storage in insertion order.
+    size_t groupMask; // Number of groups - 1. The number of groups is always a power of two.
+
+    // Helper methods:
+    static uint64_t hashKey(const TrackKey& key);
+    static unsigned int matchGroup(const int8_t* group, int8_t tag);
+    void rehash(size_t groupCount);
+    int findOrInsert(const TrackKey& key, uint64_t hash, const char* trackId);
+
+public:
+    TrackScoreMap(size_t expectedTracks = 0); // ctr
+
+    void reserve(size_t expectedTracks);
+    bool addScore(const char* trackId, int idLength, int score);
+    void merge(TrackScoreMap& other, MergePolicy policy);
+    int size() const;
+    vector<Song>& getSongs();
+};
+
+
+#endif //COP3530_PROJECT_3_TRACKSCOREMAP_H
@@ -0,0 +1,138 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include "Tracer.h"
+#include "WorkStealingPool.h"
+
+// The pool and worker the calling thread belongs to, so that tasks submitted by a task stay on its worker's queue:
+static thread_local WorkStealingPool* currentPool = nullptr;
+static thread_local unsigned int currentWorker = 0;
+
+/**
+ * Constructor. Starts the worker threads.
+ * @param threadCount The number of worker threads. Values below 1 are treated as 1.
+ * @param threadName The name workers are shown with on trace timelines, followed by their number.
+ */
+WorkStealingPool::WorkStealingPool(int threadCount, const string& threadName)
+    : threadName(threadName), queuedTasks(0), unfinishedTasks(0), nextWorker(0), stopping(false) {
+    if (threadCount < 1) {
+        threadCount = 1;
+    }
+    for (int i = 0; i < threadCount; i++) {
+        workers.push_back(new Worker());
+    }
+    for (int i = 0; i < threadCount; i++) {
+        threads.push_back(thread(&WorkStealingPool::workerLoop, this, static_cast<unsigned int>(i)));
+    }
+}
+
+
+/**
+ * Destructor. Runs every task still queued, then stops the workers.
+ */
+WorkStealingPool::~WorkStealingPool() {
+    {
+        lock_guard<mutex> lock(idleLock);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (unsigned int i = 0; i < threads.size(); i++) {
+        threads.at(i).join();
+    }
+    for (unsigned int i = 0; i < workers.size(); i++) {
+        delete workers.at(i);
+    }
+}
+
+
+/**
+ * Queues a task. From inside a task it goes on the running worker's own queue, otherwise on the next worker's in turn.
+ * @param task The task to run.
+ */
+void WorkStealingPool::submit(function<void()> task) {
+    unsigned int index = currentPool == this ? currentWorker : nextWorker.fetch_add(1) % workers.size();
+    unfinishedTasks.fetch_add(1);
+    {
+        lock_guard<mutex> lock(workers.at(index)->lock);
+        workers.at(index)->tasks.push_back(move(task));
+    }
+    queuedTasks.fetch_add(1);
+
+    // Taking the lock makes sure a worker about to sleep either sees the new task or is already waiting to be woken:
+    {
+        lock_guard<mutex> lock(idleLock);
+    }
+    workAvailable.notify_one();
+}
+
+
+/**
+ * Waits until every task submitted so far, and every task they submitted, has finished.
+ * Must not be called from inside a task, since the calling worker would be waiting for itself.
+ */
+void WorkStealingPool::wait() {
+    unique_lock<mutex> lock(idleLock);
+    allDone.wait(lock, [this]() { return unfinishedTasks.load() == 0; });
+}
+
+
+int WorkStealingPool::getThreadCount() const {
+    return static_cast<int>(workers.size());
+}
+
+
+/**
+ * Takes the next task for a worker: the newest task on its own queue, or else the oldest task on another worker's.
+ * @param index The worker looking for a task.
+ * @param task Populated with the task, if one was found.
+ * @return true if a task was found, false if every queue was empty.
+ */
+bool WorkStealingPool::takeTask(unsigned int index, function<void()>& task) {
+    for (unsigned int i = 0; i < workers.size(); i++) {
+        Worker* worker = workers.at((index + i) % workers.size());
+        lock_guard<mutex> lock(worker->lock);
+        if (!worker->tasks.empty()) {
+            if (i == 0) {
+                task = move(worker->tasks.back());
+                worker->tasks.pop_back();
+            }
+            else {
+                task = move(worker->tasks.front()); // Stolen.
+                worker->tasks.pop_front();
+            }
+            queuedTasks.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * Runs tasks until the pool is destroyed, sleeping whenever there is nothing to do.
+ * @param index The worker this thread runs.
+ */
+void WorkStealingPool::workerLoop(unsigned int index) {
+    currentPool = this;
+    currentWorker = index;
+    traceThreadName(threadName + " " + to_string(index + 1));
+
+    while (true) {
+        function<void()> task;
+        if (takeTask(index, task)) {
+            task();
+            if (unfinishedTasks.fetch_sub(1) == 1) {
+                lock_guard<mutex> lock(idleLock);
+                allDone.notify_all();
+            }
+            continue;
+        }
+
+        unique_lock<mutex> lock(idleLock);
+        workAvailable.wait(lock, [this]() { return stopping || queuedTasks.load() > 0; });
+        if (stopping && queuedTasks.load() == 0) {
+            return;
+        }
+    }
+}
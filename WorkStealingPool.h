@@ -0,0 +1,63 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_WORKSTEALINGPOOL_H
+#define COP3530_PROJECT_3_WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * A fixed set of worker threads that run submitted tasks, balancing the load by work stealing.
+ *
+ * Every worker has its own queue of tasks. A task submitted from inside a worker goes on that worker's own queue,
+ * which the worker takes from newest first, so a task that splits itself in two keeps working on data that is still
+ * in its cache. A worker whose queue is empty steals the oldest task from another worker's queue, which is usually the
+ * biggest piece of work left there. Tasks submitted from outside the pool are dealt out to the workers in turn.
+ */
+class WorkStealingPool {
+private:
+    /**
+     * One worker's queue of tasks and the lock that guards it. Only the owner takes from the back; thieves take from
+     * the front.
+     */
+    struct Worker {
+        mutex lock;
+        deque<function<void()>> tasks;
+    };
+
+    vector<Worker*> workers;
+    vector<thread> threads;
+    string threadName; // Workers are named "<threadName> <n>" on trace timelines.
+
+    mutex idleLock; // Guards sleeping and waking. The counts below are only changed while it is held when they hit 0.
+    condition_variable workAvailable; // Signalled when a task is submitted or the pool is stopping.
+    condition_variable allDone; // Signalled when the last unfinished task finishes.
+    atomic<int> queuedTasks; // Tasks waiting in a queue.
+    atomic<int> unfinishedTasks; // Tasks submitted but not finished yet, including running ones.
+    atomic<unsigned int> nextWorker; // Queue that gets the next task submitted from outside the pool.
+    bool stopping;
+
+    void workerLoop(unsigned int index);
+    bool takeTask(unsigned int index, function<void()>& task);
+
+public:
+    WorkStealingPool(int threadCount, const string& threadName = "pool worker"); // ctr
+    ~WorkStealingPool(); // dtr
+
+    void submit(function<void()> task);
+    void wait();
+    int getThreadCount() const;
+};
+
+
+#endif //COP3530_PROJECT_3_WORKSTEALINGPOOL_H
@@ -0,0 +1,760 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <unordered_set>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "SongDatabase.h"
+#include "SongSnapshot.h"
+#include "WriteAheadLog.h"
+
+static const char LOG_MAGIC[8] = {'L', 'P', 'S', 'Y', 'W', 'L', 'O', 'G'};
+static const uint32_t LOG_VERSION = 2;
+static const size_t HEADER_BYTES = 12; // Magic and version.
+static const size_t RECORD_HEADER_BYTES = 8; // Payload length and checksum.
+static const uint32_t MAX_PAYLOAD_BYTES = 1 << 20; // Anything longer is taken to be a damaged length.
+static const size_t READ_CHUNK_BYTES = 1 << 20;
+
+
+/**
+ * Stores an integer as little-endian bytes, so logs are portable between machines.
+ * @param bytes Where to store the integer.
+ * @param value The integer to store.
+ * @param size The number of bytes to store.
+ */
+static void storeLittleEndian(unsigned char* bytes, uint64_t value, int size) {
+    for (int i = 0; i < size; i++) {
+        bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+
+/**
+ * Loads an integer stored by storeLittleEndian.
+ * @param bytes Where the integer is stored.
+ * @param size The number of bytes to load.
+ * @return The integer.
+ */
+static uint64_t loadLittleEndian(const unsigned char* bytes, int size) {
+    uint64_t value = 0;
+    for (int i = 0; i < size; i++) {
+        value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+    }
+    return value;
+}
+
+
+/**
+ * Computes the 32-bit FNV-1a hash of a record's payload, which tells a complete record from one cut off or damaged.
+ * @param bytes The payload.
+ * @param length The payload's length.
+ * @return The checksum.
+ */
+static uint32_t recordChecksum(const unsigned char* bytes, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+
+/**
+ * Adds one record to the end of a buffer. The payload is the type, then head, then tail.
+ * @param output The buffer.
+ * @param type The record's type.
+ * @param head The first part of the record's body.
+ * @param headLength The length of head.
+ * @param tail The rest of the record's body.
+ * @param tailLength The length of tail.
+ */
+static void encodeRecord(vector<unsigned char>& output, LogRecordType type, const unsigned char* head, size_t headLength,
+                         const char* tail, size_t tailLength) {
+    size_t payloadLength = 1 + headLength + tailLength;
+    size_t start = output.size();
+    output.resize(start + RECORD_HEADER_BYTES + payloadLength);
+    unsigned char* payload = output.data() + start + RECORD_HEADER_BYTES;
+    payload[0] = static_cast<unsigned char>(type);
+    if (headLength > 0) {
+        memcpy(payload + 1, head, headLength);
+    }
+    if (tailLength > 0) {
+        memcpy(payload + 1 + headLength, tail, tailLength);
+    }
+    storeLittleEndian(output.data() + start, payloadLength, 4);
+    storeLittleEndian(output.data() + start + 4, recordChecksum(payload, payloadLength), 4);
+}
+
+
+/**
+ * Pushes everything written to a file so far as far as a sync mode asks for.
+ * @param file The file. Must have been flushed.
+ * @param syncMode How far to push it. Only Linux can sync; elsewhere every mode is the same as NONE.
+ * @return true if the sync worked, false otherwise.
+ */
+static bool syncFile(FILE* file, WalSyncMode syncMode) {
+#ifdef __linux__
+    if (syncMode == WalSyncMode::DATA) {
+        return fdatasync(fileno(file)) == 0;
+    }
+    if (syncMode == WalSyncMode::FULL) {
+        return fsync(fileno(file)) == 0;
+    }
+#else
+    (void) file;
+    (void) syncMode;
+#endif
+    return true;
+}
+
+
+/**
+ * Syncs a file that has already been written and closed, or a directory (so that a file renamed into it stays renamed).
+ * @param path The path of the file or directory.
+ * @return true if the sync worked, false otherwise.
+ */
+static bool syncPath(const string& path) {
+#ifdef __linux__
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return false;
+    }
+    bool synced = fsync(fd) == 0;
+    close(fd);
+    return synced;
+#else
+    (void) path;
+    return true;
+#endif
+}
+
+
+/**
+ * Gets the directory a file is in, for syncPath().
+ * @param filepath The path of the file.
+ * @return The directory's path.
+ */
+static string directoryOf(const string& filepath) {
+    string directory = filesystem::path(filepath).parent_path().string();
+    return directory.empty() ? "." : directory;
+}
+
+
+/**
+ * Gets the number of a snapshot written by WriteAheadLog::compact() from its path.
+ * @param path The path of the file a log is based on.
+ * @param prefix The start of the log's snapshot paths, "<log>.snap.".
+ * @return The snapshot's number, or 0 if the path is not one of the log's snapshots (e.g. it is a database).
+ */
+static int parseSnapshotGeneration(const string& path, const string& prefix) {
+    // Up to 9 digits always fit in an int. compact() never writes a leading zero:
+    if (path.size() <= prefix.size() || path.size() - prefix.size() > 9 || path.compare(0, prefix.size(), prefix) != 0
+        || path.at(prefix.size()) == '0') {
+        return 0;
+    }
+    int generation = 0;
+    for (size_t i = prefix.size(); i < path.size(); i++) {
+        if (path.at(i) < '0' || path.at(i) > '9') {
+            return 0;
+        }
+        generation = generation * 10 + (path.at(i) - '0');
+    }
+    return generation;
+}
+
+
+/**
+ * Decodes one record's payload into the contents read so far.
+ * @param payload The payload.
+ * @param length The payload's length. At least 1.
+ * @param contents The contents read so far, which the record is added to.
+ * @return true if the record is valid where it is, false otherwise.
+ */
+static bool decodeRecord(const unsigned char* payload, size_t length, LogContents& contents) {
+    const unsigned char* body = payload + 1;
+    size_t bodyLength = length - 1;
+
+    if (payload[0] == LOG_BASE) {
+        // A base is only valid as the very first record:
+        if (contents.hasBase || !contents.changes.empty() || bodyLength < 5 || body[0] > static_cast<int>(MergePolicy::LAST)) {
+            return false;
+        }
+        uint64_t fileCount = loadLittleEndian(body + 1, 4);
+        size_t offset = 5;
+        vector<string> filepaths;
+        for (uint64_t i = 0; i < fileCount; i++) {
+            if (offset + 4 > bodyLength) {
+                return false;
+            }
+            uint64_t pathLength = loadLittleEndian(body + offset, 4);
+            offset += 4;
+            if (pathLength > bodyLength - offset) {
+                return false;
+            }
+            filepaths.push_back(string(reinterpret_cast<const char*>(body + offset), pathLength));
+            offset += pathLength;
+        }
+        if (offset != bodyLength) {
+            return false; // Trailing bytes. The contents are left as they were.
+        }
+        contents.hasBase = true;
+        contents.baseFilepaths = filepaths;
+        contents.basePolicy = static_cast<MergePolicy>(body[0]);
+        return true;
+    }
+
+    // Inserts and removes both hold the song's score and track ID:
+    if ((payload[0] != LOG_INSERT && payload[0] != LOG_REMOVE) || bodyLength < 4) {
+        return false;
+    }
+    LogChange change;
+    int score = static_cast<int>(static_cast<uint32_t>(loadLittleEndian(body, 4)));
+    change.type = static_cast<LogRecordType>(payload[0]);
+    change.song = Song(string(reinterpret_cast<const char*>(body + 4), bodyLength - 4), score);
+    contents.changes.push_back(change);
+    return true;
+}
+
+
+/**
+ * Parses a sync mode name.
+ * @param name "none", "data" or "full".
+ * @param mode Set to the matching mode.
+ * @return true if the name was recognised, false otherwise.
+ */
+bool parseWalSyncMode(const string& name, WalSyncMode& mode) {
+    if (name == "none") {
+        mode = WalSyncMode::NONE;
+    }
+    else if (name == "data") {
+        mode = WalSyncMode::DATA;
+    }
+    else if (name == "full") {
+        mode = WalSyncMode::FULL;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * Constructor. Empty contents, with no base.
+ */
+LogContents::LogContents() : hasBase(false), basePolicy(MergePolicy::SUM), validBytes(0), fileBytes(0) {}
+
+
+/**
+ * Reads every complete record of a log. Reading stops at the first record that was cut off or damaged.
+ * @param filepath The path to the log. A log that does not exist yet is read as an empty one.
+ * @param contents Populated with the base and the changes.
+ * @return true if the log was read, false if it could not be opened or is not a log.
+ */
+bool readLog(const string& filepath, LogContents& contents) {
+    contents = LogContents();
+    FILE* input = fopen(filepath.c_str(), "rb");
+    if (input == nullptr) {
+        return errno == ENOENT;
+    }
+    vector<unsigned char> bytes;
+    size_t bytesRead = 0;
+    do {
+        bytes.resize(bytes.size() + READ_CHUNK_BYTES);
+        bytesRead = fread(bytes.data() + bytes.size() - READ_CHUNK_BYTES, 1, READ_CHUNK_BYTES, input);
+        bytes.resize(bytes.size() - READ_CHUNK_BYTES + bytesRead);
+    } while (bytesRead == READ_CHUNK_BYTES);
+    bool readError = ferror(input) != 0;
+    fclose(input);
+    if (readError) {
+        return false;
+    }
+    contents.fileBytes = bytes.size();
+
+    // A header cut off while the log was being created counts as an empty log:
+    unsigned char header[HEADER_BYTES];
+    memcpy(header, LOG_MAGIC, sizeof(LOG_MAGIC));
+    storeLittleEndian(header + 8, LOG_VERSION, 4);
+    if (bytes.size() < HEADER_BYTES) {
+        return bytes.empty() || memcmp(bytes.data(), header, bytes.size()) == 0;
+    }
+    if (memcmp(bytes.data(), header, HEADER_BYTES) != 0) {
+        return false;
+    }
+
+    size_t offset = HEADER_BYTES;
+    while (offset + RECORD_HEADER_BYTES <= bytes.size()) {
+        uint64_t payloadLength = loadLittleEndian(bytes.data() + offset, 4);
+        uint64_t checksum = loadLittleEndian(bytes.data() + offset + 4, 4);
+        const unsigned char* payload = bytes.data() + offset + RECORD_HEADER_BYTES;
+        if (payloadLength == 0 || payloadLength > MAX_PAYLOAD_BYTES || payloadLength > bytes.size() - offset - RECORD_HEADER_BYTES
+            || checksum != recordChecksum(payload, payloadLength) || !decodeRecord(payload, payloadLength, contents)) {
+            break;
+        }
+        offset += RECORD_HEADER_BYTES + payloadLength;
+    }
+    contents.validBytes = offset;
+    return true;
+}
+
+
+/**
+ * Makes one logged change to a container.
+ * @param container The container.
+ * @param change The change.
+ */
+void applyLogChange(SongContainer* container, const LogChange& change) {
+    if (change.type == LOG_INSERT) {
+        container->insert(change.song);
+    }
+    else {
+        container->removeKey(change.song.getScore(), change.song.getName());
+    }
+}
+
+
+/**
+ * Rebuilds a container from a log: loads the files it is based on (like readSqliteDbs), then makes every logged change.
+ * @param filepath The path to the log. A log that does not exist yet leaves the container as it is.
+ * @param container The container to rebuild. Should be empty.
+ * @param contents Populated with what was read from the log.
+ * @return true if the container was rebuilt, false if the log or one of its base files could not be read.
+ */
+bool restoreFromLog(const string& filepath, SongContainer* container, LogContents& contents) {
+    if (!readLog(filepath, contents)) {
+        return false;
+    }
+    if (contents.hasBase) {
+        TrackScoreMap songScores;
+        if (!readSqliteDbs(contents.baseFilepaths, songScores, contents.basePolicy)) {
+            return false;
+        }
+        container->build(songScores.getSongs());
+    }
+    for (unsigned int i = 0; i < contents.changes.size(); i++) {
+        applyLogChange(container, contents.changes.at(i));
+    }
+    return true;
+}
+
+
+// WriteAheadLog:
+// ==============
+
+/**
+ * Constructor. The log is closed until open() is called.
+ */
+WriteAheadLog::WriteAheadLog() : file(nullptr), syncMode(WalSyncMode::DATA), commitIntervalMilliseconds(0), compactionBytes(0),
+                                 snapshotGeneration(0), hasRecords(false), appendedBytes(0), writtenBytes(0),
+                                 appendedRecords(0), writtenRecords(0), commitNotifyFd(-1), flushWaiters(0), stopping(false) {}
+
+
+/**
+ * Destructor. Writes every pending record first.
+ */
+WriteAheadLog::~WriteAheadLog() {
+    close();
+}
+
+
+/**
+ * Opens a log to add records to, creating it if it does not exist. A record cut off at the end by a crash is removed,
+ * so the new records follow the last complete one.
+ * @param filepath The path to the log.
+ * @param syncMode How far each batch is pushed before it counts as written.
+ * @param commitIntervalMilliseconds How long a batch waits for more records after its first one.
+ * @param compactionBytes The size at which needsCompaction() starts returning true.
+ * @return true if the log is open, false otherwise (see getError()).
+ */
+bool WriteAheadLog::open(const string& filepath, WalSyncMode syncMode, int commitIntervalMilliseconds,
+                         uint64_t compactionBytes) {
+    close();
+    this->filepath = filepath;
+    this->syncMode = syncMode;
+    this->commitIntervalMilliseconds = commitIntervalMilliseconds;
+    this->compactionBytes = compactionBytes;
+    error.clear();
+
+    LogContents contents;
+    if (!readLog(filepath, contents)) {
+        error = filepath + " is not a log this program can read";
+        return false;
+    }
+    if (contents.fileBytes > contents.validBytes) {
+        error_code resizeError;
+        filesystem::resize_file(filepath, contents.validBytes, resizeError);
+        if (resizeError) {
+            error = "could not remove the damaged end of " + filepath;
+            return false;
+        }
+    }
+
+    file = fopen(filepath.c_str(), contents.validBytes == 0 ? "wb" : "ab");
+    if (file == nullptr) {
+        error = "could not open " + filepath;
+        return false;
+    }
+    setvbuf(file, nullptr, _IONBF, 0); // Each batch is already one buffer, so it goes straight to one write call.
+    if (contents.validBytes == 0 && !startFile()) {
+        fclose(file);
+        file = nullptr;
+        error = "could not write to " + filepath;
+        return false;
+    }
+
+    // A log based on one of its own snapshots carries on numbering them from there:
+    snapshotGeneration = 0;
+    if (contents.hasBase && contents.baseFilepaths.size() == 1) {
+        snapshotGeneration = parseSnapshotGeneration(contents.baseFilepaths.at(0), filepath + ".snap.");
+    }
+
+    hasRecords = contents.hasBase || !contents.changes.empty();
+    appendedBytes = contents.validBytes == 0 ? HEADER_BYTES : contents.validBytes;
+    writtenBytes = appendedBytes;
+    pending.clear();
+    stopping = false;
+    committer = thread(&WriteAheadLog::commitBatches, this);
+    return true;
+}
+
+
+/**
+ * Writes the header of a new log and syncs it.
+ * @return true if the header was written, false otherwise.
+ */
+bool WriteAheadLog::startFile() {
+    unsigned char header[HEADER_BYTES];
+    memcpy(header, LOG_MAGIC, sizeof(LOG_MAGIC));
+    storeLittleEndian(header + 8, LOG_VERSION, 4);
+    return fwrite(header, 1, HEADER_BYTES, file) == HEADER_BYTES && fflush(file) == 0 && syncFile(file, syncMode);
+}
+
+
+/**
+ * Gets the path of one of the snapshots compact() writes next to the log.
+ * @param generation The snapshot's number. Each compaction writes the next one.
+ * @return The path.
+ */
+string WriteAheadLog::snapshotPath(int generation) const {
+    return filepath + ".snap." + to_string(generation);
+}
+
+
+/**
+ * Records the files the container was first loaded from. Must be the first record in the log.
+ * @param filepaths The paths to the SQLite database or snapshot files.
+ * @param policy How the scores of a track found in more than one file were combined.
+ * @return true if the base was recorded, false if the log is closed or already has records.
+ */
+bool WriteAheadLog::logBase(const vector<string>& filepaths, MergePolicy policy) {
+    vector<unsigned char> body(5);
+    body[0] = static_cast<unsigned char>(policy);
+    storeLittleEndian(body.data() + 1, filepaths.size(), 4);
+    for (unsigned int i = 0; i < filepaths.size(); i++) {
+        unsigned char length[4];
+        storeLittleEndian(length, filepaths.at(i).size(), 4);
+        body.insert(body.end(), length, length + 4);
+        body.insert(body.end(), filepaths.at(i).begin(), filepaths.at(i).end());
+    }
+
+    lock_guard<mutex> lock(bufferMutex);
+    if (file == nullptr || hasRecords) {
+        return false;
+    }
+    appendRecord(LOG_BASE, body.data(), body.size(), nullptr, 0);
+    return true;
+}
+
+
+/**
+ * Records a song being inserted. Only copies the record into memory; it is written with the next batch.
+ * @param song The song.
+ * @return The record's position: it is written once getWrittenRecords() reaches it. 0 if the log is closed.
+ */
+uint64_t WriteAheadLog::logInsert(const Song& song) {
+    unsigned char scoreBytes[4];
+    storeLittleEndian(scoreBytes, static_cast<uint32_t>(song.getScore()), 4);
+    lock_guard<mutex> lock(bufferMutex);
+    if (file == nullptr) {
+        return 0;
+    }
+    appendRecord(LOG_INSERT, scoreBytes, 4, song.getName().data(), song.getName().size());
+    return appendedRecords;
+}
+
+
+/**
+ * Records a song being removed, by its score and track ID, so that replaying it removes exactly this song even when
+ * the container holds the same track ID with other scores. Only copies the record into memory; it is written with the
+ * next batch.
+ * @param song The song that was removed.
+ * @return The record's position: it is written once getWrittenRecords() reaches it. 0 if the log is closed.
+ */
+uint64_t WriteAheadLog::logRemove(const Song& song) {
+    unsigned char scoreBytes[4];
+    storeLittleEndian(scoreBytes, static_cast<uint32_t>(song.getScore()), 4);
+    lock_guard<mutex> lock(bufferMutex);
+    if (file == nullptr) {
+        return 0;
+    }
+    appendRecord(LOG_REMOVE, scoreBytes, 4, song.getName().data(), song.getName().size());
+    return appendedRecords;
+}
+
+
+/**
+ * Gets how many of the records appended so far have been written (and synced, depending on the WalSyncMode). A record
+ * is written once this reaches the position logInsert() or logRemove() returned for it. A failed write counts as
+ * written too, so check getError() as well.
+ * @return The number of records written.
+ */
+uint64_t WriteAheadLog::getWrittenRecords() {
+    lock_guard<mutex> lock(bufferMutex);
+    return writtenRecords;
+}
+
+
+/**
+ * Sets an eventfd for the committer to add 1 to after each batch is written, so a thread that cannot block in flush()
+ * (such as one running coroutines, see AsyncExecutor.h) can wait for its records by watching the descriptor instead.
+ * @param fd The eventfd, or -1 to stop. The log does not close it, so set -1 before closing it.
+ */
+void WriteAheadLog::setCommitNotifier(int fd) {
+    lock_guard<mutex> lock(bufferMutex);
+    commitNotifyFd = fd;
+}
+
+
+/**
+ * Adds a record to the pending batch, waking the committer if the batch was empty or has grown big enough to write.
+ * bufferMutex must be held.
+ * @param type The record's type.
+ * @param head The first part of the record's body.
+ * @param headLength The length of head.
+ * @param tail The rest of the record's body.
+ * @param tailLength The length of tail.
+ */
+void WriteAheadLog::appendRecord(LogRecordType type, const unsigned char* head, size_t headLength, const char* tail,
+                                 size_t tailLength) {
+    size_t start = pending.size();
+    encodeRecord(pending, type, head, headLength, tail, tailLength);
+    appendedBytes += pending.size() - start;
+    appendedRecords++;
+    hasRecords = true;
+    if (start == 0 || pending.size() >= MAX_BATCH_BYTES) {
+        bufferChanged.notify_one();
+    }
+}
+
+
+/**
+ * Run by the committer thread: writes the pending records a batch at a time until the log is closed.
+ */
+void WriteAheadLog::commitBatches() {
+    unique_lock<mutex> lock(bufferMutex);
+    while (true) {
+        bufferChanged.wait(lock, [this]() { return stopping || !pending.empty(); });
+        if (pending.empty()) {
+            return; // Stopping, and everything has been written.
+        }
+
+        // Let other records join the batch for a while, unless it is already big or someone is waiting for it:
+        if (!stopping && flushWaiters == 0 && pending.size() < MAX_BATCH_BYTES) {
+            bufferChanged.wait_for(lock, chrono::milliseconds(commitIntervalMilliseconds), [this]() {
+                return stopping || flushWaiters > 0 || pending.size() >= MAX_BATCH_BYTES;
+            });
+        }
+
+        writing.swap(pending); // pending keeps the old batch's capacity, so appending rarely allocates.
+        uint64_t batchEnd = appendedBytes;
+        uint64_t batchRecords = appendedRecords;
+        bool failedBefore = !error.empty();
+        FILE* target = file;
+        lock.unlock();
+
+        // Once a batch has failed, later ones are dropped too, so the log never has a gap in the middle:
+        bool written = !failedBefore && fwrite(writing.data(), 1, writing.size(), target) == writing.size()
+                       && fflush(target) == 0 && syncFile(target, syncMode);
+        writing.clear();
+
+        lock.lock();
+        if (!written && error.empty()) {
+            error = "could not write to " + filepath;
+        }
+        writtenBytes = batchEnd;
+        writtenRecords = batchRecords;
+        batchWritten.notify_all();
+#ifdef __linux__
+        if (commitNotifyFd != -1) {
+            uint64_t one = 1;
+            ssize_t notified = ::write(commitNotifyFd, &one, sizeof(one));
+            (void) notified; // Only fails if the counter is already nonzero, which wakes the watcher just the same.
+        }
+#endif
+    }
+}
+
+
+/**
+ * Writes every record appended so far, without waiting for the commit interval, and waits until it is done.
+ * @return true if every record was written, false if the log is closed or a write failed.
+ */
+bool WriteAheadLog::flush() {
+    unique_lock<mutex> lock(bufferMutex);
+    if (file == nullptr) {
+        return false;
+    }
+    uint64_t target = appendedBytes;
+    flushWaiters++;
+    bufferChanged.notify_one();
+    batchWritten.wait(lock, [this, target]() { return writtenBytes >= target; });
+    flushWaiters--;
+    return error.empty();
+}
+
+
+/**
+ * Checks whether the log has grown past its compaction size.
+ * @return true if compact() should be called.
+ */
+bool WriteAheadLog::needsCompaction() {
+    lock_guard<mutex> lock(bufferMutex);
+    return file != nullptr && appendedBytes >= compactionBytes;
+}
+
+
+/**
+ * Replaces the log with a snapshot of the container and a new log based on it. The snapshot is written next to the
+ * log, and the previous one is deleted once the new log is in place. Songs a snapshot cannot hold (a track ID that is
+ * not TrackScoreMap::KEY_LENGTH long, or a second song with the same ID) are kept as inserts in the new log.
+ * Nothing may change the container or append to the log while this runs.
+ * @param container The container whose changes the log holds.
+ * @return true if the log was compacted, false if it was left as it was (see getError()).
+ */
+bool WriteAheadLog::compact(SongContainer* container) {
+    if (!flush()) {
+        return false;
+    }
+    vector<Song> songs = container->toVector();
+    int generation = snapshotGeneration + 1;
+    string newSnapshotPath = snapshotPath(generation);
+    string newLogPath = filepath + ".tmp";
+
+    SnapshotWriter writer;
+    vector<Song> extraSongs;
+    bool success = writer.open(newSnapshotPath.c_str());
+    unordered_set<string> snapshotIds;
+    for (unsigned int i = 0; i < songs.size() && success; i++) {
+        const string& name = songs.at(i).getName();
+        if (static_cast<int>(name.size()) == TrackScoreMap::KEY_LENGTH && snapshotIds.insert(name).second) {
+            success = writer.write(songs.at(i));
+        }
+        else {
+            extraSongs.push_back(songs.at(i));
+        }
+    }
+    success = writer.close() && success;
+    success = success && (syncMode == WalSyncMode::NONE || syncPath(newSnapshotPath));
+
+    // The new log is written in full under another name, then renamed over the old one:
+    vector<unsigned char> bytes(HEADER_BYTES);
+    memcpy(bytes.data(), LOG_MAGIC, sizeof(LOG_MAGIC));
+    storeLittleEndian(bytes.data() + 8, LOG_VERSION, 4);
+    vector<unsigned char> baseBody(5);
+    baseBody[0] = static_cast<unsigned char>(MergePolicy::SUM);
+    storeLittleEndian(baseBody.data() + 1, 1, 4);
+    unsigned char length[4];
+    storeLittleEndian(length, newSnapshotPath.size(), 4);
+    baseBody.insert(baseBody.end(), length, length + 4);
+    baseBody.insert(baseBody.end(), newSnapshotPath.begin(), newSnapshotPath.end());
+    encodeRecord(bytes, LOG_BASE, baseBody.data(), baseBody.size(), nullptr, 0);
+    for (unsigned int i = 0; i < extraSongs.size(); i++) {
+        unsigned char scoreBytes[4];
+        storeLittleEndian(scoreBytes, static_cast<uint32_t>(extraSongs.at(i).getScore()), 4);
+        const string& name = extraSongs.at(i).getName();
+        encodeRecord(bytes, LOG_INSERT, scoreBytes, 4, name.data(), name.size());
+    }
+
+    FILE* newFile = success ? fopen(newLogPath.c_str(), "wb") : nullptr;
+    if (newFile != nullptr) {
+        success = fwrite(bytes.data(), 1, bytes.size(), newFile) == bytes.size() && fflush(newFile) == 0
+                  && syncFile(newFile, syncMode);
+        success = fclose(newFile) == 0 && success;
+        error_code renameError;
+        if (success) {
+            filesystem::rename(newLogPath, filepath, renameError);
+        }
+        success = success && !renameError && (syncMode == WalSyncMode::NONE || syncPath(directoryOf(filepath)));
+    }
+    if (newFile == nullptr || !success) {
+        remove(newLogPath.c_str());
+        remove(newSnapshotPath.c_str());
+        lock_guard<mutex> lock(bufferMutex);
+        error = "could not compact " + filepath;
+        return false;
+    }
+
+    // Switch to the new log. The committer is idle, since everything was flushed and nothing has been appended since:
+    lock_guard<mutex> lock(bufferMutex);
+    fclose(file);
+    file = fopen(filepath.c_str(), "ab");
+    if (file == nullptr) {
+        error = "could not reopen " + filepath; // Nothing more is logged. close() still stops the committer.
+        return false;
+    }
+    setvbuf(file, nullptr, _IONBF, 0);
+    if (snapshotGeneration > 0) {
+        remove(snapshotPath(snapshotGeneration).c_str());
+    }
+    snapshotGeneration = generation;
+    appendedBytes = bytes.size();
+    writtenBytes = appendedBytes;
+    hasRecords = true;
+    return true;
+}
+
+
+/**
+ * Writes every pending record and closes the log. Also stops the committer of a log that compact() could not reopen,
+ * which has no file but still has its thread.
+ */
+void WriteAheadLog::close() {
+    {
+        lock_guard<mutex> lock(bufferMutex);
+        if (!committer.joinable()) {
+            return;
+        }
+        stopping = true;
+        bufferChanged.notify_one();
+    }
+    committer.join();
+    if (file != nullptr) {
+        fclose(file);
+        file = nullptr;
+    }
+}
+
+
+bool WriteAheadLog::isOpen() const {
+    return file != nullptr;
+}
+
+
+/**
+ * Gets what went wrong with the log, if anything did.
+ * @return A description of the error, or "" if there has been none.
+ */
+string WriteAheadLog::getError() {
+    lock_guard<mutex> lock(bufferMutex);
+    return error;
+}
@@ -0,0 +1,153 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_WRITEAHEADLOG_H
+#define COP3530_PROJECT_3_WRITEAHEADLOG_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Song.h"
+#include "SongContainer.h"
+#include "TrackScoreMap.h"
+
+using namespace std;
+
+/**
+ * How far each batch of log records is pushed before it counts as written.
+ */
+enum class WalSyncMode {
+    NONE, // Handed to the operating system, which writes it to disk in its own time. Survives the program crashing.
+    DATA, // Also flushed to disk with fdatasync, so it survives the machine losing power.
+    FULL // Also flushed to disk with fsync, which flushes the file's metadata (e.g. its modification time) too.
+};
+
+bool parseWalSyncMode(const string& name, WalSyncMode& mode);
+
+/**
+ * The kinds of record in a log. Stored in the file, so the values must not change.
+ */
+enum LogRecordType {
+    LOG_BASE = 1, // The files the container was first loaded from. Only ever the first record.
+    LOG_INSERT = 2,
+    LOG_REMOVE = 3
+};
+
+/**
+ * One insert or remove read back from a log.
+ */
+struct LogChange {
+    LogRecordType type; // LOG_INSERT or LOG_REMOVE.
+    Song song; // The song inserted or removed.
+};
+
+/**
+ * Everything read back from a log: the files to load, then the changes to make on top of them, in order.
+ */
+struct LogContents {
+    bool hasBase; // Whether the log names files to load. If not, the changes start from an empty container.
+    vector<string> baseFilepaths;
+    MergePolicy basePolicy;
+    vector<LogChange> changes;
+    uint64_t validBytes; // Length of the log up to the end of its last complete record.
+    uint64_t fileBytes; // Length of the whole file. More than validBytes if a write was cut off part way.
+
+    LogContents(); // ctr
+};
+
+/**
+ * An append-only log of the changes made to a container, so they can be made again after a restart.
+ *
+ * Layout (all integers little-endian):
+ *   8 bytes   magic "LPSYWLOG"
+ *   uint32    format version (currently 2)
+ *   records   each one a uint32 payload length, a uint32 FNV-1a checksum of the payload, then the payload:
+ *             LOG_BASE    uint8 type, uint8 MergePolicy, uint32 file count, then a uint32 length and the bytes of each path
+ *             LOG_INSERT  uint8 type, int32 score, then the track ID's bytes
+ *             LOG_REMOVE  uint8 type, int32 score, then the track ID's bytes
+ * Reading stops at the first record that is cut off or does not match its checksum, which is where a crash stopped a
+ * write.
+ *
+ * Appending a record only copies it into a buffer. A committer thread writes the buffer out a batch at a time (group
+ * commit), waiting up to the commit interval after the first record of a batch for others to join it, so a burst of
+ * changes costs one write (and one sync, depending on the WalSyncMode) rather than one per change. A crash loses at
+ * most the records appended in the last commit interval. flush() waits until every record appended so far is written.
+ * A caller that cannot block can instead keep the position logInsert() or logRemove() returns, and compare it with
+ * getWrittenRecords() whenever the eventfd given to setCommitNotifier() is signalled after a batch.
+ *
+ * Once the log passes its compaction size, compact() writes the container's songs to a snapshot file next to the log
+ * and starts a new log based on that snapshot. Files are only ever replaced by renaming a complete new file over them,
+ * so a crash during compaction leaves either the old log or the new one.
+ *
+ * Any number of threads can append at once.
+ */
+class WriteAheadLog {
+public:
+    static const int DEFAULT_COMMIT_INTERVAL_MILLISECONDS = 5;
+    static const uint64_t DEFAULT_COMPACTION_BYTES = 64ULL * 1024 * 1024;
+
+private:
+    static const size_t MAX_BATCH_BYTES = 1024 * 1024; // Written straight away, without waiting for the interval.
+
+    string filepath;
+    FILE* file; // The open log, or nullptr.
+    WalSyncMode syncMode;
+    int commitIntervalMilliseconds;
+    uint64_t compactionBytes;
+    int snapshotGeneration; // Number of the snapshot the log is based on (see snapshotPath). 0 if it is not one of ours.
+    bool hasRecords; // Whether the log has any record, so a base can no longer be added.
+
+    mutex bufferMutex;
+    condition_variable bufferChanged; // Signalled when the committer has work, or should stop.
+    condition_variable batchWritten; // Signalled after each batch is written.
+    vector<unsigned char> pending; // Records appended but not written yet.
+    vector<unsigned char> writing; // The batch being written. Only used by the committer.
+    uint64_t appendedBytes; // Bytes of the log, including the records still pending.
+    uint64_t writtenBytes; // Bytes of the log that have been written.
+    uint64_t appendedRecords; // Records appended through this object. Unlike the bytes, never reset by compact().
+    uint64_t writtenRecords; // How many of those have been written.
+    int commitNotifyFd; // An eventfd written after each batch, or -1.
+    int flushWaiters; // Threads waiting in flush(), which want their records written without waiting for the interval.
+    bool stopping;
+    string error; // Set if a write failed. No more records are written after that.
+    thread committer;
+
+    void commitBatches();
+    void appendRecord(LogRecordType type, const unsigned char* head, size_t headLength, const char* tail,
+                      size_t tailLength);
+    bool startFile();
+    string snapshotPath(int generation) const;
+
+public:
+    WriteAheadLog(); // ctr
+    ~WriteAheadLog(); // dtr
+
+    bool open(const string& filepath, WalSyncMode syncMode,
+              int commitIntervalMilliseconds = DEFAULT_COMMIT_INTERVAL_MILLISECONDS,
+              uint64_t compactionBytes = DEFAULT_COMPACTION_BYTES);
+    bool logBase(const vector<string>& filepaths, MergePolicy policy);
+    uint64_t logInsert(const Song& song);
+    uint64_t logRemove(const Song& song);
+    uint64_t getWrittenRecords();
+    void setCommitNotifier(int fd);
+    bool flush();
+    bool needsCompaction();
+    bool compact(SongContainer* container);
+    void close();
+    bool isOpen() const;
+    string getError();
+};
+
+// Log functions. See the .cpp implementation file:
+bool readLog(const string& filepath, LogContents& contents);
+void applyLogChange(SongContainer* container, const LogChange& change);
+bool restoreFromLog(const string& filepath, SongContainer* container, LogContents& contents);
+
+
+#endif //COP3530_PROJECT_3_WRITEAHEADLOG_H
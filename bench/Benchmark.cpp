@@ -0,0 +1,614 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include "AllocationTracker.h"
+#include "ContainerOperations.h"
+#include "LatencyHistogram.h"
+#include "PerfCounters.h"
+#include "Workload.h"
+
+using namespace std;
+
+/**
+ * Latencies, hardware counts and allocations of the operations run by one thread, per operation type and overall.
+ */
+struct OperationResults {
+    LatencyHistogram latencies[OPERATION_TYPE_COUNT];
+    LatencyHistogram allLatencies;
+    PerfTotals counters[OPERATION_TYPE_COUNT];
+    PerfTotals allCounters;
+    AllocationTotals allocations[OPERATION_TYPE_COUNT];
+    AllocationTotals allAllocations;
+    LatencyHistogram rankErrors; // For each extractMax, the number of songs left in the container that scored higher.
+};
+
+/**
+ * How many songs with each score should be in the container, kept up to date next to it while a workload runs so
+ * that the rank of every extracted song can be worked out. The counts are kept in a Fenwick tree, so counting the
+ * songs that outrank a score takes a few steps even with a large score range.
+ */
+struct ScoreShadow {
+    mutex lock; // Shared by every thread running operations.
+    vector<long long> tree; // Fenwick tree of the counts, indexed by score + 1.
+    long long total;
+
+    ScoreShadow(const vector<Song>& songs, int maxScore); // ctr
+    void add(int score, long long count);
+    long long countAbove(int score) const;
+};
+
+// Prototypes:
+// ===========
+vector<WorkloadSpec> presetWorkloads();
+bool parseMix(const string& text, int mix[OPERATION_TYPE_COUNT]);
+vector<string> splitList(const string& text);
+bool runWorkload(const string& containerKind, const WorkloadSpec& spec, PerfCounters* perf, const vector<string>& allocationFree,
+                 bool measureRankError);
+void runOperations(SongContainer* container, const vector<Operation>* operations, unsigned int first, unsigned int step,
+                   PerfCounters* perf, ScoreShadow* shadow, OperationResults* results);
+void printLatencyRow(const string& containerKind, const WorkloadSpec& spec, const string& operation,
+                     const LatencyHistogram& latencies, double seconds, const PerfTotals* counters,
+                     const AllocationTotals* allocations, const LatencyHistogram* rankErrors);
+void printUsage(const char* programName);
+
+
+// Implementations:
+// ================
+
+/**
+ * Entry point for the benchmark program. Runs every selected workload against every selected container and prints
+ * one tab separated line per operation type with its throughput and latency percentiles.
+ * With --perf, each line also has the average hardware counts per operation ("NA" for events that cannot be counted).
+ * In builds that count allocations (make bench ALLOCS=1), each line also has the average allocations and bytes per
+ * operation, and a "generate" line shows what creating the workload itself allocated.
+ * With --threads, thread safe containers run the operations on that many threads at once (see runWorkload).
+ * With --rank-error, each line also has the mean, 99th percentile and largest rank error of the extractMax operations
+ * ("NA" on other lines): how many songs in the container scored higher than the one that was extracted. Exact
+ * containers always show 0, relaxed ones such as the multiqueue show how far from exact they are.
+ * @return 0 if the benchmarks ran, 1 if the arguments were invalid or an operation listed in --alloc-free allocated.
+ */
+int main(int argc, char* argv[]) {
+    vector<string> containers = containerKinds();
+    vector<KeyDistribution> distributions;
+    distributions.push_back(KeyDistribution::UNIFORM);
+    distributions.push_back(KeyDistribution::ZIPFIAN);
+    distributions.push_back(KeyDistribution::SEQUENTIAL);
+    vector<WorkloadSpec> workloads = presetWorkloads();
+    WorkloadSpec overrides; // Holds the values given on the command line. Applied to every workload below.
+    bool customMix = false;
+    bool songsGiven = false, opsGiven = false, scoreGiven = false, seedGiven = false, widthGiven = false;
+    bool countEvents = false;
+    bool measureRankError = false;
+    vector<string> allocationFree; // Operations that must not allocate, from --alloc-free.
+
+    // Parse the command line arguments:
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--perf") {
+            countEvents = true;
+            continue;
+        }
+        if (arg == "--rank-error") {
+            measureRankError = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        string value = argv[++i];
+
+        if (arg == "--containers") {
+            containers = splitList(value);
+        }
+        else if (arg == "--dist") {
+            distributions.clear();
+            vector<string> names = splitList(value);
+            for (unsigned int j = 0; j < names.size(); j++) {
+                KeyDistribution distribution;
+                if (!parseKeyDistribution(names.at(j), distribution)) {
+                    printUsage(argv[0]);
+                    return 1;
+                }
+                distributions.push_back(distribution);
+            }
+        }
+        else if (arg == "--mix" && parseMix(value, overrides.mix)) {
+            customMix = true;
+        }
+        else if (arg == "--songs") {
+            overrides.initialSongs = stoi(value);
+            songsGiven = true;
+        }
+        else if (arg == "--ops") {
+            overrides.operationCount = stoi(value);
+            opsGiven = true;
+        }
+        else if (arg == "--max-score") {
+            overrides.maxScore = stoi(value);
+            scoreGiven = true;
+        }
+        else if (arg == "--range-width") {
+            overrides.rangeWidth = stoi(value);
+            widthGiven = true;
+        }
+        else if (arg == "--seed") {
+            overrides.seed = static_cast<unsigned int>(stoul(value));
+            seedGiven = true;
+        }
+        else if (arg == "--threads") {
+            overrides.threads = stoi(value);
+            if (overrides.threads < 1) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        else if (arg == "--alloc-free") {
+            allocationFree = splitList(value);
+        }
+        else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    // A custom mix replaces the presets:
+    if (customMix) {
+        overrides.name = "custom";
+        workloads.assign(1, overrides);
+    }
+
+    // Check the container names before spending any time generating workloads:
+    for (unsigned int i = 0; i < containers.size(); i++) {
+        SongContainer* container = createContainer(containers.at(i));
+        if (container == nullptr) {
+            cerr << "Unknown container: " << containers.at(i) << endl;
+            return 1;
+        }
+        delete container;
+    }
+
+    // Counters that cannot be opened (e.g. in a container) leave their columns as NA:
+    PerfCounters perf;
+    if (countEvents && !perf.open()) {
+        cerr << "Hardware counters are not available (" << perf.getError() << "). Their columns will be NA." << endl;
+    }
+
+    if (!allocationFree.empty() && !allocationTrackingEnabled()) {
+        cerr << "--alloc-free needs a build that counts allocations (make bench ALLOCS=1)." << endl;
+        return 1;
+    }
+
+    cout << "container\tworkload\tdistribution\t" << (overrides.threads > 0 ? "threads\t" : "") << "operation\tcount\tops_per_s\tp50_ns\tp90_ns\tp99_ns\tp999_ns\tmax_ns";
+    if (countEvents) {
+        for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+            cout << '\t' << PerfCounters::eventName(static_cast<PerfEvent>(e));
+        }
+        cout << "\tipc";
+    }
+    if (allocationTrackingEnabled()) {
+        cout << "\tallocs_per_op\tbytes_per_op";
+    }
+    if (measureRankError) {
+        cout << "\trank_err_mean\trank_err_p99\trank_err_max";
+    }
+    cout << endl;
+    bool allocationFreeHeld = true;
+    for (unsigned int w = 0; w < workloads.size(); w++) {
+        for (unsigned int d = 0; d < distributions.size(); d++) {
+            WorkloadSpec spec = workloads.at(w);
+            spec.distribution = distributions.at(d);
+            if (songsGiven) spec.initialSongs = overrides.initialSongs;
+            if (opsGiven) spec.operationCount = overrides.operationCount;
+            if (scoreGiven) spec.maxScore = overrides.maxScore;
+            if (widthGiven) spec.rangeWidth = overrides.rangeWidth;
+            if (seedGiven) spec.seed = overrides.seed;
+            spec.threads = overrides.threads;
+
+            for (unsigned int c = 0; c < containers.size(); c++) {
+                if (!runWorkload(containers.at(c), spec, countEvents ? &perf : nullptr, allocationFree, measureRankError)) {
+                    allocationFreeHeld = false;
+                }
+            }
+        }
+    }
+    return allocationFreeHeld ? 0 : 1;
+}
+
+
+/**
+ * Gets the workloads that are run when no custom mix is given.
+ * @return The preset workloads.
+ */
+vector<WorkloadSpec> presetWorkloads() {
+    vector<WorkloadSpec> workloads;
+
+    // Weights are in the order insert, remove, search, range, extractMax:
+    const char* names[] = {"read-heavy", "write-heavy", "mixed", "drain"};
+    const int mixes[][OPERATION_TYPE_COUNT] = {
+        {5, 5, 80, 5, 5},
+        {45, 45, 5, 0, 5},
+        {20, 20, 40, 10, 10},
+        {0, 0, 0, 0, 100}
+    };
+
+    for (int i = 0; i < 4; i++) {
+        WorkloadSpec spec;
+        spec.name = names[i];
+        for (int j = 0; j < OPERATION_TYPE_COUNT; j++) {
+            spec.mix[j] = mixes[i][j];
+        }
+        workloads.push_back(spec);
+    }
+    return workloads;
+}
+
+
+/**
+ * Parses an operation mix given as insert:remove:search:range:extractMax weights, e.g. 20:20:40:10:10.
+ * @param text The mix as typed by the user.
+ * @param mix Populated with the weights.
+ * @return true if the mix was valid, false otherwise.
+ */
+bool parseMix(const string& text, int mix[OPERATION_TYPE_COUNT]) {
+    istringstream stream(text);
+    int total = 0;
+    for (int i = 0; i < OPERATION_TYPE_COUNT; i++) {
+        char separator = ':';
+        if ((i > 0 && !(stream >> separator)) || separator != ':' || !(stream >> mix[i]) || mix[i] < 0) {
+            return false;
+        }
+        total += mix[i];
+    }
+    return total > 0 && stream.eof();
+}
+
+
+/**
+ * Splits a comma separated list.
+ * @param text The list.
+ * @return The items of the list.
+ */
+vector<string> splitList(const string& text) {
+    vector<string> items;
+    istringstream stream(text);
+    string item;
+    while (getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+
+/**
+ * Builds a container with the workload's initial songs, runs its operations and prints the results.
+ * @param containerKind The name of the container to benchmark.
+ * @param spec The workload to run.
+ * @param perf Hardware counters to read around each operation, or nullptr to only time them.
+ * @param allocationFree Names of operations that must not allocate (see operationName()).
+ * @param measureRankError Whether to work out the rank of every extracted song (see ScoreShadow).
+ * @return false if an operation in allocationFree allocated, true otherwise.
+ */
+bool runWorkload(const string& containerKind, const WorkloadSpec& spec, PerfCounters* perf, const vector<string>& allocationFree,
+                 bool measureRankError) {
+    bool countAllocations = allocationTrackingEnabled();
+    LatencyHistogram noRankErrors; // Shown as NA on the lines other than extractMax.
+    const LatencyHistogram* rankErrorColumn = measureRankError ? &noRankErrors : nullptr;
+
+    // Generate everything before any timing starts:
+    LatencyHistogram generateLatency;
+    AllocationTotals generateAllocations;
+    AllocationCounts allocationsBefore = threadAllocationCounts();
+    chrono::steady_clock::time_point generateStart = chrono::steady_clock::now();
+    WorkloadGenerator generator(spec);
+    vector<Song> songs = generator.generateSongs();
+    vector<Operation> operations = generator.generateOperations(songs);
+    chrono::steady_clock::time_point generateEnd = chrono::steady_clock::now();
+    generateAllocations.add(threadAllocationCounts() - allocationsBefore);
+    if (countAllocations) {
+        PerfTotals generateCounters; // Not counted, so the columns line up with NA.
+        generateLatency.record(chrono::duration_cast<chrono::nanoseconds>(generateEnd - generateStart).count());
+        printLatencyRow(containerKind, spec, "generate", generateLatency, generateLatency.max() / 1e9,
+                        perf != nullptr ? &generateCounters : nullptr, &generateAllocations, rankErrorColumn);
+    }
+
+    SongContainer* container = createContainer(containerKind);
+
+    // Thread safe containers can have their operations split across several threads (see below):
+    unsigned int threadCount = spec.threads > 1 && container->isThreadSafe() ? spec.threads : 1;
+    if (spec.threads > 1 && threadCount == 1) {
+        cerr << containerKind << " is not thread safe, so its operations run on one thread." << endl;
+    }
+    WorkloadSpec runSpec = spec; // Shows the number of threads that actually ran the operations.
+    if (spec.threads > 0) {
+        runSpec.threads = threadCount;
+    }
+
+    // Counters are read outside the timed region, so they add nothing to the latencies:
+    PerfSample sample;
+    PerfTotals buildCounters;
+    AllocationTotals buildAllocations;
+
+    // Time the build on its own:
+    LatencyHistogram buildLatency;
+    allocationsBefore = threadAllocationCounts();
+    if (perf != nullptr) perf->start();
+    chrono::steady_clock::time_point buildStart = chrono::steady_clock::now();
+    container->build(songs);
+    chrono::steady_clock::time_point buildEnd = chrono::steady_clock::now();
+    if (perf != nullptr) perf->stop(sample);
+    buildAllocations.add(threadAllocationCounts() - allocationsBefore);
+    buildCounters.add(sample);
+    buildLatency.record(chrono::duration_cast<chrono::nanoseconds>(buildEnd - buildStart).count());
+    printLatencyRow(containerKind, runSpec, "build", buildLatency, buildLatency.max() / 1e9, perf != nullptr ? &buildCounters : nullptr,
+                    countAllocations ? &buildAllocations : nullptr, rankErrorColumn);
+
+    // Run the operations, timing each one separately. With several threads, each takes every n-th operation.
+    // Counters only count the thread that opened them, so they are left out then.
+    // The shadow is updated after each operation, outside the timed region. With several threads, an operation can
+    // finish before the shadow has seen another thread's earlier one, so rank errors are then only close to exact:
+    OperationResults results;
+    ScoreShadow* shadow = measureRankError ? new ScoreShadow(songs, spec.maxScore) : nullptr;
+
+    chrono::steady_clock::time_point runStart = chrono::steady_clock::now();
+    if (threadCount == 1) {
+        runOperations(container, &operations, 0, 1, perf, shadow, &results);
+    }
+    else {
+        perf = nullptr;
+        vector<OperationResults> threadResults(threadCount);
+        vector<thread> workers;
+        for (unsigned int t = 0; t < threadCount; t++) {
+            workers.push_back(thread(runOperations, container, &operations, t, threadCount, nullptr, shadow, &threadResults.at(t)));
+        }
+        for (unsigned int t = 0; t < threadCount; t++) {
+            workers.at(t).join();
+        }
+
+        // Combine the results of every thread:
+        for (unsigned int t = 0; t < threadCount; t++) {
+            for (int type = 0; type < OPERATION_TYPE_COUNT; type++) {
+                results.latencies[type].merge(threadResults.at(t).latencies[type]);
+                results.allocations[type].merge(threadResults.at(t).allocations[type]);
+            }
+            results.allLatencies.merge(threadResults.at(t).allLatencies);
+            results.allAllocations.merge(threadResults.at(t).allAllocations);
+            results.rankErrors.merge(threadResults.at(t).rankErrors);
+        }
+    }
+    double runSeconds = chrono::duration<double>(chrono::steady_clock::now() - runStart).count(); // Includes any counter reads.
+
+    // Throughput per operation type uses only the time spent on that type (summed over every thread).
+    // The "all" line uses the wall clock time of the whole run, so with several threads it shows the combined throughput:
+    LatencyHistogram* latencies = results.latencies;
+    AllocationTotals* allocations = results.allocations;
+    bool allocationFreeHeld = true;
+    for (int type = 0; type < OPERATION_TYPE_COUNT; type++) {
+        if (latencies[type].count() > 0) {
+            string name = operationName(static_cast<OperationType>(type));
+            double seconds = latencies[type].mean() * latencies[type].count() / 1e9;
+            printLatencyRow(containerKind, runSpec, name, latencies[type], seconds, perf != nullptr ? &results.counters[type] : nullptr,
+                            countAllocations ? &allocations[type] : nullptr,
+                            measureRankError && type == OP_EXTRACT_MAX ? &results.rankErrors : rankErrorColumn);
+
+            // Report any operation that was meant to be allocation free but was not:
+            for (unsigned int j = 0; j < allocationFree.size(); j++) {
+                if (allocationFree.at(j) == name && allocations[type].getAllocatingOperations() > 0) {
+                    cerr << containerKind << ' ' << spec.name << ' ' << distributionName(spec.distribution) << ": " << name
+                         << " allocated in " << allocations[type].getAllocatingOperations() << " of "
+                         << allocations[type].getOperations() << " operations." << endl;
+                    allocationFreeHeld = false;
+                }
+            }
+        }
+    }
+    printLatencyRow(containerKind, runSpec, "all", results.allLatencies, runSeconds, perf != nullptr ? &results.allCounters : nullptr,
+                    countAllocations ? &results.allAllocations : nullptr, rankErrorColumn);
+
+    delete shadow;
+    delete container;
+    return allocationFreeHeld;
+}
+
+
+/**
+ * Runs every step-th operation of a workload, starting from the first-th, and records how each one went.
+ * Several threads can run this at once on a thread safe container, each with its own results.
+ * @param container The container to run the operations on.
+ * @param operations The workload's operations.
+ * @param first Index of the first operation to run.
+ * @param step Distance between two operations run by this call.
+ * @param perf Hardware counters to read around each operation, or nullptr to only time them.
+ * @param shadow Score counts to keep up to date and to rank extracted songs with, or nullptr to skip rank errors.
+ * @param results Where to record the latencies, counts, allocations and rank errors.
+ */
+void runOperations(SongContainer* container, const vector<Operation>* operations, unsigned int first, unsigned int step,
+                   PerfCounters* perf, ScoreShadow* shadow, OperationResults* results) {
+    // Counters are read outside the timed region, so they add nothing to the latencies:
+    PerfSample sample;
+    for (unsigned int i = first; i < operations->size(); i += step) {
+        const Operation& operation = operations->at(i);
+        AllocationCounts allocationsBefore = threadAllocationCounts();
+        if (perf != nullptr) perf->start();
+        chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+        bool removed = false;
+        Song extracted;
+
+        switch (operation.type) {
+            case OP_INSERT:
+                container->insert(operation.song);
+                break;
+            case OP_REMOVE:
+                removed = container->remove(operation.song.getName());
+                break;
+            case OP_SEARCH:
+                container->search(operation.score);
+                break;
+            case OP_RANGE:
+                rangeSearch(container, operation.score, operation.upperScore);
+                break;
+            default: // OP_EXTRACT_MAX
+                if (container->size() > 0) {
+                    extracted = container->extractMax();
+                }
+                break;
+        }
+
+        chrono::steady_clock::time_point endTime = chrono::steady_clock::now();
+        if (perf != nullptr) {
+            perf->stop(sample);
+            results->counters[operation.type].add(sample);
+            results->allCounters.add(sample);
+        }
+        AllocationCounts operationAllocations = threadAllocationCounts() - allocationsBefore;
+        results->allocations[operation.type].add(operationAllocations);
+        results->allAllocations.add(operationAllocations);
+        long long nanoseconds = chrono::duration_cast<chrono::nanoseconds>(endTime - startTime).count();
+        results->latencies[operation.type].record(nanoseconds);
+        results->allLatencies.record(nanoseconds);
+
+        if (shadow != nullptr) {
+            lock_guard<mutex> lock(shadow->lock);
+            if (operation.type == OP_INSERT) {
+                shadow->add(operation.song.getScore(), 1);
+            }
+            else if (removed) {
+                shadow->add(operation.song.getScore(), -1);
+            }
+            else if (!extracted.getName().empty()) {
+                results->rankErrors.record(shadow->countAbove(extracted.getScore()));
+                shadow->add(extracted.getScore(), -1);
+            }
+        }
+    }
+}
+
+
+// ScoreShadow:
+// ============
+
+/**
+ * Constructor.
+ * @param songs The songs the container is built with.
+ * @param maxScore The highest score in the workload. Higher scores are counted as this one.
+ */
+ScoreShadow::ScoreShadow(const vector<Song>& songs, int maxScore) : tree(maxScore + 2, 0), total(0) {
+    for (unsigned int i = 0; i < songs.size(); i++) {
+        add(songs.at(i).getScore(), 1);
+    }
+}
+
+
+/**
+ * Changes the number of songs with a score.
+ * @param score The score.
+ * @param count The number of songs added, or removed if negative.
+ */
+void ScoreShadow::add(int score, long long count) {
+    int last = static_cast<int>(tree.size()) - 1;
+    int index = score < 0 ? 1 : (score + 1 > last ? last : score + 1);
+    for (; index <= last; index += index & -index) {
+        tree.at(index) += count;
+    }
+    total += count;
+}
+
+
+/**
+ * Counts the songs with a higher score.
+ * @param score The score.
+ * @return The number of songs that outrank a song with this score.
+ */
+long long ScoreShadow::countAbove(int score) const {
+    int last = static_cast<int>(tree.size()) - 1;
+    int index = score < 0 ? 1 : (score + 1 > last ? last : score + 1);
+    long long atOrBelow = 0;
+    for (; index > 0; index -= index & -index) {
+        atOrBelow += tree.at(index);
+    }
+    return total - atOrBelow;
+}
+
+
+/**
+ * Prints one result line with the throughput and latency percentiles of a set of operations.
+ * @param latencies The latency of every operation in nanoseconds.
+ * @param seconds The total time the operations took, used for the throughput.
+ * @param counters Hardware counts of the operations, or nullptr if counters are off.
+ * @param allocations Allocations made by the operations, or nullptr if they are not counted.
+ * @param rankErrors Rank errors of the operations, or nullptr if they are not measured. Shown as NA if empty.
+ */
+void printLatencyRow(const string& containerKind, const WorkloadSpec& spec, const string& operation,
+                     const LatencyHistogram& latencies, double seconds, const PerfTotals* counters,
+                     const AllocationTotals* allocations, const LatencyHistogram* rankErrors) {
+    long long opsPerSecond = seconds > 0 ? static_cast<long long>(latencies.count() / seconds) : 0;
+    cout << containerKind << '\t' << spec.name << '\t' << distributionName(spec.distribution) << '\t';
+    if (spec.threads > 0) {
+        cout << spec.threads << '\t';
+    }
+    cout << operation << '\t'
+         << latencies.count() << '\t' << opsPerSecond << '\t' << latencies.percentile(50) << '\t' << latencies.percentile(90) << '\t'
+         << latencies.percentile(99) << '\t' << latencies.percentile(99.9) << '\t' << latencies.max();
+
+    if (counters != nullptr) {
+        // Average per operation:
+        double means[PERF_EVENT_COUNT];
+        bool valid[PERF_EVENT_COUNT];
+        for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+            valid[e] = counters->mean(static_cast<PerfEvent>(e), means[e]);
+            if (valid[e]) {
+                cout << '\t' << static_cast<long long>(means[e] + 0.5);
+            }
+            else {
+                cout << "\tNA";
+            }
+        }
+        if (valid[PERF_CYCLES] && valid[PERF_INSTRUCTIONS] && means[PERF_CYCLES] > 0) {
+            cout << '\t' << means[PERF_INSTRUCTIONS] / means[PERF_CYCLES];
+        }
+        else {
+            cout << "\tNA";
+        }
+    }
+    if (allocations != nullptr) {
+        cout << '\t' << allocations->allocationsPerOperation() << '\t' << static_cast<long long>(allocations->bytesPerOperation() + 0.5);
+    }
+    if (rankErrors != nullptr) {
+        if (rankErrors->count() > 0) {
+            cout << '\t' << rankErrors->mean() << '\t' << rankErrors->percentile(99) << '\t' << rankErrors->max();
+        }
+        else {
+            cout << "\tNA\tNA\tNA";
+        }
+    }
+    cout << endl;
+}
+
+
+/**
+ * Prints the command line usage of the benchmark program.
+ */
+void printUsage(const char* programName) {
+    cerr << "Usage: " << programName << " [options]" << endl;
+    cerr << "  --containers heap,splay     Containers to benchmark (default: all). Sharded ones take a shard count, e.g. sharded-heap:16" << endl;
+    cerr << "  --dist uniform,zipf,sequential  Key distributions to run (default: all)" << endl;
+    cerr << "  --mix I:R:S:G:E             Custom insert:remove:search:range:extractMax weights (default: presets)" << endl;
+    cerr << "  --songs N                   Songs in the container before the operations run" << endl;
+    cerr << "  --ops N                     Operations per workload" << endl;
+    cerr << "  --max-score N               Highest score generated" << endl;
+    cerr << "  --range-width N             Scores covered by each range operation" << endl;
+    cerr << "  --seed N                    Random seed" << endl;
+    cerr << "  --perf                      Also report average hardware counts per operation (Linux only)" << endl;
+    cerr << "  --threads N                 Threads running the operations of thread safe containers (sharded-, concurrent-, multiqueue, skiplist, persistent-treap)" << endl;
+    cerr << "  --alloc-free search,extract Fail if any listed operation allocates (needs make bench ALLOCS=1)" << endl;
+    cerr << "  --rank-error                Also report how many higher scoring songs each extractMax passed over" << endl;
+}
@@ -0,0 +1,237 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <cmath>
+
+#include "Workload.h"
+
+/**
+ * Gets the name of an operation type, as used in benchmark output.
+ * @param type The operation type.
+ * @return The operation's name.
+ */
+const char* operationName(OperationType type) {
+    switch (type) {
+        case OP_INSERT: return "insert";
+        case OP_REMOVE: return "remove";
+        case OP_SEARCH: return "search";
+        case OP_RANGE: return "range";
+        case OP_EXTRACT_MAX: return "extractMax";
+        default: return "unknown";
+    }
+}
+
+
+/**
+ * Converts the name of a distribution as typed by the user into a KeyDistribution.
+ * @param name One of "uniform", "zipf" or "sequential".
+ * @param distribution Set to the matching distribution.
+ * @return true if the name was recognised, false otherwise.
+ */
+bool parseKeyDistribution(const string& name, KeyDistribution& distribution) {
+    if (name == "uniform") {
+        distribution = KeyDistribution::UNIFORM;
+    }
+    else if (name == "zipf") {
+        distribution = KeyDistribution::ZIPFIAN;
+    }
+    else if (name == "sequential") {
+        distribution = KeyDistribution::SEQUENTIAL;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+
+const char* distributionName(KeyDistribution distribution) {
+    switch (distribution) {
+        case KeyDistribution::UNIFORM: return "uniform";
+        case KeyDistribution::ZIPFIAN: return "zipf";
+        default: return "sequential";
+    }
+}
+
+
+/**
+ * Default constructor gives a small mixed workload.
+ */
+WorkloadSpec::WorkloadSpec()
+    : name("mixed"), initialSongs(50000), operationCount(10000), distribution(KeyDistribution::UNIFORM),
+      maxScore(200), rangeWidth(10), seed(42), threads(0) {
+    mix[OP_INSERT] = 20;
+    mix[OP_REMOVE] = 20;
+    mix[OP_SEARCH] = 40;
+    mix[OP_RANGE] = 10;
+    mix[OP_EXTRACT_MAX] = 10;
+}
+
+
+/**
+ * Constructor. Does the O(n) set up work so that every sample afterwards takes constant time.
+ * @param n The number of ranks.
+ * @param theta The skew of the distribution. Must not be 1.
+ */
+ZipfSampler::ZipfSampler(long long n, double theta) : n(n > 0 ? n : 1), theta(theta), zetan(0) {
+    for (long long i = 1; i <= this->n; i++) {
+        zetan += 1.0 / pow(static_cast<double>(i), theta);
+    }
+    double zeta2 = 1.0 + 1.0 / pow(2.0, theta);
+    alpha = 1.0 / (1.0 - theta);
+    eta = (1.0 - pow(2.0 / this->n, 1.0 - theta)) / (1.0 - zeta2 / zetan);
+}
+
+
+/**
+ * Converts a uniform random number into a Zipfian rank.
+ * @param uniform A random number in the range [0, 1).
+ * @return A rank in the range 0 to n - 1.
+ */
+long long ZipfSampler::sample(double uniform) const {
+    double uz = uniform * zetan;
+    if (uz < 1.0) {
+        return 0;
+    }
+    if (uz < 1.0 + pow(0.5, theta)) {
+        return 1 < n ? 1 : 0;
+    }
+    long long rank = static_cast<long long>(n * pow(eta * uniform - eta + 1.0, alpha));
+    return rank < n ? rank : n - 1;
+}
+
+
+/**
+ * Constructor.
+ * @param spec The parameters of the workload to generate.
+ */
+WorkloadGenerator::WorkloadGenerator(const WorkloadSpec& spec)
+    : spec(spec), random(spec.seed), scoreZipf(spec.maxScore + 1), songZipf(spec.initialSongs),
+      sequentialCounter(0), nextSongNumber(0) {}
+
+
+/**
+ * Picks a score according to the workload's distribution.
+ * Under the Zipfian distribution, low scores are the most common, like in the real dataset.
+ * @return A score in the range 0 to maxScore.
+ */
+int WorkloadGenerator::pickScore() {
+    if (spec.distribution == KeyDistribution::UNIFORM) {
+        return uniform_int_distribution<int>(0, spec.maxScore)(random);
+    }
+    if (spec.distribution == KeyDistribution::ZIPFIAN) {
+        return static_cast<int>(scoreZipf.sample(uniform_real_distribution<double>(0.0, 1.0)(random)));
+    }
+    return static_cast<int>(sequentialCounter++ % (spec.maxScore + 1));
+}
+
+
+/**
+ * Picks one of a number of songs according to the workload's distribution.
+ * @param count The number of songs to pick from. Must be at least 1.
+ * @return An index in the range 0 to count - 1.
+ */
+int WorkloadGenerator::pickIndex(int count) {
+    if (spec.distribution == KeyDistribution::UNIFORM) {
+        return uniform_int_distribution<int>(0, count - 1)(random);
+    }
+    if (spec.distribution == KeyDistribution::ZIPFIAN) {
+        return static_cast<int>(songZipf.sample(uniform_real_distribution<double>(0.0, 1.0)(random)) % count);
+    }
+    return static_cast<int>(sequentialCounter++ % count);
+}
+
+
+/**
+ * Makes a new unique song ID shaped like a real track ID ("TR" followed by 16 characters).
+ * @return The new song ID.
+ */
+string WorkloadGenerator::nextSongId() {
+    // Scramble the song number so IDs are not in sorted order. The mixing function is a bijection, so IDs never repeat:
+    unsigned long long value = static_cast<unsigned long long>(nextSongNumber++) + 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    value = value ^ (value >> 31);
+
+    const char* digits = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    string id = "TR";
+    for (int i = 0; i < 16; i++) {
+        id += digits[value % 36];
+        value /= 36;
+    }
+    return id;
+}
+
+
+/**
+ * Generates the songs the container is built with.
+ * Under the sequential distribution the songs are in increasing order of score, which is the worst case for an unbalanced tree.
+ * @return The initial songs.
+ */
+vector<Song> WorkloadGenerator::generateSongs() {
+    vector<Song> songs;
+    songs.reserve(spec.initialSongs);
+    for (int i = 0; i < spec.initialSongs; i++) {
+        int score;
+        if (spec.distribution == KeyDistribution::SEQUENTIAL) {
+            score = static_cast<int>(static_cast<long long>(i) * (spec.maxScore + 1) / spec.initialSongs);
+        }
+        else {
+            score = pickScore();
+        }
+        songs.push_back(Song(nextSongId(), score));
+    }
+    sequentialCounter = 0;
+    return songs;
+}
+
+
+/**
+ * Generates the operations of the workload. Removes target songs that should still be in the container, unless
+ * they were taken out by an extractMax in the meantime.
+ * @param initialSongs The songs the container is built with.
+ * @return The operations, in the order they should be run.
+ */
+vector<Operation> WorkloadGenerator::generateOperations(const vector<Song>& initialSongs) {
+    // Track the songs that should be in the container, so removes can target real songs:
+    vector<Song> liveSongs(initialSongs);
+    liveSongs.reserve(initialSongs.size() + spec.operationCount);
+
+    discrete_distribution<int> pickType(spec.mix, spec.mix + OPERATION_TYPE_COUNT);
+    vector<Operation> operations;
+    operations.reserve(spec.operationCount);
+
+    for (int i = 0; i < spec.operationCount; i++) {
+        Operation operation;
+        operation.type = static_cast<OperationType>(pickType(random));
+        operation.score = 0;
+        operation.upperScore = 0;
+
+        if (operation.type == OP_INSERT) {
+            operation.song = Song(nextSongId(), pickScore());
+            liveSongs.push_back(operation.song);
+        }
+        else if (operation.type == OP_REMOVE) {
+            if (liveSongs.empty()) {
+                operation.song = Song(nextSongId(), 0); // Nothing left to remove, so target a song that does not exist.
+            }
+            else {
+                int index = pickIndex(liveSongs.size());
+                operation.song = move(liveSongs.at(index));
+                liveSongs.at(index) = move(liveSongs.back());
+                liveSongs.pop_back();
+            }
+        }
+        else if (operation.type == OP_SEARCH) {
+            operation.score = pickScore();
+        }
+        else if (operation.type == OP_RANGE) {
+            operation.score = pickScore();
+            operation.upperScore = operation.score + spec.rangeWidth - 1;
+        }
+
+        operations.push_back(operation);
+    }
+    return operations;
+}
@@ -0,0 +1,107 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#ifndef COP3530_PROJECT_3_WORKLOAD_H
+#define COP3530_PROJECT_3_WORKLOAD_H
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Song.h"
+
+using namespace std;
+
+/**
+ * The kinds of container operation a workload can contain.
+ */
+enum OperationType {
+    OP_INSERT,
+    OP_REMOVE,
+    OP_SEARCH,
+    OP_RANGE,
+    OP_EXTRACT_MAX,
+    OPERATION_TYPE_COUNT // Number of operation types. Not an operation.
+};
+
+const char* operationName(OperationType type);
+
+/**
+ * How the scores and songs used by operations are chosen.
+ */
+enum class KeyDistribution {
+    UNIFORM, // Every score (or song) is equally likely.
+    ZIPFIAN, // A few scores (or songs) are used far more often than the rest.
+    SEQUENTIAL // Scores (or songs) are used in increasing order, wrapping around at the end.
+};
+
+bool parseKeyDistribution(const string& name, KeyDistribution& distribution);
+const char* distributionName(KeyDistribution distribution);
+
+/**
+ * A single pre-generated operation. Only the fields used by the operation's type are meaningful.
+ */
+struct Operation {
+    OperationType type;
+    Song song; // Song to insert, or the song to remove (only its name is passed to the container).
+    int score; // Score to search for, or the lower bound of a range.
+    int upperScore; // Upper bound of a range.
+};
+
+/**
+ * Parameters of a benchmark workload.
+ */
+struct WorkloadSpec {
+    string name;
+    int initialSongs; // Number of songs the container is built with before the operations run.
+    int operationCount; // Number of operations to run after the build.
+    int mix[OPERATION_TYPE_COUNT]; // Relative weight of each operation type.
+    KeyDistribution distribution;
+    int maxScore; // Scores are in the range 0 to maxScore.
+    int rangeWidth; // Number of scores covered by each range operation.
+    unsigned int seed; // Seed for the random number generator, so a workload is the same every run.
+    int threads; // Threads running the operations at once, for thread safe containers. 0 if not given (one thread).
+
+    WorkloadSpec(); // ctr
+};
+
+/**
+ * Draws ranks 0 to n - 1 from a Zipfian distribution, where rank 0 is the most likely.
+ * Uses the constant time method from Gray et al., "Quickly Generating Billion-Record Synthetic Databases" (as used by YCSB).
+ */
+struct ZipfSampler {
+    long long n; // Number of ranks.
+    double theta; // Skew. Values closer to 1 give a more skewed distribution.
+    double zetan;
+    double alpha;
+    double eta;
+
+    ZipfSampler(long long n = 1, double theta = 0.99); // ctr
+    long long sample(double uniform) const;
+};
+
+/**
+ * Generates the songs and operations of a workload up front, so generation is never part of a timed operation.
+ */
+class WorkloadGenerator {
+private:
+    WorkloadSpec spec;
+    mt19937 random;
+    ZipfSampler scoreZipf; // Zipfian distribution over the scores.
+    ZipfSampler songZipf; // Zipfian distribution over the songs in the container.
+    long long sequentialCounter; // Next value handed out by the sequential distribution.
+    long long nextSongNumber; // Used to give every generated song a unique ID.
+
+    int pickScore();
+    int pickIndex(int count);
+    string nextSongId();
+public:
+    WorkloadGenerator(const WorkloadSpec& spec); // ctr
+
+    vector<Song> generateSongs();
+    vector<Operation> generateOperations(const vector<Song>& initialSongs);
+};
+
+
+#endif //COP3530_PROJECT_3_WORKLOAD_H
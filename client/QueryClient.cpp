@@ -0,0 +1,524 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <chrono>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "AsyncExecutor.h"
+#include "LatencyHistogram.h"
+#include "QueryProtocol.h"
+
+using namespace std;
+
+/**
+ * One connection to a query server. Requests are sent and answered one at a time.
+ */
+class QueryConnection {
+private:
+    int fd;
+    string error;
+
+    bool sendAll(const string& bytes);
+    bool receiveAll(char* buffer, size_t length);
+
+public:
+    QueryConnection(); // ctr
+    ~QueryConnection(); // dtr
+
+    bool open(const string& socketPath);
+    bool makeNonBlocking();
+    bool call(const Request& request, Response& response);
+    Task<bool> callAsync(AsyncExecutor& executor, const Request& request, Response& response);
+    const string& getError() const;
+};
+
+/**
+ * What one connection of a --clients run did.
+ */
+struct ClientTotals {
+    long long requests;
+    long long failures; // Requests that got no response, or an error response.
+    LatencyHistogram roundTrips;
+    string error;
+
+    ClientTotals() : requests(0), failures(0) {}
+};
+
+// Prototypes:
+// ===========
+bool parseRequest(const string& line, Request& request);
+string formatSongs(const vector<Song>& songs);
+const char* statusName(ResponseStatus status);
+bool readCommandFile(const string& filepath, vector<Request>& requests, vector<int>& lineNumbers);
+int runCommands(const string& socketPath, const vector<Request>& requests, const vector<int>& lineNumbers);
+int runLoad(const string& socketPath, const vector<Request>& requests, int clientCount, int repeat);
+Task<void> runLoadClient(AsyncExecutor& executor, const string& socketPath, const vector<Request>& requests, int repeat,
+                         ClientTotals* totals);
+void printUsage(const char* programName);
+
+
+// Implementations:
+// ================
+
+/**
+ * Entry point for the query client. Sends requests to a server started with lyricpsy --serve, either one request given
+ * on the command line, every request in a command file, or a command file from many connections at once to measure
+ * the server's throughput.
+ * @return 0 if every request was answered, 1 otherwise.
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    string socketPath = argv[1];
+
+    if (string(argv[2]) != "--file") {
+        // A single request, given as the remaining arguments:
+        string line;
+        for (int i = 2; i < argc; i++) {
+            line += string(i > 2 ? " " : "") + argv[i];
+        }
+        Request request;
+        if (!parseRequest(line, request)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        return runCommands(socketPath, vector<Request>(1, request), vector<int>(1, 1));
+    }
+
+    string commandFilepath = argc > 3 ? argv[3] : "";
+    int clientCount = 0;
+    int repeat = 1;
+    for (int i = 4; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--clients" && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            clientCount = atoi(argv[++i]);
+        }
+        else if (arg == "--repeat" && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            repeat = atoi(argv[++i]);
+        }
+        else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    vector<Request> requests;
+    vector<int> lineNumbers;
+    if (commandFilepath.empty() || !readCommandFile(commandFilepath, requests, lineNumbers)) {
+        cerr << "Could not read command file " << commandFilepath << endl;
+        return 1;
+    }
+    if (clientCount == 0) {
+        return runCommands(socketPath, requests, lineNumbers);
+    }
+    return runLoad(socketPath, requests, clientCount, repeat);
+}
+
+
+/**
+ * Parses a command in the format of a batch command file (see BatchRunner.h): search, range, topk, insert, remove or
+ * size, followed by its arguments.
+ * @param line The command.
+ * @param request Populated with the request.
+ * @return true if the command is one the server answers and has valid arguments, false otherwise.
+ */
+bool parseRequest(const string& line, Request& request) {
+    istringstream args(line);
+    string command;
+    args >> command;
+    request = Request();
+    if (command == "search") {
+        request.type = REQUEST_SEARCH;
+        return static_cast<bool>(args >> request.firstNumber);
+    }
+    if (command == "range") {
+        request.type = REQUEST_RANGE;
+        return static_cast<bool>(args >> request.firstNumber >> request.secondNumber);
+    }
+    if (command == "topk") {
+        request.type = REQUEST_TOPK;
+        return static_cast<bool>(args >> request.firstNumber);
+    }
+    if (command == "insert") {
+        request.type = REQUEST_INSERT;
+        return static_cast<bool>(args >> request.songName >> request.firstNumber);
+    }
+    if (command == "remove") {
+        request.type = REQUEST_REMOVE;
+        return static_cast<bool>(args >> request.songName);
+    }
+    if (command == "size") {
+        request.type = REQUEST_SIZE;
+        return true;
+    }
+    return false;
+}
+
+
+/**
+ * Formats a list of songs as comma separated id:score pairs, like batch mode.
+ */
+string formatSongs(const vector<Song>& songs) {
+    string formatted;
+    for (unsigned int i = 0; i < songs.size(); i++) {
+        if (i > 0) {
+            formatted += ',';
+        }
+        formatted += songs.at(i).getName() + ":" + to_string(songs.at(i).getScore());
+    }
+    return formatted;
+}
+
+
+const char* statusName(ResponseStatus status) {
+    switch (status) {
+        case RESPONSE_OK: return "ok";
+        case RESPONSE_NOT_FOUND: return "not_found";
+        case RESPONSE_ERROR: return "error";
+    }
+    return "unknown";
+}
+
+
+/**
+ * Reads every request in a command file. Comments, blank lines and commands the server does not answer (such as load)
+ * are skipped, with a warning for the latter.
+ * @param filepath The command file.
+ * @param requests Populated with the requests, in file order.
+ * @param lineNumbers Populated with the line each request came from.
+ * @return true if the file could be read, false otherwise.
+ */
+bool readCommandFile(const string& filepath, vector<Request>& requests, vector<int>& lineNumbers) {
+    ifstream commandFile(filepath);
+    if (!commandFile) {
+        return false;
+    }
+    string line;
+    int lineNumber = 0;
+    while (getline(commandFile, line)) {
+        lineNumber++;
+        size_t firstChar = line.find_first_not_of(" \t\r");
+        if (firstChar == string::npos || line.at(firstChar) == '#') {
+            continue;
+        }
+        Request request;
+        if (!parseRequest(line, request)) {
+            cerr << "Skipping line " << lineNumber << ": not a server request." << endl;
+            continue;
+        }
+        requests.push_back(request);
+        lineNumbers.push_back(lineNumber);
+    }
+    return true;
+}
+
+
+/**
+ * Sends requests one after another on a single connection and prints one tab separated line per response: line number,
+ * command, status, round trip time in nanoseconds, container size after the request, and the songs or error message.
+ * @return 0 if every request was answered without an error status, 1 otherwise.
+ */
+int runCommands(const string& socketPath, const vector<Request>& requests, const vector<int>& lineNumbers) {
+    QueryConnection connection;
+    if (!connection.open(socketPath)) {
+        cerr << "Could not connect to " << socketPath << ": " << connection.getError() << endl;
+        return 1;
+    }
+
+    cout << "line\tcommand\tstatus\ttime_ns\tsize\tresult" << endl;
+    bool allOk = true;
+    for (unsigned int i = 0; i < requests.size(); i++) {
+        Response response;
+        chrono::high_resolution_clock::time_point startTime = chrono::high_resolution_clock::now();
+        if (!connection.call(requests.at(i), response)) {
+            cerr << "Line " << lineNumbers.at(i) << ": " << connection.getError() << endl;
+            return 1;
+        }
+        chrono::high_resolution_clock::time_point endTime = chrono::high_resolution_clock::now();
+        cout << lineNumbers.at(i) << '\t' << requestTypeName(requests.at(i).type) << '\t' << statusName(response.status)
+             << '\t' << chrono::duration_cast<chrono::nanoseconds>(endTime - startTime).count() << '\t'
+             << response.containerSize << '\t'
+             << (response.status == RESPONSE_ERROR ? response.message : formatSongs(response.songs)) << '\n';
+        allOk = allOk && response.status != RESPONSE_ERROR;
+    }
+    cout.flush();
+    return allOk ? 0 : 1;
+}
+
+
+/**
+ * Sends every request in a command file from several connections at once and prints the total throughput and the
+ * round trip latencies. The connections are coroutines on this one thread (see AsyncExecutor.h): each sends a request
+ * and gives up the thread until its response arrives, so a slow response only holds up its own connection.
+ * @param clientCount The number of connections.
+ * @param repeat How many times each connection sends the whole file.
+ * @return 0 if every request was answered without an error status, 1 otherwise.
+ */
+int runLoad(const string& socketPath, const vector<Request>& requests, int clientCount, int repeat) {
+    AsyncExecutor executor;
+    vector<ClientTotals*> totals;
+    for (int c = 0; c < clientCount; c++) {
+        totals.push_back(new ClientTotals());
+        executor.spawn(runLoadClient(executor, socketPath, requests, repeat, totals.at(c)));
+    }
+
+    chrono::high_resolution_clock::time_point startTime = chrono::high_resolution_clock::now();
+    executor.run();
+    chrono::high_resolution_clock::time_point endTime = chrono::high_resolution_clock::now();
+
+    // Combine the clients' results:
+    LatencyHistogram roundTrips;
+    long long requestCount = 0;
+    long long failures = 0;
+    bool allConnected = true;
+    for (int c = 0; c < clientCount; c++) {
+        if (!totals.at(c)->error.empty()) {
+            cerr << "Client " << c + 1 << ": " << totals.at(c)->error << endl;
+            allConnected = false;
+        }
+        roundTrips.merge(totals.at(c)->roundTrips);
+        requestCount += totals.at(c)->requests;
+        failures += totals.at(c)->failures;
+        delete totals.at(c);
+    }
+
+    double seconds = chrono::duration_cast<chrono::duration<double>>(endTime - startTime).count();
+    cout << "clients\trequests\terrors\tseconds\trequests_per_s\tp50_ns\tp90_ns\tp99_ns\tmax_ns" << endl;
+    cout << clientCount << '\t' << requestCount << '\t' << failures << '\t' << seconds << '\t'
+         << (seconds > 0 ? static_cast<long long>(requestCount / seconds) : 0) << '\t' << roundTrips.percentile(50) << '\t'
+         << roundTrips.percentile(90) << '\t' << roundTrips.percentile(99) << '\t' << roundTrips.max() << endl;
+    return allConnected && failures == 0 ? 0 : 1;
+}
+
+
+/**
+ * One connection of a --clients run: sends every request in turn, recording the round trip of each.
+ * @param totals Where the connection's results go.
+ */
+Task<void> runLoadClient(AsyncExecutor& executor, const string& socketPath, const vector<Request>& requests, int repeat,
+                         ClientTotals* totals) {
+    QueryConnection connection;
+    if (!connection.open(socketPath) || !connection.makeNonBlocking()) {
+        totals->error = connection.getError();
+        co_return;
+    }
+    for (int r = 0; r < repeat; r++) {
+        for (unsigned int i = 0; i < requests.size(); i++) {
+            Response response;
+            chrono::high_resolution_clock::time_point sent = chrono::high_resolution_clock::now();
+            if (!co_await connection.callAsync(executor, requests.at(i), response)) {
+                totals->error = connection.getError();
+                co_return;
+            }
+            chrono::high_resolution_clock::time_point received = chrono::high_resolution_clock::now();
+            totals->roundTrips.record(chrono::duration_cast<chrono::nanoseconds>(received - sent).count());
+            totals->requests++;
+            if (response.status == RESPONSE_ERROR) {
+                totals->failures++;
+            }
+        }
+    }
+}
+
+
+void printUsage(const char* programName) {
+    cerr << "Usage: " << programName << " <socket path> <command> [arguments]" << endl;
+    cerr << "       " << programName << " <socket path> --file <command file> [--clients N] [--repeat N]" << endl;
+    cerr << "Commands: search <score>, range <min score> <max score>, topk <n>, insert <song id> <score>," << endl;
+    cerr << "          remove <song id>, size" << endl;
+    cerr << "  --file FILE     Send every command in a batch command file, printing one line per response" << endl;
+    cerr << "  --clients N     Send the file from N connections at once and print throughput and latency instead" << endl;
+    cerr << "  --repeat N      With --clients, each connection sends the file N times (default: 1)" << endl;
+}
+
+
+// QueryConnection:
+// ================
+
+QueryConnection::QueryConnection() : fd(-1) {}
+
+
+QueryConnection::~QueryConnection() {
+#ifdef __linux__
+    if (fd != -1) {
+        close(fd);
+    }
+#endif
+}
+
+
+const string& QueryConnection::getError() const {
+    return error;
+}
+
+
+/**
+ * Connects to a server.
+ * @param socketPath The path of the server's Unix domain socket.
+ * @return true if connected, false otherwise (see getError()).
+ */
+bool QueryConnection::open(const string& socketPath) {
+#ifdef __linux__
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        error = "socket path is too long";
+        return false;
+    }
+    strcpy(address.sun_path, socketPath.c_str());
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1) {
+        error = strerror(errno);
+        return false;
+    }
+    return true;
+#else
+    error = "Unix domain sockets are only supported on Linux";
+    return false;
+#endif
+}
+
+
+/**
+ * Sends a request and waits for its response.
+ * @param request The request.
+ * @param response Populated with the response.
+ * @return true if a well formed response arrived, false if the connection failed (see getError()).
+ */
+bool QueryConnection::call(const Request& request, Response& response) {
+    if (!sendAll(encodeRequest(request))) {
+        return false;
+    }
+    char header[FRAME_HEADER_BYTES];
+    if (!receiveAll(header, FRAME_HEADER_BYTES)) {
+        return false;
+    }
+    uint32_t length = readFrameLength(header);
+    if (length > MAX_RESPONSE_BYTES) {
+        error = "response too long";
+        return false;
+    }
+    vector<char> body(length);
+    if (!receiveAll(body.data(), length)) {
+        return false;
+    }
+    if (!decodeResponse(body.data(), length, response)) {
+        error = "malformed response";
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * Switches the connection to non-blocking mode, as needed by callAsync().
+ * @return true on success, false otherwise (see getError()).
+ */
+bool QueryConnection::makeNonBlocking() {
+#ifdef __linux__
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags == -1 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1) {
+        error = strerror(errno);
+        return false;
+    }
+#endif
+    return true;
+}
+
+
+/**
+ * Sends a request and waits for its response, giving up the executor's thread while waiting.
+ * The connection must have been made non-blocking first.
+ * @param request The request.
+ * @param response Populated with the response.
+ * @return true if a well formed response arrived, false if the connection failed (see getError()).
+ */
+Task<bool> QueryConnection::callAsync(AsyncExecutor& executor, const Request& request, Response& response) {
+    if (!co_await executor.sendAll(fd, encodeRequest(request))) {
+        error = "could not send the request";
+        co_return false;
+    }
+    char header[FRAME_HEADER_BYTES];
+    if (!co_await executor.receiveAll(fd, header, FRAME_HEADER_BYTES)) {
+        error = "the server closed the connection";
+        co_return false;
+    }
+    uint32_t length = readFrameLength(header);
+    if (length > MAX_RESPONSE_BYTES) {
+        error = "response too long";
+        co_return false;
+    }
+    vector<char> body(length);
+    if (!co_await executor.receiveAll(fd, body.data(), length)) {
+        error = "the server closed the connection";
+        co_return false;
+    }
+    if (!decodeResponse(body.data(), length, response)) {
+        error = "malformed response";
+        co_return false;
+    }
+    co_return true;
+}
+
+
+bool QueryConnection::sendAll(const string& bytes) {
+#ifdef __linux__
+    size_t sentBytes = 0;
+    while (sentBytes < bytes.size()) {
+        ssize_t sent = send(fd, bytes.data() + sentBytes, bytes.size() - sentBytes, MSG_NOSIGNAL);
+        if (sent == -1 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            error = string("could not send: ") + strerror(errno);
+            return false;
+        }
+        sentBytes += static_cast<size_t>(sent);
+    }
+    return true;
+#else
+    (void) bytes;
+    return false;
+#endif
+}
+
+
+bool QueryConnection::receiveAll(char* buffer, size_t length) {
+#ifdef __linux__
+    size_t receivedBytes = 0;
+    while (receivedBytes < length) {
+        ssize_t received = recv(fd, buffer + receivedBytes, length - receivedBytes, 0);
+        if (received == -1 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            error = received == 0 ? "the server closed the connection" : string("could not receive: ") + strerror(errno);
+            return false;
+        }
+        receivedBytes += static_cast<size_t>(received);
+    }
+    return true;
+#else
+    (void) buffer;
+    (void) length;
+    return false;
+#endif
+}
@@ -1,20 +1,33 @@
 #include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
-#include <queue>
-#include <unordered_map>
+#include <limits>
+#include <sstream>
 
+#include "BatchRunner.h"
+#include "ContainerOperations.h"
 #include "Song.h"
 #include "SongContainer.h"
 #include "SplayTree.h"
-// Please note: the below import sqlite3.h is not my code. It is a header file required for using the sqlite3 dll. Source: https://www.sqlite.org/download.html (taken from the amalgamation file).
-#include "sqlite3.h"
+#include "SongDatabase.h"
+#include "TrackScoreMap.h"
 #include "MaxHeap.h"
+#include "OperationLatencies.h"
+#include "PerfCounters.h"
+#include "QueryServer.h"
+#include "Tracer.h"
+#include "WriteAheadLog.h"
 
 using namespace std;
 
 // Prototypes:
 // ===========
-void readSqliteDb(const char* dbFilepath, unordered_map<string, int>& resultsMap);
+int runBatchMode(int argc, char* argv[]);
+int runServerMode(int argc, char* argv[]);
+void stopServer(int signalNumber);
+void compactIfNeeded(WriteAheadLog& changeLog, SongContainer* container);
 void printMainMenu();
 void printOperationsMenu();
 
@@ -24,9 +37,31 @@ void printOperationsMenu();
 
 /**
  * Entry point for the program. Handles user input and general flow of the program.
+ * Runs in batch mode instead of the interactive menus if started with --batch, or as a query server with --serve.
  * @return 0 if program finishes without error.
  */
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            if (string(argv[i]) == "--serve") {
+                return runServerMode(argc, argv);
+            }
+        }
+        return runBatchMode(argc, argv);
+    }
+
+    // Setting LYRICPSY_TRACE to a file path records a timeline of the session, written when the program quits:
+    const char* tracePath = getenv("LYRICPSY_TRACE");
+    if (tracePath != nullptr && tracePath[0] != '\0') {
+        if (startTracing(tracePath)) {
+            traceThreadName("main");
+            cout << "Recording a trace of this session to " << tracePath << "." << endl;
+        }
+        else {
+            cout << "Could not create trace file " << tracePath << ". Continuing without a trace." << endl;
+        }
+    }
+
     SongContainer* container = nullptr; // Pointer to the abstract base class. Polymorphism will allow this to contain either of our data structures.
 
     // Print initial text:
@@ -51,8 +86,37 @@ int main() {
         container = new SplayTree();
     }
 
+    OperationLatencies latencies; // Latency histogram of every operation timed in this session.
+    PerfCounters perf; // Hardware counters around every timed operation. Off until turned on with option 12.
+    PerfSample counterSample; // Counts of the most recent timed operation.
     bool isDataLoaded = false; // keeps track of whether the container has data yet. Determines whether 'build' should be called.
 
+    // Setting LYRICPSY_WAL to a file path logs every change to the songs, and replays the log the next time the program
+    // starts. LYRICPSY_WAL_SYNC (none, data or full) sets how far each write is pushed to disk:
+    WriteAheadLog changeLog;
+    const char* walPath = getenv("LYRICPSY_WAL");
+    if (walPath != nullptr && walPath[0] != '\0') {
+        WalSyncMode syncMode = WalSyncMode::DATA;
+        const char* syncName = getenv("LYRICPSY_WAL_SYNC");
+        if (syncName != nullptr && syncName[0] != '\0' && !parseWalSyncMode(syncName, syncMode)) {
+            cout << "Unknown LYRICPSY_WAL_SYNC mode " << syncName << ". Using data." << endl;
+        }
+        LogContents contents;
+        if (!restoreFromLog(walPath, container, contents)) {
+            cout << "Could not replay the log " << walPath << ". Continuing without a log." << endl;
+        }
+        else if (!changeLog.open(walPath, syncMode)) {
+            cout << "Could not open the log: " << changeLog.getError() << ". Continuing without a log." << endl;
+        }
+        else {
+            isDataLoaded = contents.hasBase || !contents.changes.empty();
+            if (isDataLoaded) {
+                cout << "Restored " << container->size() << " songs from the log " << walPath << "." << endl;
+            }
+            cout << "Logging changes to " << walPath << "." << endl;
+        }
+    }
+
     // Print first appearance of the Operations Menu:
     cout << endl;
     cout << endl;
@@ -67,27 +131,56 @@ int main() {
 
         if (operationChoice == 1) { // Load data from SQLite database file:
             if (!isDataLoaded) {
-                cout << "Please specify the path of your SQLite database file: ";
+                // Several databases (e.g. train and test splits) can be loaded together and merged into one container:
+                cout << "Please specify the path of your SQLite database file (or several paths separated by spaces): ";
+                string pathLine;
+                cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Discard the rest of the line containing the menu choice.
+                getline(cin, pathLine);
+                vector<string> filepaths;
+                istringstream pathStream(pathLine);
                 string filepath;
-                cin >> filepath;
-                unordered_map<string, int> songScores;
-                readSqliteDb(filepath.c_str(), songScores);
-                vector<Song> songs; // This will be used to initialize the SplayTree or MaxHeap.
-
-                // Populate 'songs' with the songs from the database.
-                for (auto iter = songScores.begin(); iter != songScores.end(); ++iter) {
-                    songs.push_back(Song(iter->first, iter->second));
+                while (pathStream >> filepath) {
+                    filepaths.push_back(filepath);
                 }
 
-                // Build the data structure with the newly read data and time how long it takes:
-                chrono::high_resolution_clock::time_point startTime = chrono::high_resolution_clock::now(); // start timing.
-                container->build(songs); // build the underlying data structure for the program.
-                chrono::high_resolution_clock::time_point endTime = chrono::high_resolution_clock::now(); // stop timing.
-                auto timeTaken = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime);
+                // Ask how to resolve tracks that appear in more than one database:
+                MergePolicy policy = MergePolicy::SUM;
+                if (filepaths.size() > 1) {
+                    string policyName;
+                    cout << "How should scores of a song found in more than one database be combined? (sum/max/last): ";
+                    cin >> policyName;
+                    while (!parseMergePolicy(policyName, policy)) {
+                        cout << "Invalid choice. Please type sum, max or last: ";
+                        cin >> policyName;
+                    }
+                }
 
-                // Print the result and how long it took:
-                cout << "Success! Data structure has been built and populated with values from the database!" << endl;
-                cout << "Time taken: " << timeTaken.count() << "ns" << endl << endl << endl;
+                TraceScope loadScope("load", "ingest"); // Covers the read and the build.
+                TrackScoreMap songScores;
+                if (!filepaths.empty() && readSqliteDbs(filepaths, songScores, policy)) {
+                    vector<Song>& songs = songScores.getSongs(); // The map stores its songs densely, so they can be used to build the container without a copy.
+
+                    // Build the data structure with the newly read data and time how long it takes:
+                    AllocationCounts allocationsBefore = threadAllocationCounts();
+                    perf.start();
+                    chrono::high_resolution_clock::time_point startTime = chrono::high_resolution_clock::now(); // start timing.
+                    container->build(songs); // build the underlying data structure for the program.
+                    chrono::high_resolution_clock::time_point endTime = chrono::high_resolution_clock::now(); // stop timing.
+                    perf.stop(counterSample);
+                    auto timeTaken = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime);
+                    latencies.record(TIMED_BUILD, timeTaken.count(), counterSample); // Keep every sample for the session statistics (option 11).
+                    latencies.recordAllocations(TIMED_BUILD, threadAllocationCounts() - allocationsBefore);
+                    traceSpan(OperationLatencies::operationName(TIMED_BUILD), "build", startTime, endTime);
+                    traceCounter("container size", container->size());
+                    loadScope.end();
+
+                    isDataLoaded = true;
+                    changeLog.logBase(filepaths, policy); // Does nothing if there is no log.
+
+                    // Print the result and how long it took:
+                    cout << "Success! Data structure has been built and populated with values from the database!" << endl;
+                    cout << "Time taken: " << timeTaken.count() << "ns" << endl << endl << endl;
+                }
             }
             else {
                 // If container has already been built, the program prevents user from building it again and assumes this is a mistake.
@@ -108,10 +201,20 @@ int main() {
             cin >> score;
 
             // Insert the song and time how long it takes:
+            AllocationCounts allocationsBefore = threadAllocationCounts();
+            perf.start();
             chrono::high_resolution_clock::time_point startTime = chrono::high_resolution_clock::now();
             container->insert(Song(songId, score));
             chrono::high_resolution_clock::time_point endTime = chrono::high_resolution_clock::now();
+            perf.stop(counterSample);
             auto timeTaken = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime);
+            latencies.record(TIMED_INSERT, timeTaken.count(), counterSample);
+            latencies.recordAllocations(TIMED_INSERT, threadAllocationCounts() - allocationsBefore);
+            traceSpan(OperationLatencies::operationName(TIMED_INSERT), "query", startTime, endTime);
+            traceCounter("container size", container->size());
+
+            changeLog.logInsert(Song(songId, score)); // Does nothing if there is no log.
+            compactIfNeeded(changeLog, container);
 
             // Print result and how long it took:
             cout << "Success! " << songId << " has been added with narcissism index " << score << "." << endl;
@@ -140,10 +243,20 @@ int main() {
             int score = iCount + meCount + myCount; // Calculate the narcissism score
 
             // Insert the song and time how long it takes:
+            AllocationCounts allocationsBefore = threadAllocationCounts();
+            perf.start();
             chrono::high_resolution_clock::time_point startTime = chrono::high_resolution_clock::now();
             container->insert(Song(songId, score));
             chrono::high_resolution_clock::time_point endTime = chrono::high_resolution_clock::now();
+            perf.stop(counterSample);
             auto timeTaken = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime);
+            latencies.record(TIMED_INSERT, timeTaken.count(), counterSample);
+            latencies.recordAllocations(TIMED_INSERT, threadAllocationCounts() - allocationsBefore);
+            traceSpan(OperationLatencies::operationName(TIMED_INSERT), "query", startTime, endTime);
+            traceCounter("container size", container->size());
+
+            changeLog.logInsert(Song(songId, score)); // Does nothing if there is no log.
+            compactIfNeeded(changeLog, container);
 
             // Print result and how long it took:
             cout << "Success! " << songId << " has been added with narcissism index " << score << "." << endl;
@@ -153,17 +266,27 @@ int main() {
 
         else if (operationChoice == 4) { // Remove a song by songname/ID-string:
             string songId;
+            Song removedSong;
             cout << "Please provide the song ID to remove: ";
             cin >> songId;
 
             // Remove the song and time how long it takes:
+            AllocationCounts allocationsBefore = threadAllocationCounts();
+            perf.start();
             chrono::high_resolution_clock::time_point startTime = chrono::high_resolution_clock::now();
-            bool success = container->remove(songId);
+            bool success = container->remove(songId, &removedSong);
             chrono::high_resolution_clock::time_point endTime = chrono::high_resolution_clock::now();
+            perf.stop(counterSample);
             auto timeTaken = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime);
+            latencies.record(TIMED_REMOVE, timeTaken.count(), counterSample);
+            latencies.recordAllocations(TIMED_REMOVE, threadAllocationCounts() - allocationsBefore);
+            traceSpan(OperationLatencies::operationName(TIMED_REMOVE), "query", startTime, endTime);
+            traceCounter("container size", container->size());
 
             // Print result:
             if (success) {
+                changeLog.logRemove(removedSong); // Its score too, so replaying removes exactly this song.
+                compactIfNeeded(changeLog, container);
                 cout << songId << " successfully removed!" << endl;
             }
             else {
@@ -182,10 +305,16 @@ int main() {
             cin >> targetScore;
 
             // Search for the song and time how long it takes:
+            AllocationCounts allocationsBefore = threadAllocationCounts();
+            perf.start();
             chrono::high_resolution_clock::time_point startTime = chrono::high_resolution_clock::now();
             Song result = container->search(targetScore);
             chrono::high_resolution_clock::time_point endTime = chrono::high_resolution_clock::now();
+            perf.stop(counterSample);
             auto timeTaken = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime);
+            latencies.record(TIMED_SEARCH, timeTaken.count(), counterSample);
+            latencies.recordAllocations(TIMED_SEARCH, threadAllocationCounts() - allocationsBefore);
+            traceSpan(OperationLatencies::operationName(TIMED_SEARCH), "query", startTime, endTime);
 
             // Print result:
             if (result.getName().empty()) {
@@ -211,30 +340,25 @@ int main() {
             cout << "Please provide the maximum score to search for in the range: ";
             cin >> upperBound;
 
-            queue<Song> results; // This will keep track of the results of the search.
-
             // Search for all songs in the given range and time how long it takes:
+            AllocationCounts allocationsBefore = threadAllocationCounts();
+            perf.start();
             chrono::high_resolution_clock::time_point startTime = chrono::high_resolution_clock::now();
-            for (int searchCounter = lowerBound; searchCounter < upperBound + 1; searchCounter++) {
-                Song result = container->search(searchCounter);
-                results.push(result);
-            }
+            vector<Song> results = rangeSearch(container, lowerBound, upperBound);
             chrono::high_resolution_clock::time_point endTime = chrono::high_resolution_clock::now();
+            perf.stop(counterSample);
             auto timeTaken = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime);
+            latencies.record(TIMED_RANGE, timeTaken.count(), counterSample);
+            latencies.recordAllocations(TIMED_RANGE, threadAllocationCounts() - allocationsBefore);
+            traceSpan(OperationLatencies::operationName(TIMED_RANGE), "query", startTime, endTime);
 
             // Print results:
             if (results.empty()) {
                 cout << "Found no songs in the given narcissism score range!" << endl;
             }
             else {
-                while(!results.empty()) {
-                    string name = results.front().getName();
-                    int score = results.front().getScore();
-
-                    if (!name.empty()) { // If the name is empty, then it was a placeholder result for a score that does not exist.
-                        cout << "Found song " << name << " with score of " << score << endl;
-                    }
-                    results.pop();
+                for (unsigned int i = 0; i < results.size(); i++) {
+                    cout << "Found song " << results.at(i).getName() << " with score of " << results.at(i).getScore() << endl;
                 }
             }
 
@@ -246,10 +370,16 @@ int main() {
         else if (operationChoice == 7) { // Print on-screen the number of songs currently stored in the data structure:
 
             // Get the size() of the data structure and time how long the method call takes to execute:
+            AllocationCounts allocationsBefore = threadAllocationCounts();
+            perf.start();
             chrono::high_resolution_clock::time_point startTime = chrono::high_resolution_clock::now();
             int size = container->size();
             chrono::high_resolution_clock::time_point endTime = chrono::high_resolution_clock::now();
+            perf.stop(counterSample);
             auto timeTaken = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime);
+            latencies.record(TIMED_SIZE, timeTaken.count(), counterSample);
+            latencies.recordAllocations(TIMED_SIZE, threadAllocationCounts() - allocationsBefore);
+            traceSpan(OperationLatencies::operationName(TIMED_SIZE), "query", startTime, endTime);
 
             // Print the result and the time taken:
             cout << "There are " << size << " songs in the program." << endl;
@@ -263,21 +393,126 @@ int main() {
             cout << "Please specify N: ";
             cin >> N;
 
-            // Extract N songs and time how long it takes:
-            chrono::high_resolution_clock::time_point startTime = chrono::high_resolution_clock::now();
-            for (int i = 0; i < N; i++) {
-                Song song = container->extractMax();
-                cout << song.getName() << " has score of " << song.getScore() << endl;
+            // Extract N songs, timing each extraction on its own. Printing is left until afterwards so it is not timed:
+            vector<Song> extracted;
+            long long totalTime = 0;
+            for (int i = 0; i < N && container->size() > 0; i++) {
+                AllocationCounts allocationsBefore = threadAllocationCounts();
+                perf.start();
+                chrono::high_resolution_clock::time_point startTime = chrono::high_resolution_clock::now();
+                extracted.push_back(container->extractMax());
+                chrono::high_resolution_clock::time_point endTime = chrono::high_resolution_clock::now();
+                perf.stop(counterSample);
+                auto timeTaken = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime);
+                latencies.record(TIMED_EXTRACT, timeTaken.count(), counterSample);
+                latencies.recordAllocations(TIMED_EXTRACT, threadAllocationCounts() - allocationsBefore);
+                traceSpan(OperationLatencies::operationName(TIMED_EXTRACT), "query", startTime, endTime);
+                traceCounter("container size", container->size());
+                totalTime += timeTaken.count();
             }
-            chrono::high_resolution_clock::time_point endTime = chrono::high_resolution_clock::now();
-            auto timeTaken = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime);
+
+            for (unsigned int i = 0; i < extracted.size(); i++) {
+                changeLog.logRemove(extracted.at(i));
+                cout << extracted.at(i).getName() << " has score of " << extracted.at(i).getScore() << endl;
+            }
+            compactIfNeeded(changeLog, container);
 
             // Print the time taken:
-            cout << "Time taken: " << timeTaken.count() << "ms" << endl << endl << endl;
+            cout << "Time taken for " << extracted.size() << " extractions: " << totalTime << "ns" << endl << endl << endl;
         }
 
+        else if (operationChoice == 10) { // Print the top N songs of a database without loading it into the container:
+
+            // This reads the database directly, so it works whether or not the container has been loaded:
+            cout << "Please specify the path of your SQLite database file: ";
+            string filepath;
+            cin >> filepath;
+
+            int N;
+            cout << "Please specify N: ";
+            cin >> N;
+
+            vector<Song> topSongs;
+            if (streamTopSongs(filepath.c_str(), N, topSongs)) {
+                for (unsigned int i = 0; i < topSongs.size(); i++) {
+                    cout << topSongs.at(i).getName() << " has score of " << topSongs.at(i).getScore() << endl;
+                }
+            }
+            cout << endl << endl;
+        }
+
+        else if (operationChoice == 11) { // Print the latency statistics of every operation run so far:
+            cout << "Latency of every operation timed in this session:" << endl;
+            latencies.print(cout);
+
+            // Averages are only shown once counters have been turned on with option 12:
+            if (latencies.hasCounters()) {
+                cout << endl << "Average hardware counts per operation, while counters were on:" << endl;
+                latencies.printCounters(cout);
+            }
+
+            // Only in builds that count allocations (make ALLOCS=1):
+            if (allocationTrackingEnabled()) {
+                cout << endl << "Heap allocations per operation:" << endl;
+                latencies.printAllocations(cout);
+            }
+            cout << endl << endl;
+        }
+
+        else if (operationChoice == 12) { // Turn hardware performance counters on or off:
+            if (perf.isAvailable()) {
+                perf.close();
+                cout << "Hardware counters are now off." << endl;
+            }
+            else if (perf.open()) {
+                cout << "Hardware counters are now on. Option 11 shows their averages per operation." << endl;
+            }
+            else {
+                // Common in containers and virtual machines, or when perf_event_paranoid does not allow it:
+                cout << "Hardware counters are not available on this system (" << perf.getError() << ")." << endl;
+                cout << "Operations will still be timed." << endl;
+            }
+            cout << endl << endl;
+        }
+
+        else if (operationChoice == 14) { // Print how much memory the data structure is using:
+            cout << "Memory used by the data structure:" << endl;
+            container->memoryUsage().print(cout);
+            cout << endl << endl;
+        }
+
+#if defined(SPLAYTREE_STATS) || defined(MAXHEAP_STATS)
+        else if (operationChoice == 13) { // Print what the data structure has done so far (statistics builds only):
+            bool printed = false;
+#ifdef SPLAYTREE_STATS
+            SplayTree* tree = dynamic_cast<SplayTree*>(container);
+            if (tree != nullptr) {
+                tree->printStats(cout);
+                tree->resetStats();
+                printed = true;
+            }
+#endif
+#ifdef MAXHEAP_STATS
+            MaxHeap* heap = dynamic_cast<MaxHeap*>(container);
+            if (heap != nullptr) {
+                heap->printStats(cout);
+                heap->resetStats();
+                printed = true;
+            }
+#endif
+            if (printed) {
+                cout << "(Counters have been reset.)" << endl;
+            }
+            else {
+                cout << "Statistics were not compiled in for this data structure." << endl;
+            }
+            cout << endl << endl;
+        }
+#endif
+
         else if (operationChoice == 9) { // Quit the program:
             cout << "Goodbye!" << endl;
+            changeLog.close();
             return 0;
         }
 
@@ -290,60 +525,272 @@ int main() {
         cin >> operationChoice;
     }
 
+    // Write the last changes to the log, then the trace, if LYRICPSY_TRACE asked for one:
+    changeLog.close();
+    if (isTracing() && !stopTracing()) {
+        cout << "Could not write the trace file." << endl;
+    }
 
     return 0;
 }
 
 
 /**
- * Reads a Million Song Dataset 'bag of words'-style SQLite database.
- * @param resultsMap A map to contain each song name and its calculated narcissism score.
- * @param dbFilepath The path to the SQLite database file.
+ * Runs a command file against a container without any prompts. Usage:
+ *   lyricpsy --batch <command file> [--container <kind>] [--out <results file>] [--perf] [--trace <trace file>] [--jobs <n>]
+ * The container kind is any name accepted by createContainer (e.g. heap, splay, sharded-heap). Defaults to heap.
+ * Results go to the results file, or to standard output if none is given. Everything else the program
+ * prints (such as database progress) goes to standard error so it never mixes with the results.
+ * --perf also counts hardware events around every operation, for the 'counters' command.
+ * --trace writes a timeline of the run in the Chrome trace event format (see Tracer.h).
+ * --jobs answers runs of consecutive search and range commands on n threads, for thread safe containers.
+ * @return 0 if the command file was run, 1 if the arguments were invalid.
  */
-void readSqliteDb(const char* dbFilepath, unordered_map<string, int>& resultsMap) {
-    sqlite3* connection;
-    int retCode = sqlite3_open(dbFilepath, &connection);
-    if (retCode != 0) {
-        cout << "Error reading database. Canceling DB operation." << endl;
+int runBatchMode(int argc, char* argv[]) {
+    string commandFilepath;
+    string containerKind = "heap";
+    string outputFilepath;
+    string traceFilepath;
+    bool countEvents = false;
+    int jobs = 1;
+
+    // Parse the command line arguments:
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--batch" && i + 1 < argc) {
+            commandFilepath = argv[++i];
+        }
+        else if (arg == "--container" && i + 1 < argc) {
+            containerKind = argv[++i];
+        }
+        else if (arg == "--out" && i + 1 < argc) {
+            outputFilepath = argv[++i];
+        }
+        else if (arg == "--perf") {
+            countEvents = true;
+        }
+        else if (arg == "--trace" && i + 1 < argc) {
+            traceFilepath = argv[++i];
+        }
+        else if (arg == "--jobs" && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            jobs = atoi(argv[++i]);
+        }
+        else {
+            cerr << "Unrecognised argument: " << arg << endl;
+            commandFilepath.clear();
+            break;
+        }
     }
-    else {
-        sqlite3_stmt* selectStmt; // Stores a prepared statement. Will be populatef by sqlite3_prepare_v2
 
-        // Library documentation specifies to use v2 method because the original method is a deprecated legacy function:
-        const char* selectQuery = "SELECT track_id, word, count FROM lyrics WHERE word='i' OR word='me' OR word='my'";
-        sqlite3_prepare_v2(connection, selectQuery, -1, &selectStmt, nullptr);
+    SongContainer* container = createContainer(containerKind);
+    if (commandFilepath.empty() || container == nullptr) {
+        cerr << "Usage: " << argv[0] << " --batch <command file> [--container heap|splay|sharded-heap|sharded-splay|concurrent-splay|multiqueue|skiplist|persistent-treap] [--out <results file>] [--perf]"
+             << " [--trace <trace file>] [--jobs <n>]" << endl;
+        delete container;
+        return 1;
+    }
 
-        int counter = 0;
-        cout << endl;
+    // Send everything printed to cout to standard error, keeping the real standard output for the results:
+    streambuf* stdoutBuffer = cout.rdbuf(cerr.rdbuf());
+    ostream stdoutStream(stdoutBuffer);
+    ofstream outputFile;
+    if (!outputFilepath.empty()) {
+        outputFile.open(outputFilepath);
+    }
+    ostream& output = outputFilepath.empty() ? stdoutStream : outputFile;
 
-        chrono::high_resolution_clock::time_point startTime = chrono::high_resolution_clock::now(); // Start timing
+    if (!traceFilepath.empty()) {
+        if (!startTracing(traceFilepath)) {
+            cerr << "Could not create trace file " << traceFilepath << ". Continuing without a trace." << endl;
+        }
+        traceThreadName("main");
+    }
 
-        // Loop through every row that resulted from the SELECT SQL statement to create the Songs.
-        while(sqlite3_step(selectStmt) != SQLITE_DONE) { // While there are still rows in the result set:
-            cout << "\rreading database result row: " << counter;
-            counter++;
-            const char* name = reinterpret_cast<const char*>(sqlite3_column_text(selectStmt, 0));
-            string nameStr = name;
-            int score = sqlite3_column_int(selectStmt, 2);
-            auto resultsMapIter = resultsMap.find(name);
+    BatchRunner runner(container, output);
+    if (countEvents && !runner.enableCounters()) {
+        cerr << "Hardware counters are not available (" << runner.getCounterError() << "). Only times will be reported." << endl;
+    }
+    if (!runner.setJobs(jobs)) {
+        cerr << containerKind << " is not thread safe, so its commands run one at a time." << endl;
+    }
+    bool success = runner.run(commandFilepath);
+    output.flush();
+    cout.rdbuf(stdoutBuffer);
 
-            if(resultsMapIter == resultsMap.end()) { // insert into map if song has not yet been encountered:
-                resultsMap[nameStr] = score;
-            }
-            else { // If song already in the mapping, then update it with a higher score:
-                resultsMap.at(nameStr) = resultsMap.at(nameStr) + score;
+    if (!success) {
+        cerr << "Could not read command file " << commandFilepath << endl;
+    }
+    if (isTracing() && !stopTracing()) {
+        cerr << "Could not write trace file " << traceFilepath << endl;
+    }
+    delete container;
+    return success ? 0 : 1;
+}
+
+
+// The server being run by runServerMode, for the signal handler to stop:
+static QueryServer* runningServer = nullptr;
+
+/**
+ * Keeps a container loaded and answers requests for it over a Unix domain socket until interrupted. Usage:
+ *   lyricpsy --serve <socket path> --load <db file>... [--merge sum|max|last] [--container <kind>] [--trace <trace file>]
+ *            [--wal <log file>] [--wal-sync none|data|full]
+ * Several --load files are merged like the batch 'load' command. --wal logs every insert and remove to a write-ahead
+ * log (see WriteAheadLog.h). If the log already has records, it decides which files are loaded and its changes are
+ * made again after loading, so --load is only needed the first time. The server listens straight away and loads the files
+ * in the background; requests sent before the load finishes get an error response. Any container kind works: requests
+ * are answered one at a time, on the server's thread. Use lyricpsy_client (make client) to send requests. Ctrl+C or
+ * SIGTERM stops the server, which then prints how many requests it answered and their latencies.
+ * @return 0 if the server ran and stopped cleanly, 1 otherwise.
+ */
+int runServerMode(int argc, char* argv[]) {
+    string socketPath;
+    string containerKind = "heap";
+    string traceFilepath;
+    string walFilepath;
+    vector<string> dbFilepaths;
+    MergePolicy policy = MergePolicy::SUM;
+    WalSyncMode syncMode = WalSyncMode::DATA;
+    bool validArguments = true;
+
+    // Parse the command line arguments:
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--serve" && i + 1 < argc) {
+            socketPath = argv[++i];
+        }
+        else if (arg == "--load" && i + 1 < argc) {
+            dbFilepaths.push_back(argv[++i]);
+        }
+        else if (arg == "--merge" && i + 1 < argc && parseMergePolicy(argv[i + 1], policy)) {
+            i++;
+        }
+        else if (arg == "--container" && i + 1 < argc) {
+            containerKind = argv[++i];
+        }
+        else if (arg == "--trace" && i + 1 < argc) {
+            traceFilepath = argv[++i];
+        }
+        else if (arg == "--wal" && i + 1 < argc) {
+            walFilepath = argv[++i];
+        }
+        else if (arg == "--wal-sync" && i + 1 < argc && parseWalSyncMode(argv[i + 1], syncMode)) {
+            i++;
+        }
+        else {
+            cerr << "Unrecognised argument: " << arg << endl;
+            validArguments = false;
+            break;
+        }
+    }
+
+    SongContainer* container = createContainer(containerKind);
+    if (!validArguments || socketPath.empty() || (dbFilepaths.empty() && walFilepath.empty()) || container == nullptr) {
+        cerr << "Usage: " << argv[0] << " --serve <socket path> --load <db file>... [--merge sum|max|last]"
+             << " [--container heap|splay|sharded-heap|sharded-splay|concurrent-splay|multiqueue|skiplist|persistent-treap] [--trace <trace file>]"
+             << " [--wal <log file>] [--wal-sync none|data|full]" << endl;
+        delete container;
+        return 1;
+    }
+
+    // A log with records already says what to load. Otherwise it is started with the --load files as its base:
+    WriteAheadLog changeLog;
+    LogContents logContents;
+    if (!walFilepath.empty()) {
+        if (!readLog(walFilepath, logContents)) {
+            cerr << "Could not read the log " << walFilepath << endl;
+            delete container;
+            return 1;
+        }
+        if (logContents.hasBase || !logContents.changes.empty()) {
+            if (!dbFilepaths.empty()) {
+                cout << "Loading the files named in the log " << walFilepath << " instead of the --load files." << endl;
             }
+            dbFilepaths = logContents.baseFilepaths;
+            policy = logContents.basePolicy;
+        }
+        else if (dbFilepaths.empty()) {
+            cerr << "The log " << walFilepath << " is new, so --load is needed to say what it starts from." << endl;
+            delete container;
+            return 1;
+        }
+        if (!changeLog.open(walFilepath, syncMode)) {
+            cerr << "Could not open the log: " << changeLog.getError() << endl;
+            delete container;
+            return 1;
         }
+    }
 
-        chrono::high_resolution_clock::time_point endTime = chrono::high_resolution_clock::now(); // Stop timing
+    if (!traceFilepath.empty()) {
+        if (!startTracing(traceFilepath)) {
+            cerr << "Could not create trace file " << traceFilepath << ". Continuing without a trace." << endl;
+        }
+        traceThreadName("main");
+    }
 
-        // Print the time taken for the data import step to complete:
-        auto timeTaken = std::chrono::duration_cast<std::chrono::seconds>(endTime - startTime);
-        cout << endl << "Database import into program took " << timeTaken.count() << " seconds." << endl << endl << endl;
+    // The songs are loaded while the server already listens. Requests sent meanwhile are told it is still loading.
+    // The server is destroyed before the container, since a build it started may still be running:
+    bool success = false;
+    {
+        QueryServer server(container, socketPath);
+        if (!server.start()) {
+            cerr << "Could not start the server: " << server.getError() << endl;
+            delete container;
+            return 1;
+        }
+        if (changeLog.isOpen()) {
+            server.useLog(&changeLog, logContents.changes);
+            logContents = LogContents(); // The server has its own copy of the changes.
+        }
+        server.loadInBackground(dbFilepaths, policy);
+        runningServer = &server;
+        signal(SIGINT, stopServer);
+        signal(SIGTERM, stopServer);
+        cout << "Serving requests on " << socketPath << " while the songs load. Press Ctrl+C to stop." << endl;
+
+        server.run();
+        signal(SIGINT, SIG_DFL);
+        signal(SIGTERM, SIG_DFL);
+        runningServer = nullptr;
+
+        success = server.getError().empty();
+        if (!success) {
+            cerr << "The server stopped: " << server.getError() << endl;
+        }
+        cout << "Answered " << server.getRequestsServed() << " requests from " << server.getClientsServed() << " clients." << endl;
+        server.getLatencies().print(cout);
+    }
+    changeLog.close();
+    if (!changeLog.getError().empty()) {
+        cerr << "The log may be missing changes: " << changeLog.getError() << endl;
+        success = false;
+    }
+    if (isTracing() && !stopTracing()) {
+        cerr << "Could not write trace file " << traceFilepath << endl;
+    }
+    delete container;
+    return success ? 0 : 1;
+}
 
-        // Close all database connections and statements to free up memory:
-        sqlite3_finalize(selectStmt);
-        sqlite3_close(connection);
+
+/**
+ * Signal handler for Ctrl+C and SIGTERM in server mode. QueryServer::stop() is safe to call from a signal handler.
+ */
+void stopServer(int) {
+    if (runningServer != nullptr) {
+        runningServer->stop();
+    }
+}
+
+
+/**
+ * Compacts the log once it has grown past its compaction size, so replaying it at the next start stays quick.
+ * @param changeLog The log of changes to the container. May be closed, in which case nothing happens.
+ * @param container The container whose changes the log holds.
+ */
+void compactIfNeeded(WriteAheadLog& changeLog, SongContainer* container) {
+    if (changeLog.needsCompaction() && !changeLog.compact(container)) {
+        cout << "Could not compact the log: " << changeLog.getError() << endl;
     }
 }
 
@@ -378,6 +825,13 @@ void printOperationsMenu() {
     cout << "7. Count songs in program" << endl;
     cout << "8. Print and remove top N results." << endl;
     cout << "9. Quit" << endl;
+    cout << "10. Print top N results straight from a SQLite file (does not load the data structure)" << endl;
+    cout << "11. Print latency statistics for this session" << endl;
+    cout << "12. Turn hardware performance counters on/off (Linux only)" << endl;
+#if defined(SPLAYTREE_STATS) || defined(MAXHEAP_STATS)
+    cout << "13. Print data structure statistics and reset the counters" << endl;
+#endif
+    cout << "14. Print memory used by the data structure" << endl;
     cout << endl;
     cout << "Please select an operation: ";
 }
\ No newline at end of file
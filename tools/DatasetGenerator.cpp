@@ -0,0 +1,446 @@
+//
+// Created by adria on 10/19/2026.
+//
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "ProgressReporter.h"
+#include "SongSnapshot.h"
+#include "TrackScoreMap.h"
+// Please note: the below import sqlite3.h is not my code. It is a header file required for using the sqlite3 dll. Source: https://www.sqlite.org/download.html (taken from the amalgamation file).
+#include "sqlite3.h"
+
+using namespace std;
+
+// The first person words that make up the narcissism score, in the order used by the parameter arrays below:
+static const char* FIRST_PERSON_WORDS[] = {"i", "me", "my"};
+static const int FIRST_PERSON_WORD_COUNT = 3;
+
+// Size of the filler vocabulary. Prime, so that every step size visits distinct words (see generateTrack):
+static const int FILLER_VOCABULARY_SIZE = 4999;
+static const char* COMMON_WORDS[] = {"the", "you", "to", "and", "a", "it", "not", "in", "is", "of", "your", "that", "do",
+                                     "on", "are", "we", "am", "will", "all", "for", "no", "be", "have", "love", "so",
+                                     "know", "this", "but", "with", "what", "just", "when", "like", "can", "now"};
+static const int COMMON_WORD_COUNT = sizeof(COMMON_WORDS) / sizeof(COMMON_WORDS[0]);
+
+static const char ID_CHARACTERS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+
+/**
+ * Shape of the generated word counts. The defaults approximate the musiXmatch train set: 'i' is in most songs and
+ * used often, 'me' and 'my' less so, and a few songs repeat them far more than the rest. When the real database is
+ * available, --fit replaces the presence rates, mean counts and test fraction with values measured from it.
+ */
+struct DatasetSpec {
+    long long trackCount; // Number of tracks to generate.
+    uint64_t seed; // Seed of the random number generator. The same seed always gives the same dataset.
+    double presence[FIRST_PERSON_WORD_COUNT]; // Fraction of tracks that use each first person word.
+    double meanCount[FIRST_PERSON_WORD_COUNT]; // Mean count of each word in the tracks that use it.
+    double intensitySpread; // Standard deviation of the per-track log-normal factor that scales all three counts.
+    double testFraction; // Fraction of tracks marked is_test = 1.
+    int fillerWords; // Rows per track for words other than the first person words (SQLite output only).
+    bool createIndexes; // Whether to index track_id and word like the real database (SQLite output only).
+
+    DatasetSpec() : trackCount(1000), seed(42), intensitySpread(0.8), testFraction(27143.0 / 237662.0), fillerWords(20),
+                    createIndexes(true) {
+        const double defaultPresence[] = {0.85, 0.62, 0.58};
+        const double defaultMeanCount[] = {13.0, 4.5, 3.8};
+        for (int i = 0; i < FIRST_PERSON_WORD_COUNT; i++) {
+            presence[i] = defaultPresence[i];
+            meanCount[i] = defaultMeanCount[i];
+        }
+    }
+};
+
+/**
+ * One generated track.
+ */
+struct GeneratedTrack {
+    char trackId[TrackScoreMap::KEY_LENGTH]; // Not null terminated.
+    long long mxmTid; // musiXmatch track ID. Increasing, with gaps, like the real dataset.
+    int isTest;
+    int counts[FIRST_PERSON_WORD_COUNT]; // Count of each first person word. 0 means the track has no row for it.
+    int fillerStart; // First filler word index.
+    int fillerStep; // Distance between consecutive filler word indices.
+};
+
+/**
+ * Small random number generator (SplitMix64) whose output only depends on the seed, unlike the standard library
+ * distributions, so a seed gives the same dataset on every compiler and platform.
+ */
+class DatasetRandom {
+private:
+    uint64_t state;
+
+public:
+    DatasetRandom(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, 1):
+    double uniform() {
+        return (next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // Standard normal, by the Box-Muller transform:
+    double normal() {
+        double u = 1.0 - uniform(); // In (0, 1], so the log is finite.
+        return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * uniform());
+    }
+};
+
+// Prototypes:
+// ===========
+bool parseArguments(int argc, char* argv[], DatasetSpec& spec, string& outputPath, bool& snapshotOutput, string& fitPath);
+bool fitToDatabase(const string& dbFilepath, DatasetSpec& spec);
+void makeTrackId(long long index, uint64_t seed, DatasetRandom& random, char* trackId);
+void generateTrack(long long index, const DatasetSpec& spec, DatasetRandom& random, long long& mxmTid, GeneratedTrack& track);
+string fillerWord(int index);
+bool writeSqliteDataset(const char* filepath, const DatasetSpec& spec);
+bool writeSnapshotDataset(const char* filepath, const DatasetSpec& spec);
+void printUsage(const char* programName);
+
+
+// Implementations:
+// ================
+
+/**
+ * Entry point for the dataset generator. Writes a synthetic musiXmatch-style dataset for benchmarking, either as a
+ * SQLite database with the lyrics table of the real dataset or as a snapshot file.
+ * @return 0 if the dataset was written, 1 otherwise.
+ */
+int main(int argc, char* argv[]) {
+    DatasetSpec spec;
+    string outputPath;
+    string fitPath;
+    bool snapshotOutput = false;
+    if (!parseArguments(argc, argv, spec, outputPath, snapshotOutput, fitPath)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (!fitPath.empty()) {
+        if (!fitToDatabase(fitPath, spec)) {
+            cerr << "Could not fit the word counts to " << fitPath << endl;
+            return 1;
+        }
+        for (int i = 0; i < FIRST_PERSON_WORD_COUNT; i++) {
+            cout << "Fitted '" << FIRST_PERSON_WORDS[i] << "': in " << spec.presence[i] * 100 << "% of tracks, mean count "
+                 << spec.meanCount[i] << endl;
+        }
+        cout << "Fitted test fraction: " << spec.testFraction << endl;
+    }
+
+    bool success = snapshotOutput ? writeSnapshotDataset(outputPath.c_str(), spec) : writeSqliteDataset(outputPath.c_str(), spec);
+    if (!success) {
+        cerr << "Could not write " << outputPath << endl;
+        return 1;
+    }
+    cout << "Wrote " << spec.trackCount << " tracks to " << outputPath << endl;
+    return 0;
+}
+
+
+/**
+ * Parses the command line arguments.
+ * @return true if the arguments were valid, false otherwise.
+ */
+bool parseArguments(int argc, char* argv[], DatasetSpec& spec, string& outputPath, bool& snapshotOutput, string& fitPath) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--no-index") {
+            spec.createIndexes = false;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        string value = argv[++i];
+
+        if (arg == "--tracks") {
+            spec.trackCount = stoll(value);
+        }
+        else if (arg == "--out") {
+            outputPath = value;
+        }
+        else if (arg == "--format" && (value == "sqlite" || value == "snapshot")) {
+            snapshotOutput = (value == "snapshot");
+        }
+        else if (arg == "--seed") {
+            spec.seed = stoull(value);
+        }
+        else if (arg == "--filler-words") {
+            spec.fillerWords = stoi(value);
+        }
+        else if (arg == "--fit") {
+            fitPath = value;
+        }
+        else {
+            return false;
+        }
+    }
+    return !outputPath.empty() && spec.trackCount > 0 && spec.fillerWords >= 0 && spec.fillerWords <= FILLER_VOCABULARY_SIZE;
+}
+
+
+/**
+ * Measures the presence rate and mean count of each first person word, and the test fraction, from a real database.
+ * @param dbFilepath The path to a musiXmatch SQLite database.
+ * @param spec Updated with the measured values.
+ * @return true if the database could be read, false otherwise.
+ */
+bool fitToDatabase(const string& dbFilepath, DatasetSpec& spec) {
+    sqlite3* connection;
+    if (sqlite3_open_v2(dbFilepath.c_str(), &connection, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+        sqlite3_close(connection);
+        return false;
+    }
+
+    sqlite3_stmt* statement;
+    const char* trackQuery = "SELECT COUNT(DISTINCT track_id), COUNT(DISTINCT CASE WHEN is_test = 1 THEN track_id END) FROM lyrics";
+    double trackCount = 0;
+    if (sqlite3_prepare_v2(connection, trackQuery, -1, &statement, nullptr) == SQLITE_OK && sqlite3_step(statement) == SQLITE_ROW) {
+        trackCount = sqlite3_column_double(statement, 0);
+        if (trackCount > 0) {
+            spec.testFraction = sqlite3_column_double(statement, 1) / trackCount;
+        }
+    }
+    sqlite3_finalize(statement);
+
+    const char* wordQuery = "SELECT word, COUNT(*), AVG(count) FROM lyrics WHERE word IN ('i', 'me', 'my') GROUP BY word";
+    if (trackCount > 0 && sqlite3_prepare_v2(connection, wordQuery, -1, &statement, nullptr) == SQLITE_OK) {
+        while (sqlite3_step(statement) == SQLITE_ROW) {
+            const char* word = reinterpret_cast<const char*>(sqlite3_column_text(statement, 0));
+            for (int i = 0; i < FIRST_PERSON_WORD_COUNT; i++) {
+                if (strcmp(word, FIRST_PERSON_WORDS[i]) == 0) {
+                    spec.presence[i] = sqlite3_column_double(statement, 1) / trackCount;
+                    spec.meanCount[i] = sqlite3_column_double(statement, 2);
+                }
+            }
+        }
+        sqlite3_finalize(statement);
+    }
+
+    sqlite3_close(connection);
+    return trackCount > 0;
+}
+
+
+/**
+ * Makes an 18 character track ID in the format of the Million Song Dataset, e.g. TRAAAAV128F421A322.
+ * The middle 13 characters encode a seeded permutation of the track index, so IDs never repeat within a dataset,
+ * and the last 3 are random.
+ * @param index The index of the track in the dataset.
+ * @param seed The dataset's seed.
+ * @param random The dataset's random number generator.
+ * @param trackId Populated with the 18 characters of the ID. Not null terminated.
+ */
+void makeTrackId(long long index, uint64_t seed, DatasetRandom& random, char* trackId) {
+    // Every step below is invertible, so distinct indices give distinct values:
+    uint64_t value = static_cast<uint64_t>(index) ^ seed;
+    value *= 0xD6E8FEB86659FD93ULL;
+    value ^= value >> 32;
+    value *= 0xD6E8FEB86659FD93ULL;
+    value ^= value >> 32;
+
+    // 36^13 is larger than 2^64, so 13 base 36 digits hold any value:
+    trackId[0] = 'T';
+    trackId[1] = 'R';
+    for (int i = 14; i >= 2; i--) {
+        trackId[i] = ID_CHARACTERS[value % 36];
+        value /= 36;
+    }
+    for (int i = 15; i < TrackScoreMap::KEY_LENGTH; i++) {
+        trackId[i] = ID_CHARACTERS[random.next() % 36];
+    }
+}
+
+
+/**
+ * Generates the next track. Draws the same random numbers whatever the output format, so a SQLite database and a
+ * snapshot generated with the same seed hold the same songs and scores.
+ * @param index The index of the track in the dataset.
+ * @param spec The dataset parameters.
+ * @param random The dataset's random number generator.
+ * @param mxmTid The musiXmatch ID of the previous track. Advanced to this track's ID.
+ * @param track Populated with the generated track.
+ */
+void generateTrack(long long index, const DatasetSpec& spec, DatasetRandom& random, long long& mxmTid, GeneratedTrack& track) {
+    makeTrackId(index, spec.seed, random, track.trackId);
+    mxmTid += 1 + static_cast<long long>(random.next() % 40);
+    track.mxmTid = mxmTid;
+    track.isTest = random.uniform() < spec.testFraction ? 1 : 0;
+
+    // A log-normal factor with mean 1 makes some tracks use all three words far more than others:
+    double intensity = exp(spec.intensitySpread * random.normal() - spec.intensitySpread * spec.intensitySpread / 2);
+
+    for (int i = 0; i < FIRST_PERSON_WORD_COUNT; i++) {
+        bool present = random.uniform() < spec.presence[i];
+        double u = 1.0 - random.uniform();
+
+        // 1 plus a geometric number of extra uses, so the mean over tracks that use the word is meanCount:
+        double extraMean = (spec.meanCount[i] - 1) * intensity;
+        int extra = extraMean > 0 ? static_cast<int>(floor(log(u) / log(extraMean / (1 + extraMean)))) : 0;
+        track.counts[i] = present ? 1 + extra : 0;
+    }
+
+    track.fillerStart = static_cast<int>(random.next() % FILLER_VOCABULARY_SIZE);
+    track.fillerStep = 1 + static_cast<int>(random.next() % (FILLER_VOCABULARY_SIZE - 1));
+}
+
+
+/**
+ * Gets a word of the filler vocabulary. Common words come first, the rest are numbered placeholders.
+ * @param index The index of the word, below FILLER_VOCABULARY_SIZE.
+ * @return The word.
+ */
+string fillerWord(int index) {
+    if (index < COMMON_WORD_COUNT) {
+        return COMMON_WORDS[index];
+    }
+    return "w" + to_string(index);
+}
+
+
+/**
+ * Writes the dataset as a SQLite database with the lyrics table of the real dataset. Indexes are created after the
+ * rows are inserted, which is much faster than keeping them up to date during the insert.
+ * @param filepath The path of the database. Must not already contain a lyrics table.
+ * @param spec The dataset parameters.
+ * @return true if the database was written, false otherwise.
+ */
+bool writeSqliteDataset(const char* filepath, const DatasetSpec& spec) {
+    sqlite3* connection;
+    if (sqlite3_open(filepath, &connection) != SQLITE_OK) {
+        sqlite3_close(connection);
+        return false;
+    }
+
+    // Nothing needs to survive a crash part way through, so skip the journal and syncing:
+    const char* setup = "PRAGMA journal_mode=OFF; PRAGMA synchronous=OFF; "
+                        "CREATE TABLE lyrics (track_id, mxm_tid INT, word TEXT, count INT, is_test INT); BEGIN;";
+    if (sqlite3_exec(connection, setup, nullptr, nullptr, nullptr) != SQLITE_OK) {
+        cerr << sqlite3_errmsg(connection) << endl;
+        sqlite3_close(connection);
+        return false;
+    }
+
+    sqlite3_stmt* insertStmt;
+    sqlite3_prepare_v2(connection, "INSERT INTO lyrics VALUES (?, ?, ?, ?, ?)", -1, &insertStmt, nullptr);
+
+    DatasetRandom random(spec.seed);
+    GeneratedTrack track;
+    long long mxmTid = 0;
+    ProgressReporter progress("generating tracks");
+    progress.addExpectedRows(spec.trackCount);
+    progress.start();
+
+    bool success = true;
+    for (long long t = 0; t < spec.trackCount && success; t++) {
+        generateTrack(t, spec, random, mxmTid, track);
+        progress.addRow();
+
+        // First person words first, then the filler words:
+        for (int w = 0; w < FIRST_PERSON_WORD_COUNT + spec.fillerWords && success; w++) {
+            string word;
+            int count;
+            if (w < FIRST_PERSON_WORD_COUNT) {
+                if (track.counts[w] == 0) {
+                    continue;
+                }
+                word = FIRST_PERSON_WORDS[w];
+                count = track.counts[w];
+            }
+            else {
+                long long step = static_cast<long long>(w - FIRST_PERSON_WORD_COUNT) * track.fillerStep;
+                word = fillerWord(static_cast<int>((track.fillerStart + step) % FILLER_VOCABULARY_SIZE));
+                count = 1 + static_cast<int>((track.mxmTid + w) % 5);
+            }
+
+            sqlite3_bind_text(insertStmt, 1, track.trackId, TrackScoreMap::KEY_LENGTH, SQLITE_STATIC);
+            sqlite3_bind_int64(insertStmt, 2, track.mxmTid);
+            sqlite3_bind_text(insertStmt, 3, word.c_str(), static_cast<int>(word.size()), SQLITE_TRANSIENT);
+            sqlite3_bind_int(insertStmt, 4, count);
+            sqlite3_bind_int(insertStmt, 5, track.isTest);
+            success = sqlite3_step(insertStmt) == SQLITE_DONE;
+            sqlite3_reset(insertStmt);
+        }
+    }
+
+    progress.stop();
+    sqlite3_finalize(insertStmt);
+
+    if (success) {
+        const char* finish = spec.createIndexes ? "COMMIT; CREATE INDEX idx_lyrics1 ON lyrics ('track_id'); "
+                                                  "CREATE INDEX idx_lyrics2 ON lyrics ('word');"
+                                                : "COMMIT;";
+        if (spec.createIndexes) {
+            cout << "Creating indexes..." << endl;
+        }
+        success = sqlite3_exec(connection, finish, nullptr, nullptr, nullptr) == SQLITE_OK;
+    }
+    if (!success) {
+        cerr << sqlite3_errmsg(connection) << endl;
+    }
+    sqlite3_close(connection);
+    return success;
+}
+
+
+/**
+ * Writes the dataset as a snapshot of aggregated scores. Tracks without any first person word are left out, just as
+ * they never reach the program when the SQLite version of the same dataset is loaded.
+ * @param filepath The path of the snapshot. Overwritten if it exists.
+ * @param spec The dataset parameters.
+ * @return true if the snapshot was written, false otherwise.
+ */
+bool writeSnapshotDataset(const char* filepath, const DatasetSpec& spec) {
+    SnapshotWriter writer;
+    if (!writer.open(filepath)) {
+        return false;
+    }
+
+    DatasetRandom random(spec.seed);
+    GeneratedTrack track;
+    long long mxmTid = 0;
+    ProgressReporter progress("generating tracks");
+    progress.addExpectedRows(spec.trackCount);
+    progress.start();
+
+    bool success = true;
+    for (long long t = 0; t < spec.trackCount && success; t++) {
+        generateTrack(t, spec, random, mxmTid, track);
+        progress.addRow();
+
+        int score = track.counts[0] + track.counts[1] + track.counts[2];
+        if (score > 0) {
+            success = writer.write(track.trackId, TrackScoreMap::KEY_LENGTH, score);
+        }
+    }
+
+    progress.stop();
+    return writer.close() && success;
+}
+
+
+/**
+ * Prints the command line usage of the dataset generator.
+ */
+void printUsage(const char* programName) {
+    cerr << "Usage: " << programName << " --out <file> [options]" << endl;
+    cerr << "  --out FILE                  File to write. A SQLite output file must not already have a lyrics table" << endl;
+    cerr << "  --format sqlite|snapshot    Output format (default: sqlite)" << endl;
+    cerr << "  --tracks N                  Number of tracks to generate (default: 1000)" << endl;
+    cerr << "  --seed N                    Random seed (default: 42)" << endl;
+    cerr << "  --fit DB                    Fit the word count distribution to a real musiXmatch database" << endl;
+    cerr << "  --filler-words N            Rows per track for other words, SQLite only (default: 20)" << endl;
+    cerr << "  --no-index                  Do not index track_id and word, SQLite only" << endl;
+}